@@ -88,18 +88,12 @@ void set_compaction_manager(http_context& ctx, routes& r) {
         return get_cm_stats(ctx, &compaction_manager::stats::completed_tasks);
     });
 
-    cm::get_total_compactions_completed.set(r, [] (std::unique_ptr<request> req) {
-        // FIXME
-        // We are currently dont have an API for compaction
-        // so returning a 0 as the number of total compaction is ok
-        return make_ready_future<json::json_return_type>(0);
+    cm::get_total_compactions_completed.set(r, [&ctx] (std::unique_ptr<request> req) {
+        return get_cf_stats(ctx, &column_family::stats::compactions_completed);
     });
 
-    cm::get_bytes_compacted.set(r, [] (std::unique_ptr<request> req) {
-        //TBD
-        // FIXME
-        warn(unimplemented::cause::API);
-        return make_ready_future<json::json_return_type>(0);
+    cm::get_bytes_compacted.set(r, [&ctx] (std::unique_ptr<request> req) {
+        return get_cf_stats(ctx, &column_family::stats::compaction_bytes_read);
     });
 
     cm::get_compaction_history.set(r, [] (std::unique_ptr<request> req) {
@@ -115,6 +109,15 @@ void set_compaction_manager(http_context& ctx, routes& r) {
                 h.compacted_at = entry.compacted_at;
                 h.bytes_in = entry.bytes_in;
                 h.bytes_out =  entry.bytes_out;
+                h.partitions_in = entry.partitions_in;
+                h.partitions_out = entry.partitions_out;
+                h.purged_tombstones = entry.purged_tombstones;
+                if (entry.started_at) {
+                    auto duration = entry.compacted_at - entry.started_at;
+                    h.started_at = entry.started_at;
+                    h.duration = duration;
+                    h.throughput = duration ? (double(entry.bytes_out) / (1024 * 1024)) / (double(duration) / 1000) : 0;
+                }
                 for (auto it : entry.rows_merged) {
                     httpd::compaction_manager_json::row_merged e;
                     e.key = it.first;
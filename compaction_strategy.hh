@@ -62,6 +62,11 @@ class compaction_strategy {
 
     std::vector<resharding_descriptor> get_resharding_jobs(column_family& cf, std::vector<shared_sstable> candidates);
 
+    // Return compactions which reshape sstables, written by streaming, repair or refresh,
+    // according to the strategy before they join the other sstables of the column family.
+    // Empty if they're in shape already.
+    std::vector<compaction_descriptor> get_reshaping_jobs(column_family& cf, std::vector<shared_sstable> input);
+
     // Some strategies may look at the compacted and resulting sstables to
     // get some useful information for subsequent compactions.
     void notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added);
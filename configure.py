@@ -291,7 +291,9 @@ scylla_tests = [
     'tests/cql_auth_query_test',
     'tests/enum_set_test',
     'tests/extensions_test',
+    'tests/frequency_sketch_test',
     'tests/cql_auth_syntax_test',
+    'tests/service_level_test',
 ]
 
 perf_tests = [
@@ -398,6 +400,7 @@ scylla_core = (['database.cc',
                  'sstables/compaction.cc',
                  'sstables/compaction_strategy.cc',
                  'sstables/compaction_manager.cc',
+                 'sstables/index_summary_manager.cc',
                  'sstables/integrity_checked_file_impl.cc',
                  'sstables/prepended_input_stream.cc',
                  'transport/event.cc',
@@ -535,6 +538,7 @@ scylla_core = (['database.cc',
                  'dht/range_streamer.cc',
                  'unimplemented.cc',
                  'query.cc',
+                 'row_filter.cc',
                  'query-result-set.cc',
                  'locator/abstract_replication_strategy.cc',
                  'locator/simple_strategy.cc',
@@ -556,6 +560,7 @@ scylla_core = (['database.cc',
                  'service/migration_task.cc',
                  'service/storage_service.cc',
                  'service/misc_services.cc',
+                 'service/service_level.cc',
                  'service/pager/paging_state.cc',
                  'service/pager/query_pagers.cc',
                  'streaming/stream_task.cc',
@@ -708,6 +713,8 @@ pure_boost_tests = set([
     'tests/auth_resource_test',
     'tests/enum_set_test',
     'tests/cql_auth_syntax_test',
+    'tests/frequency_sketch_test',
+    'tests/service_level_test',
 ])
 
 tests_not_using_seastar_test_framework = set([
@@ -757,6 +764,7 @@ deps['tests/murmur_hash_test'] = ['bytes.cc', 'utils/murmur_hash.cc', 'tests/mur
 deps['tests/allocation_strategy_test'] = ['tests/allocation_strategy_test.cc', 'utils/logalloc.cc', 'utils/dynamic_bitset.cc']
 deps['tests/log_heap_test'] = ['tests/log_heap_test.cc']
 deps['tests/anchorless_list_test'] = ['tests/anchorless_list_test.cc']
+deps['tests/frequency_sketch_test'] = ['tests/frequency_sketch_test.cc']
 
 warnings = [
     '-Wno-mismatched-tags',  # clang-only
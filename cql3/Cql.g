@@ -384,6 +384,7 @@ selectStatement returns [shared_ptr<raw::select_statement> expr]
         ::shared_ptr<cql3::term::raw> limit;
         raw::select_statement::parameters::orderings_type orderings;
         bool allow_filtering = false;
+        bool bypass_cache = false;
     }
     : K_SELECT ( ( K_DISTINCT { is_distinct = true; } )?
                  sclause=selectClause
@@ -393,8 +394,9 @@ selectStatement returns [shared_ptr<raw::select_statement> expr]
       ( K_ORDER K_BY orderByClause[orderings] ( ',' orderByClause[orderings] )* )?
       ( K_LIMIT rows=intValue { limit = rows; } )?
       ( K_ALLOW K_FILTERING  { allow_filtering = true; } )?
+      ( K_BYPASS K_CACHE { bypass_cache = true; })?
       {
-          auto params = ::make_shared<raw::select_statement::parameters>(std::move(orderings), is_distinct, allow_filtering);
+          auto params = ::make_shared<raw::select_statement::parameters>(std::move(orderings), is_distinct, allow_filtering, bypass_cache);
           $expr = ::make_shared<raw::select_statement>(std::move(cf), std::move(params),
             std::move(sclause), std::move(wclause), std::move(limit));
       }
@@ -1618,6 +1620,8 @@ basic_unreserved_keyword returns [sstring str]
         | K_MAP
         | K_LIST
         | K_FILTERING
+        | K_BYPASS
+        | K_CACHE
         | K_PERMISSION
         | K_PERMISSIONS
         | K_KEYSPACES
@@ -1710,6 +1714,8 @@ K_ASC:         A S C;
 K_DESC:        D E S C;
 K_ALLOW:       A L L O W;
 K_FILTERING:   F I L T E R I N G;
+K_BYPASS:      B Y P A S S;
+K_CACHE:       C A C H E;
 K_IF:          I F;
 K_IS:          I S;
 K_CONTAINS:    C O N T A I N S;
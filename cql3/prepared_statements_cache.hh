@@ -70,8 +70,12 @@ class prepared_cache_key_type {
     }
 };
 
-class prepared_statements_cache {
-public:
+/// \brief Statistics of a cache of prepared statements
+///
+/// loading_cache reports its events to a type rather than to an instance, so every
+/// cache of prepared statements gets an updater of its own, distinguished by Tag.
+template <typename Tag>
+struct prepared_cache_stats_updater {
     struct stats {
         uint64_t prepared_cache_evictions = 0;
     };
@@ -81,18 +85,26 @@ class prepared_statements_cache {
         return _stats;
     }
 
-    struct prepared_cache_stats_updater {
-        static void inc_hits() noexcept {}
-        static void inc_misses() noexcept {}
-        static void inc_blocks() noexcept {}
-        static void inc_evictions() noexcept {
-            ++shard_stats().prepared_cache_evictions;
-        }
-    };
+    static void inc_hits() noexcept {}
+    static void inc_misses() noexcept {}
+    static void inc_blocks() noexcept {}
+    static void inc_evictions() noexcept {
+        ++shard_stats().prepared_cache_evictions;
+    }
+};
+
+template <typename StatsUpdater>
+class basic_prepared_statements_cache {
+public:
+    using stats = typename StatsUpdater::stats;
+
+    static stats& shard_stats() {
+        return StatsUpdater::shard_stats();
+    }
 
 private:
     using cache_key_type = typename prepared_cache_key_type::cache_key_type;
-    using cache_type = utils::loading_cache<cache_key_type, prepared_cache_entry, utils::loading_cache_reload_enabled::no, prepared_cache_entry_size, utils::tuple_hash, std::equal_to<cache_key_type>, prepared_cache_stats_updater>;
+    using cache_type = utils::loading_cache<cache_key_type, prepared_cache_entry, utils::loading_cache_reload_enabled::no, prepared_cache_entry_size, utils::tuple_hash, std::equal_to<cache_key_type>, StatsUpdater>;
     using cache_value_ptr = typename cache_type::value_ptr;
     using cache_iterator = typename cache_type::iterator;
     using checked_weak_ptr = typename statements::prepared_statement::checked_weak_ptr;
@@ -102,7 +114,7 @@ class prepared_statements_cache {
         }
     };
 
-    static const std::chrono::minutes entry_expiry;
+    static constexpr std::chrono::minutes entry_expiry = std::chrono::minutes(60);
 
 public:
     using key_type = prepared_cache_key_type;
@@ -116,8 +128,8 @@ class prepared_statements_cache {
     value_extractor_fn _value_extractor_fn;
 
 public:
-    prepared_statements_cache(logging::logger& logger)
-        : _cache(memory::stats().total_memory() / 256, entry_expiry, logger)
+    basic_prepared_statements_cache(logging::logger& logger, size_t max_size = memory::stats().total_memory() / 256)
+        : _cache(max_size, entry_expiry, logger)
     {}
 
     template <typename LoadFunc>
@@ -156,6 +168,14 @@ class prepared_statements_cache {
         return _cache.memory_footprint();
     }
 };
+
+template <typename StatsUpdater>
+constexpr std::chrono::minutes basic_prepared_statements_cache<StatsUpdater>::entry_expiry;
+
+using prepared_statements_cache = basic_prepared_statements_cache<prepared_cache_stats_updater<struct prepared_statements_cache_tag>>;
+
+/// \brief Cache of statements sent unprepared, see query_processor::process()
+using unprepared_statements_cache = basic_prepared_statements_cache<prepared_cache_stats_updater<struct unprepared_statements_cache_tag>>;
 }
 
 namespace std { // for prepared_statements_cache log printouts
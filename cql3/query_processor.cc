@@ -58,12 +58,12 @@ using namespace cql_transport::messages;
 
 logging::logger log("query_processor");
 logging::logger prep_cache_log("prepared_statements_cache");
+logging::logger unprep_cache_log("unprepared_statements_cache");
 
 distributed<query_processor> _the_query_processor;
 
 const sstring query_processor::CQL_VERSION = "3.3.1";
 
-const std::chrono::minutes prepared_statements_cache::entry_expiry = std::chrono::minutes(60);
 
 class query_processor::internal_state {
     service::query_state _qs;
@@ -96,7 +96,8 @@ query_processor::query_processor(distributed<service::storage_proxy>& proxy, dis
         , _proxy(proxy)
         , _db(db)
         , _internal_state(new internal_state())
-        , _prepared_cache(prep_cache_log) {
+        , _prepared_cache(prep_cache_log)
+        , _unprepared_cache(unprep_cache_log, memory::stats().total_memory() / 1024) {
     namespace sm = seastar::metrics;
 
     _metrics.add_group(
@@ -105,7 +106,12 @@ query_processor::query_processor(distributed<service::storage_proxy>& proxy, dis
                     sm::make_derive(
                             "statements_prepared",
                             _stats.prepare_invocations,
-                            sm::description("Counts a total number of parsed CQL requests."))});
+                            sm::description("Counts a total number of parsed CQL requests.")),
+
+                    sm::make_derive(
+                            "unprepared_cache_hits",
+                            _stats.unprepared_cache_hits,
+                            sm::description("Counts a number of unprepared CQL requests served without parsing the statement."))});
 
     _metrics.add_group(
             "cql",
@@ -172,7 +178,22 @@ query_processor::query_processor(distributed<service::storage_proxy>& proxy, dis
                     sm::make_gauge(
                             "prepared_cache_memory_footprint",
                             [this] { return _prepared_cache.memory_footprint(); },
-                            sm::description("Size (in bytes) of the prepared statements cache."))});
+                            sm::description("Size (in bytes) of the prepared statements cache.")),
+
+                    sm::make_derive(
+                            "unprepared_cache_evictions",
+                            [] { return unprepared_statements_cache::shard_stats().prepared_cache_evictions; },
+                            sm::description("Counts a number of evictions from the cache of parsed unprepared statements.")),
+
+                    sm::make_gauge(
+                            "unprepared_cache_size",
+                            [this] { return _unprepared_cache.size(); },
+                            sm::description("A number of entries in the cache of parsed unprepared statements.")),
+
+                    sm::make_gauge(
+                            "unprepared_cache_memory_footprint",
+                            [this] { return _unprepared_cache.memory_footprint(); },
+                            sm::description("Size (in bytes) of the cache of parsed unprepared statements."))});
 
     service::get_local_migration_manager().register_listener(_migration_subscriber.get());
 }
@@ -188,8 +209,42 @@ future<> query_processor::stop() {
 future<::shared_ptr<result_message>>
 query_processor::process(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("process: \"{}\"", query_string);
+    auto& client_state = query_state.get_client_state();
+    auto key = compute_id(query_string, client_state.get_raw_keyspace());
+    auto it = _unprepared_cache.find(key);
+    if (it != _unprepared_cache.end()) {
+        tracing::trace(query_state.get_trace_state(), "Found the statement in the cache");
+        ++_stats.unprepared_cache_hits;
+        return process_parsed(*it, query_state, options);
+    }
+
     tracing::trace(query_state.get_trace_state(), "Parsing a statement");
-    auto p = get_statement(query_string, query_state.get_client_state());
+    auto p = get_statement(query_string, client_state);
+    if (p->statement->get_bound_terms()) {
+        // The bound values come with each request, so keep the cache for statements
+        // whose text identifies them completely.
+        return do_with(std::move(p), [this, &query_state, &options] (auto& p) {
+            return this->process_parsed(p->checked_weak_from_this(), query_state, options);
+        });
+    }
+    p->raw_cql_statement = query_string.to_string();
+    return _unprepared_cache.get(key, [p = std::move(p)] () mutable {
+        return make_ready_future<std::unique_ptr<statements::prepared_statement>>(std::move(p));
+    }).then([this, &query_state, &options] (statements::prepared_statement::checked_weak_ptr p) {
+        return process_parsed(std::move(p), query_state, options);
+    }).handle_exception_type([this, query_string = query_string.to_string(), &query_state, &options]
+            (unprepared_statements_cache::statement_is_too_big&) {
+        return do_with(get_statement(query_string, query_state.get_client_state()), [this, &query_state, &options] (auto& p) {
+            return this->process_parsed(p->checked_weak_from_this(), query_state, options);
+        });
+    });
+}
+
+future<::shared_ptr<result_message>>
+query_processor::process_parsed(
+        statements::prepared_statement::checked_weak_ptr p,
+        service::query_state& query_state,
+        query_options& options) {
     options.prepare(p->bound_names);
     auto cql_statement = p->statement;
     if (cql_statement->get_bound_terms() != options.get_values_count()) {
@@ -612,9 +667,11 @@ void query_processor::migration_subscriber::on_drop_view(const sstring& ks_name,
 void query_processor::migration_subscriber::remove_invalid_prepared_statements(
         sstring ks_name,
         std::experimental::optional<sstring> cf_name) {
-    _qp->_prepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
+    auto should_invalidate = [&] (::shared_ptr<cql_statement> stmt) {
         return this->should_invalidate(ks_name, cf_name, stmt);
-    });
+    };
+    _qp->_prepared_cache.remove_if(should_invalidate);
+    _qp->_unprepared_cache.remove_if(should_invalidate);
 }
 
 bool query_processor::migration_subscriber::should_invalidate(
@@ -162,7 +162,8 @@ statement_restrictions::statement_restrictions(database& db,
         ::shared_ptr<variable_specifications> bound_names,
         bool selects_only_static_columns,
         bool select_a_collection,
-        bool for_view)
+        bool for_view,
+        bool allow_filtering)
     : statement_restrictions(schema)
 {
     /*
@@ -265,10 +266,16 @@ statement_restrictions::statement_restrictions(database& db,
 #endif
     }
     // Even if uses_secondary_indexing is false at this point, we'll still have to use one if
-    // there is restrictions not covered by the PK.
+    // there is restrictions not covered by the PK, unless the replicas can filter the rows
+    // of the queried partition themselves.
     if (!_nonprimary_key_restrictions->empty()) {
-        _uses_secondary_indexing = true;
-        _index_restrictions.push_back(_nonprimary_key_restrictions);
+        if (allow_filtering && !for_view && !has_queriable_index && !_uses_secondary_indexing
+                && !selects_only_static_columns && can_filter_on_replicas()) {
+            _uses_replica_filtering = true;
+        } else {
+            _uses_secondary_indexing = true;
+            _index_restrictions.push_back(_nonprimary_key_restrictions);
+        }
     }
 
     if (_uses_secondary_indexing && !for_view) {
@@ -388,6 +395,47 @@ std::vector<query::clustering_range> statement_restrictions::get_clustering_boun
     return _clustering_columns_restrictions->bounds_ranges(options);
 }
 
+bool statement_restrictions::can_filter_on_replicas() const {
+    if (_is_key_range || key_is_in_relation() || _clustering_columns_restrictions->is_contains()) {
+        return false;
+    }
+    auto& restrictions = _nonprimary_key_restrictions->restrictions();
+    return std::all_of(restrictions.begin(), restrictions.end(), [] (auto&& e) {
+        auto& r = e.second;
+        auto& def = r->get_column_def();
+        return (r->is_EQ() || r->is_slice()) && def.is_regular() && !def.is_multi_cell() && !def.is_counter();
+    });
+}
+
+std::vector<query::column_filter> statement_restrictions::get_column_filters(const query_options& options) const {
+    if (!_uses_replica_filtering) {
+        return {};
+    }
+    std::vector<query::column_filter> filters;
+    auto add_filter = [&] (const column_definition& def, query::filter_operator op, const bytes_opt& value) {
+        if (!value) {
+            throw exceptions::invalid_request_exception(sprint("Invalid null value for column %s", def.name_as_text()));
+        }
+        filters.push_back(query::column_filter{def.id, op, *value});
+    };
+    for (auto&& r : _nonprimary_key_restrictions->restrictions() | boost::adaptors::map_values) {
+        auto& def = r->get_column_def();
+        if (r->is_EQ()) {
+            add_filter(def, query::filter_operator::eq, r->value(options));
+            continue;
+        }
+        if (r->has_bound(statements::bound::START)) {
+            auto op = r->is_inclusive(statements::bound::START) ? query::filter_operator::gte : query::filter_operator::gt;
+            add_filter(def, op, r->bounds(statements::bound::START, options)[0]);
+        }
+        if (r->has_bound(statements::bound::END)) {
+            auto op = r->is_inclusive(statements::bound::END) ? query::filter_operator::lte : query::filter_operator::lt;
+            add_filter(def, op, r->bounds(statements::bound::END, options)[0]);
+        }
+    }
+    return filters;
+}
+
 bool statement_restrictions::need_filtering() {
     uint32_t number_of_restricted_columns = 0;
     for (auto&& restrictions : _index_restrictions) {
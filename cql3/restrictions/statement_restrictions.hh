@@ -96,6 +96,12 @@ class statement_restrictions {
      */
     bool _uses_secondary_indexing = false;
 
+    /**
+     * <code>true</code> if the non-primary key restrictions are checked by the replicas
+     * while reading the queried partition, <code>false</code> otherwise
+     */
+    bool _uses_replica_filtering = false;
+
     /**
      * Specify if the query will return a range of partition keys.
      */
@@ -117,7 +123,8 @@ class statement_restrictions {
         ::shared_ptr<variable_specifications> bound_names,
         bool selects_only_static_columns,
         bool select_a_collection,
-        bool for_view = false);
+        bool for_view = false,
+        bool allow_filtering = false);
 private:
     void add_restriction(::shared_ptr<restriction> restriction);
     void add_single_column_restriction(::shared_ptr<single_column_restriction> restriction);
@@ -154,6 +161,24 @@ class statement_restrictions {
         return _uses_secondary_indexing;
     }
 
+    /**
+     * Checks if the replicas filter the rows on the non-primary key restrictions.
+     *
+     * @return <code>true</code> if the replicas filter the rows, <code>false</code> otherwise.
+     */
+    bool uses_replica_filtering() const {
+        return _uses_replica_filtering;
+    }
+
+    /**
+     * Returns the column filters the replicas apply to the rows of the queried partition.
+     *
+     * @param options the query options
+     * @return the column filters, empty unless <code>uses_replica_filtering()</code>
+     * @throws InvalidRequestException if a restricted value is null
+     */
+    std::vector<query::column_filter> get_column_filters(const query_options& options) const;
+
     ::shared_ptr<primary_key_restrictions<partition_key>> get_partition_key_restrictions() const {
         return _partition_key_restrictions;
     }
@@ -191,6 +216,12 @@ class statement_restrictions {
      */
     void process_clustering_columns_restrictions(bool has_queriable_index, bool select_a_collection, bool for_view);
 
+    /**
+     * Checks if the replicas can filter the rows on the non-primary key restrictions: a single partition
+     * is queried and all the restrictions are EQ or slices on regular, non-collection, non-counter columns.
+     */
+    bool can_filter_on_replicas() const;
+
     /**
      * Returns the <code>Restrictions</code> for the specified type of columns.
      *
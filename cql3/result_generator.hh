@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <seastar/core/sharded.hh>
+
+#include "cql3/result_set.hh"
+#include "cql3/selection/selection.hh"
+#include "query-result-reader.hh"
+
+namespace cql3 {
+
+// Generates rows of a result set straight from query::result, without
+// materializing them as a cql3::result_set.
+//
+// Valid only for trivial selections, whose output rows consist of the
+// selected columns as they were read, in order.
+class result_generator {
+    schema_ptr _schema;
+    foreign_ptr<lw_shared_ptr<query::result>> _result;
+    lw_shared_ptr<const query::read_command> _command;
+    shared_ptr<const selection::selection> _selection;
+private:
+    template<typename Visitor>
+    class query_result_visitor {
+        const schema& _schema;
+        const selection::selection& _selection;
+        Visitor& _visitor;
+        std::vector<bytes> _partition_key;
+        std::vector<bytes> _clustering_key;
+        uint32_t _partition_row_count = 0;
+    private:
+        void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
+            if (def.type->is_multi_cell()) {
+                auto cell = i.next_collection_cell();
+                if (!cell) {
+                    _visitor.accept_value({});
+                    return;
+                }
+                _visitor.accept_value(*cell);
+            } else {
+                auto cell = i.next_atomic_cell();
+                if (!cell) {
+                    _visitor.accept_value({});
+                    return;
+                }
+                _visitor.accept_value(cell->value());
+            }
+        }
+    public:
+        query_result_visitor(const schema& s, const selection::selection& sel, Visitor& visitor)
+            : _schema(s), _selection(sel), _visitor(visitor) { }
+
+        void accept_new_partition(const partition_key& key, uint32_t row_count) {
+            _partition_key = key.explode(_schema);
+            accept_new_partition(row_count);
+        }
+        void accept_new_partition(uint32_t row_count) {
+            _partition_row_count = row_count;
+        }
+
+        void accept_new_row(const clustering_key& key, const query::result_row_view& static_row, const query::result_row_view& row) {
+            _clustering_key = key.explode(_schema);
+            accept_new_row(static_row, row);
+        }
+        void accept_new_row(const query::result_row_view& static_row, const query::result_row_view& row) {
+            auto static_row_iterator = static_row.iterator();
+            auto row_iterator = row.iterator();
+            _visitor.start_row();
+            for (auto&& def : _selection.get_columns()) {
+                switch (def->kind) {
+                case column_kind::partition_key:
+                    _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                    break;
+                case column_kind::clustering_key:
+                    if (_clustering_key.size() > def->component_index()) {
+                        _visitor.accept_value(bytes_view(_clustering_key[def->component_index()]));
+                    } else {
+                        _visitor.accept_value({});
+                    }
+                    break;
+                case column_kind::regular_column:
+                    accept_cell_value(*def, row_iterator);
+                    break;
+                case column_kind::static_column:
+                    accept_cell_value(*def, static_row_iterator);
+                    break;
+                default:
+                    assert(0);
+                }
+            }
+            _visitor.end_row();
+        }
+
+        void accept_partition_end(const query::result_row_view& static_row) {
+            if (_partition_row_count) {
+                return;
+            }
+            _visitor.start_row();
+            auto static_row_iterator = static_row.iterator();
+            for (auto&& def : _selection.get_columns()) {
+                if (def->is_partition_key()) {
+                    _visitor.accept_value(bytes_view(_partition_key[def->component_index()]));
+                } else if (def->is_static()) {
+                    accept_cell_value(*def, static_row_iterator);
+                } else {
+                    _visitor.accept_value({});
+                }
+            }
+            _visitor.end_row();
+        }
+    };
+public:
+    result_generator(schema_ptr s, foreign_ptr<lw_shared_ptr<query::result>> result,
+                     lw_shared_ptr<const query::read_command> cmd, shared_ptr<const selection::selection> sel)
+        : _schema(std::move(s))
+        , _result(std::move(result))
+        , _command(std::move(cmd))
+        , _selection(std::move(sel))
+    { }
+
+    // Visitor must provide:
+    //
+    //   void start_row();
+    //   void accept_value(bytes_view_opt);
+    //   void end_row();
+    template<typename Visitor>
+    void visit(Visitor&& visitor) const {
+        query::result_view::consume(*_result, _command->slice, query_result_visitor<Visitor>(*_schema, *_selection, visitor));
+    }
+
+    // Returns the number of rows which visit() will produce.
+    uint32_t row_count() const {
+        return query::result_view::do_with(*_result, [] (query::result_view v) {
+            return std::get<1>(v.count_partitions_and_rows());
+        });
+    }
+};
+
+// Result of a query, which is either a materialized result_set or a
+// result_generator which serializes rows directly from query::result.
+class result {
+    mutable std::unique_ptr<cql3::result_set> _result_set;
+    std::experimental::optional<result_generator> _result_generator;
+    shared_ptr<const cql3::metadata> _metadata;
+public:
+    explicit result(std::unique_ptr<cql3::result_set> rs)
+        : _result_set(std::move(rs))
+        , _metadata(_result_set->_metadata)
+    { }
+
+    result(result_generator generator, shared_ptr<const cql3::metadata> m)
+        : _result_generator(std::move(generator))
+        , _metadata(std::move(m))
+    { }
+
+    const cql3::metadata& get_metadata() const {
+        return *_metadata;
+    }
+
+    uint32_t size() const {
+        return _result_set ? _result_set->size() : _result_generator->row_count();
+    }
+
+    // Returns the materialized result_set, building it on first use if
+    // this result is generated.
+    const cql3::result_set& result_set() const;
+
+    // Passes values of the serialized columns of all rows to the visitor,
+    // see result_generator::visit() for the interface.
+    template<typename Visitor>
+    void visit(Visitor&& visitor) const {
+        if (_result_set) {
+            _result_set->visit(visitor);
+        } else {
+            _result_generator->visit(visitor);
+        }
+    }
+};
+
+}
@@ -40,12 +40,14 @@
  */
 
 #include "cql3/result_set.hh"
+#include "cql3/result_generator.hh"
 
 namespace cql3 {
 
 metadata::metadata(std::vector<::shared_ptr<column_specification>> names_)
         : _flags(flag_enum_set())
-        , names(std::move(names_)) {
+        , names(std::move(names_))
+        , _serialized_names(make_lw_shared<sstring>()) {
     _column_count = names.size();
 }
 
@@ -55,6 +57,7 @@ metadata::metadata(flag_enum_set flags, std::vector<::shared_ptr<column_specific
     , names(std::move(names_))
     , _column_count(column_count)
     , _paging_state(std::move(paging_state))
+    , _serialized_names(make_lw_shared<sstring>())
 { }
 
 // The maximum number of values that the ResultSet can hold. This can be bigger than columnCount due to CASSANDRA-4911
@@ -105,6 +108,10 @@ const std::vector<::shared_ptr<column_specification>>& metadata::get_names() con
     return names;
 }
 
+sstring& metadata::serialized_names() const {
+    return *_serialized_names;
+}
+
 prepared_metadata::prepared_metadata(const std::vector<::shared_ptr<column_specification>>& names,
                                      const std::vector<uint16_t>& partition_key_bind_indices)
     : _names{names}
@@ -131,7 +138,7 @@ result_set::result_set(std::vector<::shared_ptr<column_specification>> metadata_
     : _metadata(::make_shared<metadata>(std::move(metadata_)))
 { }
 
-result_set::result_set(::shared_ptr<metadata> metadata)
+result_set::result_set(::shared_ptr<const metadata> metadata)
     : _metadata(std::move(metadata))
 { }
 
@@ -168,8 +175,13 @@ void result_set::trim(size_t limit) {
     }
 }
 
-metadata& result_set::get_metadata() {
-    return *_metadata;
+void result_set::set_has_more_pages(::shared_ptr<const service::pager::paging_state> paging_state) {
+    if (!paging_state) {
+        return;
+    }
+    auto m = ::make_shared<metadata>(*_metadata);
+    m->set_has_more_pages(std::move(paging_state));
+    _metadata = std::move(m);
 }
 
 const metadata& result_set::get_metadata() const {
@@ -180,6 +192,29 @@ const std::deque<std::vector<bytes_opt>>& result_set::rows() const {
     return _rows;
 }
 
+const cql3::result_set& result::result_set() const {
+    if (!_result_set) {
+        struct builder {
+            cql3::result_set& _rs;
+            std::vector<bytes_opt> _current;
+
+            void start_row() {
+                _current.reserve(_rs.get_metadata().column_count());
+            }
+            void accept_value(bytes_view_opt value) {
+                _current.emplace_back(value ? bytes_opt(to_bytes(*value)) : bytes_opt());
+            }
+            void end_row() {
+                _rs.add_row(std::exchange(_current, {}));
+            }
+        };
+        auto rs = std::make_unique<cql3::result_set>(_metadata);
+        _result_generator->visit(builder{*rs});
+        _result_set = std::move(rs);
+    }
+    return *_result_set;
+}
+
 shared_ptr<const cql3::metadata>
 make_empty_metadata() {
     static thread_local shared_ptr<const metadata> empty_metadata_cache = [] {
@@ -77,6 +77,10 @@ class metadata {
 private:
     uint32_t _column_count;
     ::shared_ptr<const service::pager::paging_state> _paging_state;
+    // Wire encoding of the column specifications, filled in by the CQL server
+    // the first time this metadata is written. Copies share it, so the result
+    // metadata of a prepared statement is encoded once rather than per response.
+    lw_shared_ptr<sstring> _serialized_names;
 
 public:
     metadata(std::vector<::shared_ptr<column_specification>> names_);
@@ -104,6 +108,9 @@ class metadata {
     ::shared_ptr<const service::pager::paging_state> paging_state() const;
 
     const std::vector<::shared_ptr<column_specification>>& get_names() const;
+
+    // Cached wire encoding of the column specifications; empty until set.
+    sstring& serialized_names() const;
 };
 
 ::shared_ptr<const cql3::metadata> make_empty_metadata();
@@ -133,12 +140,12 @@ class prepared_metadata {
 
 class result_set {
 public:
-    ::shared_ptr<metadata> _metadata;
+    ::shared_ptr<const metadata> _metadata;
     std::deque<std::vector<bytes_opt>> _rows;
 public:
     result_set(std::vector<::shared_ptr<column_specification>> metadata_);
 
-    result_set(::shared_ptr<metadata> metadata);
+    result_set(::shared_ptr<const metadata> metadata);
 
     size_t size() const;
 
@@ -157,12 +164,29 @@ class result_set {
         std::sort(_rows.begin(), _rows.end(), std::ref(cmp));
     }
 
-    metadata& get_metadata();
+    // The metadata is shared with the statement which produced the result set,
+    // so it is copied only when it has to change.
+    void set_has_more_pages(::shared_ptr<const service::pager::paging_state> paging_state);
 
     const metadata& get_metadata() const;
 
     // Returns a range of rows. A row is a range of bytes_opt.
     const std::deque<std::vector<bytes_opt>>& rows() const;
+
+    // Passes values of the serialized columns of all rows to the visitor,
+    // see result_generator::visit() for the interface.
+    template<typename Visitor>
+    void visit(Visitor&& visitor) const {
+        auto column_count = get_metadata().column_count();
+        for (auto&& row : _rows) {
+            visitor.start_row();
+            for (uint32_t i = 0; i < column_count; ++i) {
+                auto& cell = row[i];
+                visitor.accept_value(cell ? bytes_view_opt(*cell) : bytes_view_opt());
+            }
+            visitor.end_row();
+        }
+    }
 };
 
 }
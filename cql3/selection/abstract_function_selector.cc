@@ -40,6 +40,7 @@
 #include "abstract_function_selector.hh"
 #include "aggregate_function_selector.hh"
 #include "scalar_function_selector.hh"
+#include "cql3/functions/aggregate_fcts.hh"
 #include "to_string.hh"
 
 namespace cql3 {
@@ -97,6 +98,10 @@ abstract_function_selector::new_factory(shared_ptr<functions::function> fun, sha
         virtual bool is_aggregate_selector_factory() override {
             return _fun->is_aggregate() || _factories->contains_only_aggregate_functions();
         }
+
+        virtual bool is_count_rows_selector_factory() override {
+            return bool(dynamic_pointer_cast<functions::aggregate_fcts::count_rows_function>(_fun));
+        }
     };
 
     return make_shared<fun_selector_factory>(std::move(fun), std::move(factories));
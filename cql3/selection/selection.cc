@@ -106,6 +106,10 @@ class simple_selection : public selection {
 
     virtual bool is_wildcard() const override { return _is_wildcard; }
     virtual bool is_aggregate() const override { return false; }
+    virtual bool is_trivial() const override {
+        // Columns added for post-query ordering are not serialized.
+        return get_result_metadata()->column_count() == get_column_count();
+    }
 protected:
     class simple_selectors : public selectors {
     private:
@@ -162,6 +166,10 @@ class selection_with_processing : public selection {
     virtual bool is_aggregate() const override {
         return _factories->contains_only_aggregate_functions();
     }
+
+    virtual bool is_count_rows() const override {
+        return _factories->is_count_rows();
+    }
 protected:
     class selectors_with_processing : public selectors {
     private:
@@ -252,7 +260,7 @@ selection::collect_metadata(schema_ptr schema, const std::vector<::shared_ptr<ra
 }
 
 result_set_builder::result_set_builder(const selection& s, gc_clock::time_point now, cql_serialization_format sf)
-    : _result_set(std::make_unique<result_set>(::make_shared<metadata>(*(s.get_result_metadata()))))
+    : _result_set(std::make_unique<result_set>(s.get_result_metadata()))
     , _selectors(s.new_selectors())
     , _now(now)
     , _cql_serialization_format(sf)
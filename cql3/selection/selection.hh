@@ -98,6 +98,23 @@ class selection {
         return false;
     }
 
+    /**
+     * Checks if this selection outputs the selected columns as they were read,
+     * without any processing or additional columns.
+     * Rows of trivial selections can be generated directly from query::result.
+     */
+    virtual bool is_trivial() const {
+        return false;
+    }
+
+    /**
+     * Checks if this selection is a lone <code>count(*)</code>, whose result
+     * depends only on the number of rows read.
+     */
+    virtual bool is_count_rows() const {
+        return false;
+    }
+
     /**
      * Checks if this selection contains static columns.
      * @return <code>true</code> if this selection contains static columns, <code>false</code> otherwise;
@@ -172,6 +172,16 @@ class selector::factory {
         return false;
     }
 
+    /**
+     * Checks if this factory creates <code>count(*)</code> selectors instances.
+     *
+     * @return <code>true</code> if this factory creates <code>count(*)</code> selectors instances,
+     * <code>false</code> otherwise
+     */
+    virtual bool is_count_rows_selector_factory() {
+        return false;
+    }
+
     /**
      * Returns the name of the column corresponding to the output value of the selector instances created by
      * this factory.
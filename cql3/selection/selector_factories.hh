@@ -143,6 +143,15 @@ class selector_factories {
         return _contains_ttl_factory;
     }
 
+    /**
+     * Checks if this <code>SelectorFactories</code> consists of a single <code>count(*)</code> factory.
+     *
+     * @return <code>true</code> if the only selector is <code>count(*)</code>, <code>false</code> otherwise.
+     */
+    bool is_count_rows() const {
+        return _factories.size() == 1 && _factories.front()->is_count_rows_selector_factory();
+    }
+
     /**
      * Creates a list of new <code>selector</code> instances.
      * @return a list of new <code>selector</code> instances.
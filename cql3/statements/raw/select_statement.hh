@@ -75,13 +75,17 @@ class select_statement : public cf_statement
         const orderings_type _orderings;
         const bool _is_distinct;
         const bool _allow_filtering;
+        const bool _bypass_cache;
     public:
         parameters();
         parameters(orderings_type orderings,
             bool is_distinct,
-            bool allow_filtering);
+            bool allow_filtering,
+            bool bypass_cache = false);
         bool is_distinct();
         bool allow_filtering();
+        // True iff the query should neither read from nor populate the row cache.
+        bool bypass_cache();
         orderings_type const& orderings();
     };
     template<typename T>
@@ -54,6 +54,7 @@
 #include "partition_slice_builder.hh"
 #include "cql3/untyped_result_set.hh"
 #include "db/timeout_clock.hh"
+#include "service/storage_service.hh"
 
 namespace cql3 {
 
@@ -64,14 +65,17 @@ thread_local const shared_ptr<select_statement::parameters> select_statement::_d
 select_statement::parameters::parameters()
     : _is_distinct{false}
     , _allow_filtering{false}
+    , _bypass_cache{false}
 { }
 
 select_statement::parameters::parameters(orderings_type orderings,
                                          bool is_distinct,
-                                         bool allow_filtering)
+                                         bool allow_filtering,
+                                         bool bypass_cache)
     : _orderings{std::move(orderings)}
     , _is_distinct{is_distinct}
     , _allow_filtering{allow_filtering}
+    , _bypass_cache{bypass_cache}
 { }
 
 bool select_statement::parameters::is_distinct() {
@@ -82,6 +86,10 @@ bool select_statement::parameters::allow_filtering() {
     return _allow_filtering;
 }
 
+bool select_statement::parameters::bypass_cache() {
+    return _bypass_cache;
+}
+
 select_statement::parameters::orderings_type const& select_statement::parameters::orderings() {
     return _orderings;
 }
@@ -157,6 +165,12 @@ const sstring& select_statement::column_family() const {
 query::partition_slice
 select_statement::make_partition_slice(const query_options& options)
 {
+    // The statement is shared by all of its executions, so don't modify _opts.
+    auto opts = _opts;
+    // Replicas which don't know the option would fail to deserialize the slice.
+    opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache()
+            && service::get_local_storage_service().cluster_supports_bypass_cache());
+
     std::vector<column_id> static_columns;
     std::vector<column_id> regular_columns;
 
@@ -175,18 +189,19 @@ select_statement::make_partition_slice(const query_options& options)
     }
 
     if (_parameters->is_distinct()) {
-        _opts.set(query::partition_slice::option::distinct);
+        opts.set(query::partition_slice::option::distinct);
         return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
-            std::move(static_columns), {}, _opts, nullptr, options.get_cql_serialization_format());
+            std::move(static_columns), {}, opts, nullptr, options.get_cql_serialization_format());
     }
 
     auto bounds = _restrictions->get_clustering_bounds(options);
     if (_is_reversed) {
-        _opts.set(query::partition_slice::option::reversed);
+        opts.set(query::partition_slice::option::reversed);
         std::reverse(bounds.begin(), bounds.end());
     }
     return query::partition_slice(std::move(bounds),
-        std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format());
+        std::move(static_columns), std::move(regular_columns), opts, nullptr, options.get_cql_serialization_format(),
+        query::max_rows, _restrictions->get_column_filters(options));
 }
 
 int32_t select_statement::get_limit(const query_options& options) const {
@@ -269,9 +284,32 @@ select_statement::do_execute(distributed<service::storage_proxy>& proxy,
     }
 
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
+    // A lone count(*) over a single partition is counted by the replicas,
+    // which then send only the last row of each page instead of all of them.
+    auto count_on_replicas = aggregate && _selection->is_count_rows()
+            && key_ranges.size() == 1 && key_ranges.front().is_singular()
+            && service::get_local_storage_service().cluster_supports_replica_row_count();
+
     auto p = service::pager::query_pagers::pager(_schema, _selection,
             state, options, command, std::move(key_ranges));
 
+    if (count_on_replicas) {
+        return do_with(uint64_t(0), [this, p, page_size] (uint64_t& count) {
+            return do_until([p] {return p->is_exhausted();},
+                    [p, &count, page_size] {
+                        return p->fetch_page_row_count(page_size).then([&count] (uint32_t rows) {
+                            count += rows;
+                        });
+                    }
+            ).then([this, &count] {
+                auto rs = std::make_unique<result_set>(_selection->get_result_metadata());
+                rs->add_row({long_type->decompose(int64_t(count))});
+                auto msg = ::make_shared<cql_transport::messages::result_message::rows>(std::move(rs));
+                return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(std::move(msg));
+            });
+        });
+    }
+
     if (aggregate) {
         return do_with(
                 cql3::selection::result_set_builder(*_selection, now,
@@ -295,11 +333,25 @@ select_statement::do_execute(distributed<service::storage_proxy>& proxy,
                         " you must either remove the ORDER BY or the IN and sort client side, or disable paging for this query");
     }
 
+    if (_selection->is_trivial()) {
+        // Rows will be serialized straight from the query result of the page.
+        return p->fetch_page_generator(page_size, now).then([this, p] (cql3::result_generator generator) {
+            auto meta = _selection->get_result_metadata();
+            if (!p->is_exhausted()) {
+                auto m = ::make_shared<cql3::metadata>(*meta);
+                m->set_has_more_pages(p->state());
+                meta = std::move(m);
+            }
+            auto msg = ::make_shared<cql_transport::messages::result_message::rows>(cql3::result(std::move(generator), std::move(meta)));
+            return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(std::move(msg));
+        });
+    }
+
     return p->fetch_page(page_size, now).then(
             [this, p, &options, limit, now](std::unique_ptr<cql3::result_set> rs) {
 
                 if (!p->is_exhausted()) {
-                    rs->get_metadata().set_has_more_pages(p->state());
+                    rs->set_has_more_pages(p->state());
                 }
 
                 auto msg = ::make_shared<cql_transport::messages::result_message::rows>(std::move(rs));
@@ -385,6 +437,13 @@ select_statement::process_results(foreign_ptr<lw_shared_ptr<query::result>> resu
                                   const query_options& options,
                                   gc_clock::time_point now)
 {
+    if (_selection->is_trivial() && !needs_post_query_ordering()) {
+        // Rows will be serialized straight from the query result.
+        return ::make_shared<cql_transport::messages::result_message::rows>(cql3::result(
+                cql3::result_generator(_schema, std::move(results), cmd, _selection),
+                _selection->get_result_metadata()));
+    }
+
     cql3::selection::result_set_builder builder(*_selection, now,
             options.get_cql_serialization_format());
     query::result_view::consume(*results, cmd->slice,
@@ -607,6 +666,11 @@ std::unique_ptr<prepared_statement> select_statement::prepare(database& db, cql_
 
     check_needs_filtering(restrictions);
 
+    if (restrictions->uses_replica_filtering() && !service::get_local_storage_service().cluster_supports_replica_filtering()) {
+        throw exceptions::invalid_request_exception(
+            "Filtering on non-primary key columns requires all nodes in the cluster to support it");
+    }
+
     ::shared_ptr<cql3::statements::select_statement> stmt;
     if (restrictions->uses_secondary_indexing()) {
         stmt = indexed_table_select_statement::prepare(
@@ -647,7 +711,7 @@ select_statement::prepare_restrictions(database& db,
 {
     try {
         return ::make_shared<restrictions::statement_restrictions>(db, schema, statement_type::SELECT, std::move(_where_clause), bound_names,
-            selection->contains_only_static_columns(), selection->contains_a_collection(), for_view);
+            selection->contains_only_static_columns(), selection->contains_a_collection(), for_view, _parameters->allow_filtering());
     } catch (const exceptions::unrecognized_entity_exception& e) {
         if (contains_alias(e.entity)) {
             throw exceptions::invalid_request_exception(sprint("Aliases aren't allowed in the where clause ('%s')", e.relation->to_string()));
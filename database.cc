@@ -50,6 +50,8 @@
 #include <boost/function_output_iterator.hpp>
 #include <boost/range/algorithm/heap_algorithm.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
+#include <boost/range/algorithm/remove.hpp>
+#include <boost/range/algorithm/equal.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/sort.hpp>
@@ -508,6 +510,158 @@ class incremental_reader_selector : public reader_selector {
     }
 };
 
+// Reads a single row from sstables one at a time, in descending order of the
+// newest data they hold, and stops as soon as the remaining sstables can no
+// longer affect the result: all requested cells have been found live, and
+// each is newer than anything, tombstones included, in the sstables not read.
+//
+// Only valid for reads which select atomic regular columns of a single, fully
+// specified row, whose cells are reconciled by timestamp alone.
+class newest_first_single_row_reader final : public flat_mutation_reader::impl {
+    std::vector<sstables::shared_sstable> _sstables;
+    utils::estimated_histogram& _sstable_histogram;
+    const dht::partition_range& _pr;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    reader_resource_tracker _resource_tracker;
+    tracing::trace_state_ptr _trace_state;
+    clustering_key _ck;
+    gc_clock::time_point _now = gc_clock::now();
+    size_t _next = 0;
+    mutation_opt _result;
+    flat_mutation_reader_opt _reader;
+private:
+    bool is_complete() const {
+        if (_next == _sstables.size()) {
+            return true;
+        }
+        if (!_result) {
+            return false;
+        }
+        auto& p = _result->partition();
+        auto* r = p.find_row(*_schema, _ck);
+        if (!r) {
+            return false;
+        }
+        auto max_remaining_timestamp = _sstables[_next]->get_stats_metadata().max_timestamp;
+        auto t = p.tombstone_for_row(*_schema, _ck).tomb();
+        return boost::algorithm::all_of(_slice.regular_columns, [&] (column_id id) {
+            auto* c = r->find_cell(id);
+            if (!c) {
+                return false;
+            }
+            auto cell = c->as_atomic_cell();
+            return cell.timestamp() > max_remaining_timestamp && cell.is_live(t, _now, false);
+        });
+    }
+    future<> read_next_sstable() {
+        auto& sst = _sstables[_next++];
+        tracing::trace(_trace_state, "Reading key {} from sstable {}", _pr, seastar::value_of([&sst] { return sst->get_filename(); }));
+        auto reader = make_lw_shared<flat_mutation_reader>(sst->read_row_flat(_schema, _pr.start()->value(), _slice, _pc,
+                _resource_tracker, streamed_mutation::forwarding::no));
+        return read_mutation_from_flat_mutation_reader(*reader).then([this, reader] (mutation_opt&& mo) {
+            ::apply(_result, std::move(mo));
+        });
+    }
+    future<> read_sstables() {
+        return repeat([this] {
+            if (is_complete()) {
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            }
+            return read_next_sstable().then([] {
+                return stop_iteration::no;
+            });
+        }).then([this] {
+            tracing::trace(_trace_state, "Read {} out of {} sstables newest first", _next, _sstables.size());
+            _sstable_histogram.add(_next);
+            std::vector<mutation> ms;
+            if (_result) {
+                ms.emplace_back(std::move(*_result));
+            }
+            _reader = flat_mutation_reader_from_mutations(std::move(ms));
+        });
+    }
+public:
+    newest_first_single_row_reader(schema_ptr s,
+                                   std::vector<sstables::shared_sstable> sstables,
+                                   utils::estimated_histogram& sstable_histogram,
+                                   const dht::partition_range& pr,
+                                   const query::partition_slice& slice,
+                                   const io_priority_class& pc,
+                                   reader_resource_tracker resource_tracker,
+                                   tracing::trace_state_ptr trace_state,
+                                   clustering_key ck)
+        : impl(std::move(s))
+        , _sstables(std::move(sstables))
+        , _sstable_histogram(sstable_histogram)
+        , _pr(pr)
+        , _slice(slice)
+        , _pc(pc)
+        , _resource_tracker(std::move(resource_tracker))
+        , _trace_state(std::move(trace_state))
+        , _ck(std::move(ck)) {
+        boost::sort(_sstables, [] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_stats_metadata().max_timestamp > b->get_stats_metadata().max_timestamp;
+        });
+    }
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        if (!_reader) {
+            return read_sstables().then([this, timeout] {
+                return fill_buffer(timeout);
+            });
+        }
+        return _reader->fill_buffer(timeout).then([this] {
+            _end_of_stream = _reader->is_end_of_stream();
+            while (!_reader->is_buffer_empty()) {
+                push_mutation_fragment(_reader->pop_mutation_fragment());
+            }
+        });
+    }
+    virtual void next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = true;
+        }
+    }
+    virtual future<> fast_forward_to(const dht::partition_range&, db::timeout_clock::time_point) override {
+        throw std::bad_function_call();
+    }
+    virtual future<> fast_forward_to(position_range, db::timeout_clock::time_point) override {
+        throw std::bad_function_call();
+    }
+};
+
+// Returns the key of the row read by the slice if the read can be served by
+// newest_first_single_row_reader, see there.
+static std::experimental::optional<clustering_key>
+newest_first_row_key(const schema& s, const partition_key& pk, const query::partition_slice& slice, streamed_mutation::forwarding fwd) {
+    if (fwd || s.is_counter() || s.is_view() || !slice.static_columns.empty() || slice.regular_columns.empty()
+            || slice.options.contains(query::partition_slice::option::reversed)) {
+        return { };
+    }
+    auto all_atomic = boost::algorithm::all_of(slice.regular_columns, [&s] (column_id id) {
+        return s.regular_column_at(id).is_atomic();
+    });
+    if (!all_atomic) {
+        return { };
+    }
+    auto& ranges = slice.row_ranges(s, pk);
+    if (ranges.size() != 1) {
+        return { };
+    }
+    auto& range = ranges.front();
+    if (!s.clustering_key_size()) {
+        if (!range.is_full()) {
+            return { };
+        }
+        return clustering_key::make_empty();
+    }
+    if (!query::is_single_row(s, range)) {
+        return { };
+    }
+    return range.start()->value();
+}
+
 static flat_mutation_reader
 create_single_key_sstable_reader(column_family* cf,
                                  schema_ptr schema,
@@ -519,11 +673,20 @@ create_single_key_sstable_reader(column_family* cf,
                                  reader_resource_tracker resource_tracker,
                                  tracing::trace_state_ptr trace_state,
                                  streamed_mutation::forwarding fwd,
-                                 mutation_reader::forwarding fwd_mr)
+                                 mutation_reader::forwarding fwd_mr,
+                                 column_family::read_newest_first newest_first)
 {
-    auto key = sstables::key::from_partition_key(*schema, *pr.start()->value().key());
+    auto& pk = *pr.start()->value().key();
+    auto key = sstables::key::from_partition_key(*schema, pk);
+    auto candidates = filter_sstable_for_reader(sstables->select(pr), *cf, schema, key, slice);
+    if (newest_first && candidates.size() > 1) {
+        if (auto ck = newest_first_row_key(*schema, pk, slice, fwd)) {
+            return make_flat_mutation_reader<newest_first_single_row_reader>(std::move(schema), std::move(candidates),
+                    sstable_histogram, pr, slice, pc, std::move(resource_tracker), std::move(trace_state), std::move(*ck));
+        }
+    }
     auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
-        filter_sstable_for_reader(sstables->select(pr), *cf, schema, key, slice)
+        candidates
         | boost::adaptors::transformed([&] (const sstables::shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pr, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->read_row_flat(schema, pr.start()->value(), slice, pc, resource_tracker, fwd);
@@ -544,7 +707,8 @@ column_family::make_sstable_reader(schema_ptr s,
                                    const io_priority_class& pc,
                                    tracing::trace_state_ptr trace_state,
                                    streamed_mutation::forwarding fwd,
-                                   mutation_reader::forwarding fwd_mr) const {
+                                   mutation_reader::forwarding fwd_mr,
+                                   read_newest_first newest_first) const {
     auto* semaphore = service::get_local_streaming_read_priority().id() == pc.id()
         ? _config.streaming_read_concurrency_semaphore
         : _config.read_concurrency_semaphore;
@@ -560,7 +724,7 @@ column_family::make_sstable_reader(schema_ptr s,
         }
 
         if (semaphore) {
-            auto ms = mutation_source([semaphore, this, sstables=std::move(sstables)] (
+            auto ms = mutation_source([semaphore, this, sstables=std::move(sstables), newest_first] (
                         schema_ptr s,
                         const dht::partition_range& pr,
                         const query::partition_slice& slice,
@@ -570,12 +734,12 @@ column_family::make_sstable_reader(schema_ptr s,
                         mutation_reader::forwarding fwd_mr,
                         reader_resource_tracker tracker) {
                     return create_single_key_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(sstables),
-                                _stats.estimated_sstable_per_read, pr, slice, pc, tracker, std::move(trace_state), fwd, fwd_mr);
+                                _stats.estimated_sstable_per_read, pr, slice, pc, tracker, std::move(trace_state), fwd, fwd_mr, newest_first);
                 });
             return make_restricted_flat_reader(*semaphore, std::move(ms), std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
         } else {
             return create_single_key_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(sstables),
-                        _stats.estimated_sstable_per_read, pr, slice, pc, no_resource_tracking(), std::move(trace_state), fwd, fwd_mr);
+                        _stats.estimated_sstable_per_read, pr, slice, pc, no_resource_tracking(), std::move(trace_state), fwd, fwd_mr, newest_first);
         }
     } else {
         if (semaphore) {
@@ -643,6 +807,18 @@ column_family::make_reader(schema_ptr s,
                            tracing::trace_state_ptr trace_state,
                            streamed_mutation::forwarding fwd,
                            mutation_reader::forwarding fwd_mr) const {
+    return make_reader(std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr, read_newest_first::no);
+}
+
+flat_mutation_reader
+column_family::make_reader(schema_ptr s,
+                           const dht::partition_range& range,
+                           const query::partition_slice& slice,
+                           const io_priority_class& pc,
+                           tracing::trace_state_ptr trace_state,
+                           streamed_mutation::forwarding fwd,
+                           mutation_reader::forwarding fwd_mr,
+                           read_newest_first newest_first) const {
     if (_virtual_reader) {
         return (*_virtual_reader).make_reader(s, range, slice, pc, trace_state, fwd, fwd_mr);
     }
@@ -674,10 +850,15 @@ column_family::make_reader(schema_ptr s,
         readers.emplace_back(mt->make_flat_reader(s, range, slice, pc, trace_state, fwd, fwd_mr));
     }
 
-    if (_config.enable_cache) {
+    if (_config.enable_cache && !slice.options.contains<query::partition_slice::option::bypass_cache>()) {
         readers.emplace_back(_cache.make_reader(s, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
     } else {
-        readers.emplace_back(make_sstable_reader(s, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr));
+        if (_config.enable_cache && _config.cf_stats) {
+            ++_config.cf_stats->reads_bypassing_cache;
+        }
+        // Nothing is populated from this read, so it can stop at the sstables it needs.
+        readers.emplace_back(make_sstable_reader(s, _sstables, range, slice, pc, std::move(trace_state), fwd, fwd_mr,
+                newest_first));
     }
 
     return make_combined_reader(s, std::move(readers), fwd, fwd_mr);
@@ -769,7 +950,7 @@ column_family::open_sstable(sstables::foreign_sstable_open_info info, sstring di
     });
 }
 
-void column_family::load_sstable(sstables::shared_sstable& sst, bool reset_level) {
+void column_family::load_sstable(sstables::shared_sstable& sst, bool reset_level, bool maintenance) {
     if (schema()->is_counter() && !sst->has_scylla_component()) {
         throw std::runtime_error("Loading non-Scylla SSTables containing counters is not supported. Use sstableloader instead.");
     }
@@ -793,7 +974,13 @@ void column_family::load_sstable(sstables::shared_sstable& sst, bool reset_level
         // the sstables to level 0.
         sst->set_sstable_level(0);
     }
-    add_sstable(sst, std::move(shards));
+    // Shared sstables are taken care of by resharding.
+    if (maintenance && !belongs_to_other_shard(shards)) {
+        add_maintenance_sstable(sst, std::move(shards));
+    } else {
+        add_sstable(sst, std::move(shards));
+        invalidate_coalesced_reads();
+    }
 }
 
 void column_family::update_stats_for_new_sstable(uint64_t disk_space_used_by_sstable, const std::vector<unsigned>& shards_for_the_sstable) noexcept {
@@ -814,6 +1001,27 @@ void column_family::add_sstable(sstables::shared_sstable sstable, const std::vec
     _compaction_strategy.get_backlog_tracker().add_sstable(sstable);
 }
 
+void column_family::add_maintenance_sstable(sstables::shared_sstable sstable, const std::vector<unsigned>& shards_for_the_sstable) {
+    add_sstable(sstable, shards_for_the_sstable);
+    invalidate_coalesced_reads();
+    if (_config.offstrategy_compaction_delay == std::chrono::seconds(0)) {
+        return;
+    }
+    _maintenance_sstables.insert(std::move(sstable));
+    // Streaming and repair write sstables for a while, so wait for them to stop arriving
+    // rather than reshaping each batch on its own.
+    _offstrategy_compaction_timer.rearm(timer<>::clock::now() + _config.offstrategy_compaction_delay);
+}
+
+void column_family::on_offstrategy_compaction_timer() {
+    // Once the column family is being stopped, it must not be submitted to the compaction
+    // manager anymore. The compaction isn't waited for under the gate, since that would
+    // delay stop() until it's done; the compaction manager stops it instead.
+    run_async([this] {
+        (void)run_offstrategy_compaction();
+    }).handle_exception([] (std::exception_ptr) { });
+}
+
 future<>
 column_family::update_cache(lw_shared_ptr<memtable> m, sstables::shared_sstable sst) {
     auto adder = [this, m, sst] {
@@ -903,7 +1111,7 @@ column_family::seal_active_streaming_memtable_immediate(flush_permit&& permit) {
                 }).then([this, old, newtab] () {
                     return with_scheduling_group(_config.memtable_to_cache_scheduling_group, [this, newtab, old] {
                       auto adder = [this, newtab] {
-                          add_sstable(newtab, {engine().cpu_id()});
+                          add_maintenance_sstable(newtab, {engine().cpu_id()});
                           try_trigger_compaction();
                           dblog.debug("Flushing to {} done", newtab->get_filename());
                       };
@@ -1244,7 +1452,15 @@ void column_family::set_metrics() {
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
                 ms::make_gauge("live_sstable", ms::description("Live sstable count"), _stats.live_sstable_count)(cf)(ks),
-                ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks)
+                ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks),
+                ms::make_derive("compactions", ms::description("Number of compactions completed for this column family"), _stats.compactions_completed)(cf)(ks),
+                ms::make_derive("compaction_bytes_read", ms::description("Bytes of sstables compacted"), _stats.compaction_bytes_read)(cf)(ks),
+                ms::make_derive("compaction_bytes_written", ms::description("Bytes of sstables written by compaction"), _stats.compaction_bytes_written)(cf)(ks),
+                ms::make_derive("compaction_partitions_read", ms::description("Number of partitions read by compaction"), _stats.compaction_partitions_read)(cf)(ks),
+                ms::make_derive("compaction_partitions_written", ms::description("Number of partitions written by compaction"), _stats.compaction_partitions_written)(cf)(ks),
+                ms::make_derive("compaction_partitions_merged", ms::description("Number of partitions which compaction merged from more than one sstable"), _stats.compaction_partitions_merged)(cf)(ks),
+                ms::make_derive("compaction_purged_tombstones", ms::description("Number of tombstones purged by compaction"), _stats.compaction_purged_tombstones)(cf)(ks),
+                ms::make_derive("compaction_time", ms::description("Total time spent in compaction, in milliseconds"), _stats.compaction_time_ms)(cf)(ks)
         });
         if (_schema->ks_name() != db::system_keyspace::NAME && _schema->ks_name() != db::schema_tables::v3::NAME && _schema->ks_name() != "system_traces") {
             _metrics.add_group("column_family", {
@@ -1292,7 +1508,7 @@ column_family::rebuild_sstable_list(const std::vector<sstables::shared_sstable>&
 
 void
 column_family::on_compaction_completion(const std::vector<sstables::shared_sstable>& new_sstables,
-                                    const std::vector<sstables::shared_sstable>& sstables_to_remove) {
+                                    const std::vector<sstables::shared_sstable>& sstables_to_remove, bool offstrategy) {
     // Build a new list of _sstables: We remove from the existing list the
     // tables we compacted (by now, there might be more sstables flushed
     // later), and we add the new tables generated by the compaction.
@@ -1320,10 +1536,18 @@ column_family::on_compaction_completion(const std::vector<sstables::shared_sstab
     auto new_compacted_but_not_deleted = _sstables_compacted_but_not_deleted;
     // rebuilding _sstables_compacted_but_not_deleted first to make the entire rebuild operation exception safe.
     new_compacted_but_not_deleted.insert(new_compacted_but_not_deleted.end(), sstables_to_remove.begin(), sstables_to_remove.end());
+    auto new_maintenance_sstables = _maintenance_sstables;
+    for (auto& sst : sstables_to_remove) {
+        new_maintenance_sstables.erase(sst);
+    }
+    if (offstrategy) {
+        new_maintenance_sstables.insert(new_sstables.begin(), new_sstables.end());
+    }
 
     rebuild_sstable_list(new_sstables, sstables_to_remove);
 
     _sstables_compacted_but_not_deleted = std::move(new_compacted_but_not_deleted);
+    _maintenance_sstables = std::move(new_maintenance_sstables);
 
     rebuild_statistics();
 
@@ -1406,7 +1630,12 @@ column_family::compact_sstables(sstables::compaction_descriptor descriptor, bool
         return make_ready_future<>();
     }
 
-    return with_lock(_sstables_lock.for_read(), [this, descriptor = std::move(descriptor), cleanup] () mutable {
+    // Only off-strategy compaction is given maintenance sstables, and its output is kept
+    // among them until it's done.
+    auto offstrategy = boost::algorithm::all_of(descriptor.sstables, [this] (const sstables::shared_sstable& sst) {
+        return _maintenance_sstables.count(sst);
+    });
+    return with_lock(_sstables_lock.for_read(), [this, descriptor = std::move(descriptor), cleanup, offstrategy] () mutable {
         auto create_sstable = [this] {
                 auto gen = this->calculate_generation_for_new_table();
                 auto sst = sstables::make_sstable(_schema, _config.datadir, gen,
@@ -1415,14 +1644,40 @@ column_family::compact_sstables(sstables::compaction_descriptor descriptor, bool
                 sst->set_unshared();
                 return sst;
         };
+        if (_config.compaction_fragment_size && _compaction_strategy.type() == sstables::compaction_strategy_type::size_tiered) {
+            // Size-tiered compaction writes a run of fragments, and replaces each input sstable
+            // as soon as the output moves past it, so it doesn't hold all of them until it's done.
+            descriptor.fragment_size = _config.compaction_fragment_size;
+            descriptor.replacer = [this, offstrategy, release_exhausted = std::move(descriptor.release_exhausted)] (sstables::compaction_completion_desc desc) {
+                _compaction_strategy.notify_completion(desc.input_sstables, desc.output_sstables);
+                this->on_compaction_completion(desc.output_sstables, desc.input_sstables, offstrategy);
+                if (release_exhausted) {
+                    release_exhausted(desc.input_sstables);
+                }
+            };
+            return sstables::compact_sstables(std::move(descriptor), *this, create_sstable, cleanup);
+        }
         auto sstables_to_compact = descriptor.sstables;
         return sstables::compact_sstables(std::move(descriptor), *this, create_sstable,
-                cleanup).then([this, sstables_to_compact = std::move(sstables_to_compact)] (auto info) {
+                cleanup).then([this, offstrategy, sstables_to_compact = std::move(sstables_to_compact)] (auto info) {
             _compaction_strategy.notify_completion(sstables_to_compact, info.new_sstables);
-            this->on_compaction_completion(info.new_sstables, sstables_to_compact);
+            this->on_compaction_completion(info.new_sstables, sstables_to_compact, offstrategy);
             return info;
         });
     }).then([this] (auto info) {
+        _stats.compactions_completed++;
+        _stats.compaction_bytes_read += info.start_size;
+        _stats.compaction_bytes_written += info.end_size;
+        _stats.compaction_partitions_read += info.total_keys_read;
+        _stats.compaction_partitions_written += info.total_keys_written;
+        for (auto& mc : info.merged_partitions) {
+            if (mc.first > 1) {
+                _stats.compaction_partitions_merged += mc.second;
+            }
+        }
+        _stats.compaction_purged_tombstones += info.purged_tombstones;
+        _stats.compaction_time_ms += info.ended_at - info.started_at;
+
         if (info.type != sstables::compaction_type::Compaction) {
             return make_ready_future<>();
         }
@@ -1430,12 +1685,18 @@ column_family::compact_sstables(sstables::compaction_descriptor descriptor, bool
         if (!db::qctx) {
             return make_ready_future<>();
         }
-        // FIXME: add support to merged_rows. merged_rows is a histogram that
-        // shows how many sstables each row is merged from. This information
-        // cannot be accessed until we make combined_reader more generic,
-        // for example, by adding a reducer method.
-        return db::system_keyspace::update_compaction_history(info.ks, info.cf, info.ended_at,
-            info.start_size, info.end_size, std::unordered_map<int32_t, int64_t>{});
+        db::system_keyspace::compaction_history_entry entry;
+        entry.ks = std::move(info.ks);
+        entry.cf = std::move(info.cf);
+        entry.started_at = info.started_at;
+        entry.compacted_at = info.ended_at;
+        entry.bytes_in = info.start_size;
+        entry.bytes_out = info.end_size;
+        entry.partitions_in = info.total_keys_read;
+        entry.partitions_out = info.total_keys_written;
+        entry.purged_tombstones = info.purged_tombstones;
+        entry.rows_merged = std::move(info.merged_partitions);
+        return db::system_keyspace::update_compaction_history(std::move(entry));
     });
 }
 
@@ -1473,7 +1734,32 @@ future<> column_family::cleanup_sstables(sstables::compaction_descriptor descrip
             static thread_local semaphore sem(1);
 
             return with_semaphore(sem, 1, [this, &sst] {
-                return this->compact_sstables(sstables::compaction_descriptor({ sst }, sst->get_sstable_level()), true);
+                auto descriptor = sstables::compaction_descriptor({ sst }, sst->get_sstable_level());
+                descriptor.parallelism = major_compaction_parallelism();
+                return this->compact_sstables(std::move(descriptor), true);
+            });
+        });
+    });
+}
+
+future<> column_family::load_deferred_filters(semaphore& sem) {
+    auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(*_sstables->all()
+            | boost::adaptors::filtered(std::mem_fn(&sstables::sstable::has_deferred_filter)));
+    return do_with(std::move(sstables), [this, &sem] (auto& sstables) {
+        return parallel_for_each(sstables, [this, &sem] (sstables::shared_sstable& sst) {
+            return with_semaphore(sem, 1, [this, sst] {
+                return run_async([sst] {
+                    return sst->load_deferred_filter(service::get_local_compaction_priority());
+                });
+            }).handle_exception([sst] (std::exception_ptr ep) {
+                try {
+                    std::rethrow_exception(ep);
+                } catch (seastar::gate_closed_exception&) {
+                    // The column family is being stopped.
+                } catch (...) {
+                    // The sstable keeps reporting every key as present.
+                    dblog.warn("Failed to load filter of {}: {}", sst->get_filename(), ep);
+                }
             });
         });
     });
@@ -1485,6 +1771,11 @@ column_family::compact_all_sstables() {
     return _compaction_manager.submit_major_compaction(this);
 }
 
+future<> column_family::run_offstrategy_compaction() {
+    _offstrategy_compaction_timer.cancel();
+    return _compaction_manager.submit_offstrategy_compaction(this);
+}
+
 void column_family::start_compaction() {
     set_compaction_strategy(_schema->compaction_strategy());
 }
@@ -1574,7 +1865,20 @@ std::vector<sstables::shared_sstable> column_family::select_sstables(const dht::
 
 std::vector<sstables::shared_sstable> column_family::candidates_for_compaction() const {
     return boost::copy_range<std::vector<sstables::shared_sstable>>(*get_sstables()
-        | boost::adaptors::filtered([this] (auto& sst) { return !_sstables_need_rewrite.count(sst->generation()); }));
+        | boost::adaptors::filtered([this] (auto& sst) {
+            return !_sstables_need_rewrite.count(sst->generation()) && !_maintenance_sstables.count(sst);
+        }));
+}
+
+std::vector<sstables::shared_sstable> column_family::maintenance_sstables() const {
+    return boost::copy_range<std::vector<sstables::shared_sstable>>(_maintenance_sstables);
+}
+
+void column_family::integrate_maintenance_sstables(const std::vector<sstables::shared_sstable>& sstables) {
+    for (auto& sst : sstables) {
+        _maintenance_sstables.erase(sst);
+    }
+    try_trigger_compaction();
 }
 
 std::vector<sstables::shared_sstable> column_family::sstables_need_rewrite() const {
@@ -1623,7 +1927,7 @@ static future<> invoke_shards_with_ptr(std::vector<shard_id> shards, distributed
 }
 
 future<> distributed_loader::open_sstable(distributed<database>& db, sstables::entry_descriptor comps,
-        std::function<future<> (column_family&, sstables::foreign_sstable_open_info)> func, const io_priority_class& pc) {
+        std::function<future<> (column_family&, sstables::foreign_sstable_open_info)> func, const io_priority_class& pc, bool defer_filter) {
     // loads components of a sstable from shard S and share it with all other
     // shards. Which shard a sstable will be opened at is decided using
     // calculate_shard_from_sstable_generation(), which is the inverse of
@@ -1632,12 +1936,13 @@ future<> distributed_loader::open_sstable(distributed<database>& db, sstables::e
     // to distribute evenly the resource usage among all shards.
 
     return db.invoke_on(column_family::calculate_shard_from_sstable_generation(comps.generation),
-            [&db, comps = std::move(comps), func = std::move(func), pc] (database& local) {
+            [&db, comps = std::move(comps), func = std::move(func), pc, defer_filter] (database& local) {
 
-        return with_semaphore(local.sstable_load_concurrency_sem(), 1, [&db, &local, comps = std::move(comps), func = std::move(func), pc] {
+        return with_semaphore(local.sstable_load_concurrency_sem(), 1, [&db, &local, comps = std::move(comps), func = std::move(func), pc, defer_filter] {
             auto& cf = local.find_column_family(comps.ks, comps.cf);
 
-            auto f = sstables::sstable::load_shared_components(cf.schema(), cf._config.datadir, comps.generation, comps.version, comps.format, pc);
+            auto f = sstables::sstable::load_shared_components(cf.schema(), cf._config.datadir, comps.generation, comps.version, comps.format,
+                    pc, defer_filter);
             return f.then([&db, comps = std::move(comps), func = std::move(func)] (sstables::sstable_open_info info) {
                 // shared components loaded, now opening sstable in all shards that own it with shared components
                 return do_with(std::move(info), [&db, comps = std::move(comps), func = std::move(func)] (auto& info) {
@@ -1894,7 +2199,7 @@ future<> distributed_loader::load_new_sstables(distributed<database>& db, sstrin
                 // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
                 // atomically load all opened sstables into column family.
                 for (auto& sst : cf._sstables_opened_but_not_loaded) {
-                    cf.load_sstable(sst, true);
+                    cf.load_sstable(sst, true, true);
                 }
                 cf._sstables_opened_but_not_loaded.clear();
                 cf.trigger_compaction();
@@ -1939,7 +2244,9 @@ future<sstables::entry_descriptor> distributed_loader::probe_file(distributed<da
         });
     };
 
-    return distributed_loader::open_sstable(db, comps, cf_sstable_open).then_wrapped([fname] (future<> f) {
+    // Filters are only needed by reads, which may wait until the node has started.
+    auto defer_filter = db.local().get_config().lazy_sstable_filter_loading();
+    return distributed_loader::open_sstable(db, comps, cf_sstable_open, default_priority_class(), defer_filter).then_wrapped([fname] (future<> f) {
         try {
             f.get();
         } catch (malformed_sstable_exception& e) {
@@ -2105,8 +2412,8 @@ database::database(const db::config& cfg, database_config dbcfg)
     , _cfg(std::make_unique<db::config>(cfg))
     // Allow system tables a pool of 10 MB memory to write, but never block on other regions.
     , _system_dirty_memory_manager(*this, 10 << 20, cfg.virtual_dirty_soft_limit())
-    , _dirty_memory_manager(*this, memory::stats().total_memory() * 0.45, cfg.virtual_dirty_soft_limit())
-    , _streaming_dirty_memory_manager(*this, memory::stats().total_memory() * 0.10, cfg.virtual_dirty_soft_limit())
+    , _dirty_memory_manager(*this, memory::stats().total_memory() * 0.45, cfg.virtual_dirty_soft_limit(), cfg.memtable_flush_writers())
+    , _streaming_dirty_memory_manager(*this, memory::stats().total_memory() * 0.10, cfg.virtual_dirty_soft_limit(), cfg.memtable_flush_writers())
     , _dbcfg(dbcfg)
     , _memtable_controller(make_flush_controller(*_cfg, dbcfg.memtable_scheduling_group, service::get_local_memtable_flush_priority(), [this, limit = float(_dirty_memory_manager.throttle_threshold())] {
         return (_dirty_memory_manager.virtual_dirty_memory()) / limit;
@@ -2139,7 +2446,25 @@ database::database(const db::config& cfg, database_config dbcfg)
     }))
 {
     local_schema_registry().init(*this); // TODO: we're never unbound.
+    if (cfg.enable_cache_admission_filter()) {
+        // Assume partitions occupy at least 4k of cache on average.
+        global_cache_tracker().enable_admission_filter(std::max<size_t>(memory::stats().total_memory() / 4096, 1024));
+    } else {
+        global_cache_tracker().disable_admission_filter();
+    }
     _compaction_manager->start();
+    auto index_summary_capacity = cfg.index_summary_capacity_in_mb()
+            ? size_t(cfg.index_summary_capacity_in_mb()) * 1024 * 1024 / smp::count
+            : size_t(memory::stats().total_memory() * 0.05);
+    _index_summary_manager = std::make_unique<sstables::index_summary_manager>(index_summary_capacity,
+            std::chrono::minutes(cfg.index_summary_resize_interval_in_minutes()), [this] {
+        std::vector<sstables::shared_sstable> sstables;
+        for (auto& cf : _column_families | boost::adaptors::map_values) {
+            auto cf_sstables = cf->get_sstables();
+            sstables.insert(sstables.end(), cf_sstables->begin(), cf_sstables->end());
+        }
+        return sstables;
+    });
     setup_metrics();
 
     dblog.info("Row: max_vector_size: {}, internal_count: {}", size_t(row::max_vector_size), size_t(row::internal_count));
@@ -2181,6 +2506,9 @@ dirty_memory_manager::setup_collectd(sstring namestr) {
 
         sm::make_gauge(namestr +"_virtual_dirty_bytes", [this] { return virtual_dirty_memory(); },
                        sm::description("Holds the size of used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
+
+        sm::make_gauge(namestr + "_concurrent_flushes", [this] { return concurrent_flushes(); },
+                       sm::description("Holds the number of memtables whose data is being written to sstables right now.")),
     });
 }
 
@@ -2242,6 +2570,12 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_derive("reads_bypassing_cache", _cf_stats.reads_bypassing_cache,
+                       sm::description("Counts reads of tables with cache enabled which read directly from sstables because the query specified BYPASS CACHE.")),
+
+        sm::make_derive("coalesced_reads", _cf_stats.coalesced_reads,
+                       sm::description("Counts single-partition queries which shared the result of an identical query, running or just completed, instead of reading.")),
+
         sm::make_derive("total_writes", _stats->total_writes,
                        sm::description("Counts the total number of successful write operations performed by this shard.")),
 
@@ -2345,6 +2679,7 @@ future<> distributed_loader::populate_keyspace(distributed<database>& db, sstrin
         dblog.info("Populating Keyspace {}", ks_name);
         auto& ks = i->second;
         auto& column_families = db.local().get_column_families();
+        auto start = db_clock::now();
 
         return parallel_for_each(ks.metadata()->cf_meta_data() | boost::adaptors::map_values,
             [ks_name, &ks, &column_families, &db] (schema_ptr s) {
@@ -2363,17 +2698,27 @@ future<> distributed_loader::populate_keyspace(distributed<database>& db, sstrin
                                 ks_name, cfname, sstdir, eptr);
                     throw std::runtime_error(msg.c_str());
                 });
+            }).then([ks_name, start] {
+                dblog.info("Populated Keyspace {} in {} ms", ks_name,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(db_clock::now() - start).count());
             });
     }
 }
 
+// Keyspaces are populated in parallel. How many sstables are loaded at once is
+// bounded on each shard by database::sstable_load_concurrency_sem().
 static future<> populate(distributed<database>& db, sstring datadir) {
-    return lister::scan_dir(datadir, { directory_entry_type::directory }, [&db] (lister::path datadir, directory_entry de) {
-        auto& ks_name = de.name;
-        if (is_system_keyspace(ks_name)) {
+    return do_with(std::vector<sstring>(), [&db, datadir] (std::vector<sstring>& ks_names) {
+        return lister::scan_dir(datadir, { directory_entry_type::directory }, [&ks_names] (lister::path datadir, directory_entry de) {
+            if (!is_system_keyspace(de.name)) {
+                ks_names.push_back(de.name);
+            }
             return make_ready_future<>();
-        }
-        return distributed_loader::populate_keyspace(db, datadir.native(), ks_name);
+        }).then([&db, &ks_names, datadir] {
+            return parallel_for_each(ks_names, [&db, datadir] (const sstring& ks_name) {
+                return distributed_loader::populate_keyspace(db, datadir, ks_name);
+            });
+        });
     });
 }
 
@@ -2506,7 +2851,10 @@ future<> distributed_loader::init_non_system_keyspaces(distributed<database>& db
         }).get();
 
         const auto& cfg = db.local().get_config();
+        auto start = db_clock::now();
         populate(db, cfg.data_file_directories()[0]).get();
+        dblog.info("Populated non-system keyspaces in {} ms",
+                std::chrono::duration_cast<std::chrono::milliseconds>(db_clock::now() - start).count());
     });
 }
 
@@ -2787,6 +3135,11 @@ keyspace::make_column_family_config(const schema& s, const db::config& db_config
     cfg.commitlog_scheduling_group = _config.commitlog_scheduling_group;
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
     cfg.large_partition_warning_threshold_bytes = db_config.compaction_large_partition_warning_threshold_mb()*1024*1024;
+    cfg.compaction_fragment_size = uint64_t(db_config.compaction_fragment_size_in_mb())*1024*1024;
+    cfg.major_compaction_parallelism = std::max(db_config.major_compaction_parallelism(), 1U);
+    cfg.offstrategy_compaction_delay = std::chrono::seconds(db_config.offstrategy_compaction_delay_in_s());
+    cfg.enable_read_coalescing = db_config.enable_read_coalescing();
+    cfg.read_coalescing_window = std::chrono::milliseconds(db_config.read_coalescing_window_in_ms());
 
     return cfg;
 }
@@ -2998,21 +3351,158 @@ struct query_state {
     }
 };
 
+static bool equal_slices(const query::partition_slice& a, const query::partition_slice& b) {
+    // Keys with different representations are treated as different, which only
+    // makes us miss a chance to coalesce.
+    auto key_cmp = [] (const clustering_key_prefix& k1, const clustering_key_prefix& k2) {
+        return k1.view().representation() == k2.view().representation() ? 0 : 1;
+    };
+    return a.options.mask() == b.options.mask()
+        && a.static_columns == b.static_columns
+        && a.regular_columns == b.regular_columns
+        && a.cql_format() == b.cql_format()
+        && a.partition_row_limit() == b.partition_row_limit()
+        && boost::equal(a.filters(), b.filters(), [] (const query::column_filter& f1, const query::column_filter& f2) {
+            return f1.column == f2.column && f1.op == f2.op && f1.value == f2.value;
+        })
+        && !a.get_specific_ranges() && !b.get_specific_ranges()
+        && boost::equal(a.default_row_ranges(), b.default_row_ranges(), [&] (const query::clustering_range& r1, const query::clustering_range& r2) {
+            return r1.equal(r2, key_cmp);
+        });
+}
+
+bool column_family::coalesced_read::matches(const query::read_command& cmd, query::result_options o, uint64_t max_size) const {
+    return schema_version == cmd.schema_version
+        && opts.request == o.request
+        && opts.digest_algo == o.digest_algo
+        && row_limit == cmd.row_limit
+        && partition_limit == cmd.partition_limit
+        && max_result_size == max_size
+        && equal_slices(slice, cmd.slice);
+}
+
 future<lw_shared_ptr<query::result>>
 column_family::query(schema_ptr s, const query::read_command& cmd, query::result_options opts,
                      const dht::partition_range_vector& partition_ranges,
                      tracing::trace_state_ptr trace_state, query::result_memory_limiter& memory_limiter,
                      uint64_t max_size, db::timeout_clock::time_point timeout) {
+    auto coalescable = _config.enable_read_coalescing
+            && partition_ranges.size() == 1
+            && partition_ranges.front().is_singular()
+            && partition_ranges.front().start()->value().has_key()
+            && !cmd.slice.get_specific_ranges();
+    if (!coalescable) {
+        return do_query(std::move(s), cmd, opts, partition_ranges, std::move(trace_state), memory_limiter, max_size, timeout);
+    }
+
+    auto key = to_bytes(partition_ranges.front().start()->value().key()->view().representation());
+    auto& reads = _coalesced_reads[key];
+    auto now = lowres_clock::now();
+    auto it = boost::find_if(reads, [&] (const lw_shared_ptr<coalesced_read>& r) {
+        return (!r->expiry || *r->expiry > now) && r->matches(cmd, opts, max_size);
+    });
+    if (it != reads.end()) {
+        ++_config.cf_stats->coalesced_reads;
+        tracing::trace(trace_state, "Sharing the result of an identical read");
+        return (*it)->result.get_future();
+    }
+
+    auto f = do_query(std::move(s), cmd, opts, partition_ranges, std::move(trace_state), memory_limiter, max_size, timeout).then([] (lw_shared_ptr<query::result> r) {
+        // The result may be used concurrently from other shards, which must not have to
+        // compute the counts lazily.
+        r->ensure_counts();
+        return r;
+    });
+    auto read = make_lw_shared<coalesced_read>(coalesced_read{cmd.schema_version, cmd.slice, opts, cmd.row_limit, cmd.partition_limit, max_size,
+            shared_future<lw_shared_ptr<query::result>>(std::move(f))});
+    reads.push_back(read);
+    read->result.get_future().then_wrapped([this, key = std::move(key), read] (future<lw_shared_ptr<query::result>> f) {
+        coalesced_read_completed(key, read, f.failed());
+        f.ignore_ready_future();
+    });
+    return read->result.get_future();
+}
+
+void column_family::coalesced_read_completed(const bytes& key, const lw_shared_ptr<coalesced_read>& read, bool failed) {
+    auto it = _coalesced_reads.find(key);
+    if (it == _coalesced_reads.end()) {
+        // invalidated by a write
+        return;
+    }
+    auto& reads = it->second;
+    if (failed || _config.read_coalescing_window == std::chrono::milliseconds(0)) {
+        reads.erase(boost::remove(reads, read), reads.end());
+        if (reads.empty()) {
+            _coalesced_reads.erase(it);
+        }
+        return;
+    }
+    read->expiry = lowres_clock::now() + _config.read_coalescing_window;
+    if (!_coalesced_reads_expiry_timer.armed()) {
+        _coalesced_reads_expiry_timer.arm(*read->expiry);
+    }
+}
+
+void column_family::invalidate_coalesced_reads(bytes_view key) {
+    if (!_coalesced_reads.empty()) {
+        _coalesced_reads.erase(to_bytes(key));
+    }
+}
+
+void column_family::invalidate_coalesced_reads() noexcept {
+    _coalesced_reads.clear();
+}
+
+void column_family::expire_coalesced_reads() {
+    auto now = lowres_clock::now();
+    stdx::optional<lowres_clock::time_point> next_expiry;
+    for (auto it = _coalesced_reads.begin(); it != _coalesced_reads.end();) {
+        auto& reads = it->second;
+        reads.erase(boost::remove_if(reads, [&] (const lw_shared_ptr<coalesced_read>& r) {
+            if (!r->expiry) {
+                return false;
+            }
+            if (*r->expiry <= now) {
+                return true;
+            }
+            next_expiry = next_expiry ? std::min(*next_expiry, *r->expiry) : *r->expiry;
+            return false;
+        }), reads.end());
+        it = reads.empty() ? _coalesced_reads.erase(it) : std::next(it);
+    }
+    if (next_expiry) {
+        _coalesced_reads_expiry_timer.arm(*next_expiry);
+    }
+}
+
+future<lw_shared_ptr<query::result>>
+column_family::do_query(schema_ptr s, const query::read_command& cmd, query::result_options opts,
+                     const dht::partition_range_vector& partition_ranges,
+                     tracing::trace_state_ptr trace_state, query::result_memory_limiter& memory_limiter,
+                     uint64_t max_size, db::timeout_clock::time_point timeout) {
     utils::latency_counter lc;
     _stats.reads.set_latency(lc);
     auto f = opts.request == query::result_request::only_digest
              ? memory_limiter.new_digest_read(max_size) : memory_limiter.new_data_read(max_size);
-    return f.then([this, lc, s = std::move(s), &cmd, opts, &partition_ranges, trace_state = std::move(trace_state), timeout] (query::result_memory_accounter accounter) mutable {
+    // Reading sstables newest first skips tombstones of the older ones, which the
+    // digest covers, so replicas could disagree about it.
+    auto newest_first = read_newest_first(opts.request == query::result_request::only_result);
+    auto source = mutation_source([this, newest_first] (schema_ptr s,
+                                   const dht::partition_range& range,
+                                   const query::partition_slice& slice,
+                                   const io_priority_class& pc,
+                                   tracing::trace_state_ptr trace_state,
+                                   streamed_mutation::forwarding fwd,
+                                   mutation_reader::forwarding fwd_mr) {
+        return this->make_reader(std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr, newest_first);
+    });
+    return f.then([this, lc, s = std::move(s), &cmd, opts, &partition_ranges, trace_state = std::move(trace_state), timeout,
+            source = std::move(source)] (query::result_memory_accounter accounter) mutable {
         auto qs_ptr = std::make_unique<query_state>(std::move(s), cmd, opts, partition_ranges, std::move(accounter));
         auto& qs = *qs_ptr;
-        return do_until(std::bind(&query_state::done, &qs), [this, &qs, trace_state = std::move(trace_state), timeout] {
+        return do_until(std::bind(&query_state::done, &qs), [this, &qs, trace_state = std::move(trace_state), timeout, source = std::move(source)] {
             auto&& range = *qs.current_partition_range++;
-            return data_query(qs.schema, as_mutation_source(), range, qs.cmd.slice, qs.remaining_rows(),
+            return data_query(qs.schema, source, range, qs.cmd.slice, qs.remaining_rows(),
                               qs.remaining_partitions(), qs.cmd.timestamp, qs.builder, trace_state,
                               timeout);
         }).then([qs_ptr = std::move(qs_ptr), &qs] {
@@ -3175,11 +3665,15 @@ void column_family::do_apply(db::rp_handle&& h, Args&&... args) {
 void
 column_family::apply(const mutation& m, db::rp_handle&& h) {
     do_apply(std::move(h), m);
+    invalidate_coalesced_reads(m.key().view().representation());
 }
 
 void
 column_family::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle&& h) {
     do_apply(std::move(h), m, m_schema);
+    if (!_coalesced_reads.empty()) {
+        invalidate_coalesced_reads(m.key(*m_schema).representation());
+    }
 }
 
 future<mutation> database::do_apply_counter_update(column_family& cf, const frozen_mutation& fm, schema_ptr m_schema,
@@ -3276,6 +3770,7 @@ db::replay_position column_family::set_low_replay_position_mark() {
 future<> dirty_memory_manager::shutdown() {
     _db_shutdown_requested = true;
     _should_flush.signal();
+    _flush_finished.broadcast();
     return std::move(_waiting_flush).then([this] {
         return _virtual_region_group.shutdown().then([this] {
             return _real_region_group.shutdown();
@@ -3314,6 +3809,7 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
 
 future<> dirty_memory_manager::flush_one(memtable_list& mtlist, flush_permit&& permit) {
     return mtlist.seal_active_memtable_immediate(std::move(permit)).then_wrapped([this, schema = mtlist.back()->schema()] (auto f) {
+        _flush_finished.broadcast();
         if (f.failed()) {
             dblog.error("Failed to flush memtable, {}:{}", schema->ks_name(), schema->cf_name());
         }
@@ -3347,10 +3843,23 @@ future<> dirty_memory_manager::flush_when_needed() {
                 // memtable. The advantage of doing this is that this is objectively the one that will
                 // release the biggest amount of memory and is less likely to be generating tiny
                 // SSTables.
-                memtable& candidate_memtable = memtable::from_region(*(this->_virtual_region_group.get_largest_region()));
-                // Do not wait. The semaphore will protect us against a concurrent flush. But we
-                // want to start a new one as soon as the permits are destroyed and the semaphore is
-                // made ready again, not when we are done with the current one.
+                //
+                // A memtable which is being flushed keeps its region until the flush is done, so only
+                // consider the active memtables. Sealing an empty one would free nothing.
+                auto candidate = this->_virtual_region_group.get_largest_region([] (logalloc::region& r) {
+                    auto& mt = memtable::from_region(r);
+                    return &mt.get_memtable_list()->active_memtable() == &mt && !mt.empty();
+                });
+                if (!candidate) {
+                    // All the dirty memory belongs to memtables which are already being flushed, be it
+                    // by us or explicitly. Wait for one of those flushes to finish rather than look for
+                    // a candidate again. Our permit is released meanwhile.
+                    return _flush_finished.wait();
+                }
+                memtable& candidate_memtable = memtable::from_region(*candidate);
+                // Do not wait. The semaphore will protect us against too many concurrent flushes. But
+                // we want to start a new one as soon as a permit is destroyed and the semaphore is
+                // made ready again, not when we are done with the current ones.
                 this->flush_one(*(candidate_memtable.get_memtable_list()), std::move(permit));
                 return make_ready_future<>();
             });
@@ -3621,7 +4130,9 @@ schema_ptr database::find_indexed_table(const sstring& ks_name, const sstring& i
 
 future<>
 database::stop() {
-    return _compaction_manager->stop().then([this] {
+    return _index_summary_manager->stop().then([this] {
+        return _compaction_manager->stop();
+    }).then([this] {
         // try to ensure that CL has done disk flushing
         if (_commitlog != nullptr) {
             return _commitlog->shutdown();
@@ -3631,6 +4142,9 @@ database::stop() {
         return parallel_for_each(_column_families, [this] (auto& val_pair) {
             return val_pair.second->stop();
         });
+    }).then([this] {
+        // Column families were stopped, so loading of the filters stops too.
+        return std::move(_deferred_filters_loaded);
     }).then([this] {
         if (_commitlog != nullptr) {
             return _commitlog->release();
@@ -3649,6 +4163,17 @@ database::stop() {
     });
 }
 
+void database::load_deferred_filters() {
+    auto start = db_clock::now();
+    auto cfs = boost::copy_range<std::vector<lw_shared_ptr<column_family>>>(_column_families | boost::adaptors::map_values);
+    _deferred_filters_loaded = parallel_for_each(std::move(cfs), [this] (lw_shared_ptr<column_family> cf) {
+        return cf->load_deferred_filters(_sstable_load_concurrency_sem).finally([cf] {});
+    }).then([start] {
+        dblog.info("Loaded deferred sstable filters in {} ms",
+                std::chrono::duration_cast<std::chrono::milliseconds>(db_clock::now() - start).count());
+    });
+}
+
 future<> database::flush_all_memtables() {
     return parallel_for_each(_column_families, [this] (auto& cfp) {
         return cfp.second->flush();
@@ -4042,7 +4567,7 @@ future<> column_family::flush_streaming_mutations(utils::UUID plan_id, dht::part
                     // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
                     for (auto&& sst : sstables) {
                         // seal_active_streaming_memtable_big() ensures sst is unshared.
-                        this->add_sstable(sst.sstable, {engine().cpu_id()});
+                        this->add_maintenance_sstable(sst.sstable, {engine().cpu_id()});
                     }
                     this->try_trigger_compaction();
                 }, std::move(ranges));
@@ -4094,6 +4619,7 @@ future<> column_family::clear() {
     _streaming_memtables->clear();
     _streaming_memtables->add_memtable();
     _streaming_memtables_big.clear();
+    invalidate_coalesced_reads();
     return _cache.invalidate([] { /* There is no underlying mutation source */ });
 }
 
@@ -4129,11 +4655,13 @@ future<db::replay_position> column_family::discard_sstables(db_clock::time_point
             }
         };
         auto p = make_lw_shared<pruner>(*this);
+        invalidate_coalesced_reads();
         return _cache.invalidate([p, truncated_at] {
             p->prune(truncated_at);
             dblog.debug("cleaning out row cache");
         }).then([this, p]() mutable {
             return parallel_for_each(p->remove, [this](sstables::shared_sstable s) {
+                _maintenance_sstables.erase(s);
                 _compaction_strategy.get_backlog_tracker().remove_sstable(s);
                 return sstables::delete_atomically({s});
             }).then([p] {
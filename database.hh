@@ -72,6 +72,7 @@
 #include "sstables/sstable_set.hh"
 #include "sstables/progress_monitor.hh"
 #include "sstables/version.hh"
+#include "sstables/index_summary_manager.hh"
 #include <seastar/core/rwlock.hh>
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/metrics_registration.hh>
@@ -271,6 +272,12 @@ struct cf_stats {
     int64_t clustering_filter_fast_path_count = 0;
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
+
+    // number of reads which skipped the cache because the query asked for it
+    int64_t reads_bypassing_cache = 0;
+
+    // number of queries which shared the result of an identical query instead of reading
+    int64_t coalesced_reads = 0;
 };
 
 class cache_temperature {
@@ -289,6 +296,7 @@ class cache_temperature {
 
 class column_family : public enable_lw_shared_from_this<column_family> {
 public:
+    using read_newest_first = bool_class<class read_newest_first_tag>;
     struct config {
         sstring datadir;
         bool enable_disk_writes = true;
@@ -309,6 +317,18 @@ class column_family : public enable_lw_shared_from_this<column_family> {
         seastar::scheduling_group streaming_scheduling_group;
         bool enable_metrics_reporting = false;
         uint64_t large_partition_warning_threshold_bytes = std::numeric_limits<uint64_t>::max();
+        // Size of the fragments written by incremental compaction, 0 if disabled.
+        uint64_t compaction_fragment_size = 0;
+        // Number of sub-ranges compacted in parallel by major and cleanup compactions.
+        unsigned major_compaction_parallelism = 1;
+        // How long sstables written by streaming or loaded by refresh wait for more to arrive
+        // before they're compacted off-strategy, 0 if they're subject to regular compaction
+        // right away.
+        std::chrono::seconds offstrategy_compaction_delay{0};
+        // Whether identical single-partition queries share the result of one read,
+        // and for how long after it completes.
+        bool enable_read_coalescing = false;
+        std::chrono::milliseconds read_coalescing_window{0};
     };
     struct no_commitlog {};
     struct stats {
@@ -321,6 +341,16 @@ class column_family : public enable_lw_shared_from_this<column_family> {
         int64_t live_sstable_count = 0;
         /** Estimated number of compactions pending for this column family */
         int64_t pending_compactions = 0;
+        /** Totals of the compactions completed for this column family */
+        int64_t compactions_completed = 0;
+        int64_t compaction_bytes_read = 0;
+        int64_t compaction_bytes_written = 0;
+        int64_t compaction_partitions_read = 0;
+        int64_t compaction_partitions_written = 0;
+        /** Partitions which compaction read from more than one sstable */
+        int64_t compaction_partitions_merged = 0;
+        int64_t compaction_purged_tombstones = 0;
+        int64_t compaction_time_ms = 0;
         utils::timed_rate_moving_average_and_histogram reads{256};
         utils::timed_rate_moving_average_and_histogram writes{256};
         utils::estimated_histogram estimated_read;
@@ -416,6 +446,13 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     // but for correct compaction we need to start the compaction only after
     // reading all sstables.
     std::unordered_map<uint64_t, sstables::shared_sstable> _sstables_need_rewrite;
+    // sstables written by streaming and repair, or loaded by refresh. They're read like
+    // the others, but are kept out of regular compaction, which would otherwise be
+    // swamped by many small overlapping sstables. Instead, off-strategy compaction
+    // reshapes them on their own, once no new ones arrived for a while, and only then
+    // they join the others.
+    std::unordered_set<sstables::shared_sstable> _maintenance_sstables;
+    timer<> _offstrategy_compaction_timer{[this] { on_offstrategy_compaction_timer(); }};
     // Control background fibers waiting for sstables to be deleted
     seastar::gate _sstable_deletion_gate;
     // There are situations in which we need to stop writing sstables. Flushers will take
@@ -460,7 +497,41 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     double _cached_percentile = -1;
     lowres_clock::time_point _percentile_cache_timestamp;
     std::chrono::milliseconds _percentile_cache_value;
+
+    // A single-partition data query, running or completed within the coalescing
+    // window, whose result is shared with identical queries arriving meanwhile.
+    struct coalesced_read {
+        table_schema_version schema_version;
+        query::partition_slice slice;
+        query::result_options opts;
+        uint32_t row_limit;
+        uint32_t partition_limit;
+        uint64_t max_result_size;
+        shared_future<lw_shared_ptr<query::result>> result;
+        // Engaged once the result is available.
+        stdx::optional<lowres_clock::time_point> expiry;
+
+        bool matches(const query::read_command& cmd, query::result_options opts, uint64_t max_result_size) const;
+    };
+    // Keyed by the representation of the partition key. Writes to a partition drop
+    // its entries, so that queries arriving after a write never see data older than it.
+    std::unordered_map<bytes, std::vector<lw_shared_ptr<coalesced_read>>> _coalesced_reads;
+    timer<lowres_clock> _coalesced_reads_expiry_timer{[this] { expire_coalesced_reads(); }};
 private:
+    future<lw_shared_ptr<query::result>> do_query(schema_ptr,
+        const query::read_command& cmd,
+        query::result_options opts,
+        const dht::partition_range_vector& ranges,
+        tracing::trace_state_ptr trace_state,
+        query::result_memory_limiter& memory_limiter,
+        uint64_t max_result_size,
+        db::timeout_clock::time_point timeout);
+    void coalesced_read_completed(const bytes& key, const lw_shared_ptr<coalesced_read>& read, bool failed);
+    void invalidate_coalesced_reads(bytes_view key);
+    // For data which doesn't come through the write path, such as sstables
+    // added by streaming, repair or refresh.
+    void invalidate_coalesced_reads() noexcept;
+    void expire_coalesced_reads();
     void update_stats_for_new_sstable(uint64_t disk_space_used_by_sstable, const std::vector<unsigned>& shards_for_the_sstable) noexcept;
     // Adds new sstable to the set of sstables
     // Doesn't update the cache. The cache must be synchronized in order for reads to see
@@ -469,10 +540,14 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     // Doesn't trigger compaction.
     // Strong exception guarantees.
     void add_sstable(sstables::shared_sstable sstable, const std::vector<unsigned>& shards_for_the_sstable);
+    // Like add_sstable(), but keeps the sstable out of regular compaction until off-strategy
+    // compaction is done with it, if enabled.
+    void add_maintenance_sstable(sstables::shared_sstable sstable, const std::vector<unsigned>& shards_for_the_sstable);
+    void on_offstrategy_compaction_timer();
     // returns an empty pointer if sstable doesn't belong to current shard.
     future<sstables::shared_sstable> open_sstable(sstables::foreign_sstable_open_info info, sstring dir,
         int64_t generation, sstables::sstable_version_types v, sstables::sstable_format_types f);
-    void load_sstable(sstables::shared_sstable& sstable, bool reset_level = false);
+    void load_sstable(sstables::shared_sstable& sstable, bool reset_level = false, bool maintenance = false);
     lw_shared_ptr<memtable> new_memtable();
     lw_shared_ptr<memtable> new_streaming_memtable();
     future<stop_iteration> try_flush_memtable_to_sstable(lw_shared_ptr<memtable> memt, sstable_write_permit&& permit);
@@ -488,13 +563,6 @@ class column_family : public enable_lw_shared_from_this<column_family> {
         _sstable_generation = std::max<uint64_t>(*_sstable_generation, generation /  smp::count + 1);
     }
 
-    uint64_t calculate_generation_for_new_table() {
-        assert(_sstable_generation);
-        // FIXME: better way of ensuring we don't attempt to
-        // overwrite an existing table.
-        return (*_sstable_generation)++ * smp::count + engine().cpu_id();
-    }
-
     // inverse of calculate_generation_for_new_table(), used to determine which
     // shard a sstable should be opened at.
     static int64_t calculate_shard_from_sstable_generation(int64_t sstable_generation) {
@@ -506,8 +574,10 @@ class column_family : public enable_lw_shared_from_this<column_family> {
         const std::vector<sstables::shared_sstable>& old_sstables);
 
     // Rebuilds the sstable set right away and schedule deletion of old sstables.
+    // New sstables of an off-strategy compaction replace the old ones among the
+    // maintenance sstables.
     void on_compaction_completion(const std::vector<sstables::shared_sstable>& new_sstables,
-        const std::vector<sstables::shared_sstable>& sstables_to_remove);
+        const std::vector<sstables::shared_sstable>& sstables_to_remove, bool offstrategy = false);
 
     void rebuild_statistics();
 
@@ -520,6 +590,9 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     // Caller needs to ensure that column_family remains live (FIXME: relax this).
     // The 'range' parameter must be live as long as the reader is used.
     // Mutations returned by the reader will all have given schema.
+    // With read_newest_first::yes, single row reads may skip sstables whose data
+    // is shadowed by newer ones, so the result is complete only for the columns
+    // selected by the slice and must not be used to populate the cache.
     flat_mutation_reader make_sstable_reader(schema_ptr schema,
                                         lw_shared_ptr<sstables::sstable_set> sstables,
                                         const dht::partition_range& range,
@@ -527,7 +600,19 @@ class column_family : public enable_lw_shared_from_this<column_family> {
                                         const io_priority_class& pc,
                                         tracing::trace_state_ptr trace_state,
                                         streamed_mutation::forwarding fwd,
-                                        mutation_reader::forwarding fwd_mr) const;
+                                        mutation_reader::forwarding fwd_mr,
+                                        read_newest_first newest_first = read_newest_first::no) const;
+
+    // Like make_reader(), but with read_newest_first::yes reads which bypass the cache may
+    // stop at the sstables the slice needs, see make_sstable_reader().
+    flat_mutation_reader make_reader(schema_ptr schema,
+            const dht::partition_range& range,
+            const query::partition_slice& slice,
+            const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state,
+            streamed_mutation::forwarding fwd,
+            mutation_reader::forwarding fwd_mr,
+            read_newest_first newest_first) const;
 
     snapshot_source sstables_as_snapshot_source();
     partition_presence_checker make_partition_presence_checker(lw_shared_ptr<sstables::sstable_set>);
@@ -538,6 +623,13 @@ class column_family : public enable_lw_shared_from_this<column_family> {
         return bool(_sstables_need_rewrite.size());
     }
 
+    uint64_t calculate_generation_for_new_table() {
+        assert(_sstable_generation);
+        // FIXME: better way of ensuring we don't attempt to
+        // overwrite an existing table.
+        return (*_sstable_generation)++ * smp::count + engine().cpu_id();
+    }
+
     sstring dir() const {
         return _config.datadir;
     }
@@ -665,6 +757,9 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     void start();
     future<> stop();
     future<> flush();
+    // Loads the filters of sstables whose filter loading was deferred when they
+    // were loaded at boot, no more than sem allows at a time.
+    future<> load_deferred_filters(semaphore& sem);
     future<> flush_streaming_mutations(utils::UUID plan_id, dht::partition_range_vector ranges = dht::partition_range_vector{});
     future<> fail_streaming_mutations(utils::UUID plan_id);
     future<> clear(); // discards memtable(s) without flushing them to disk.
@@ -706,6 +801,14 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     // It doesn't flush the current memtable first. It's just a ad-hoc method,
     // not a real compaction policy.
     future<> compact_all_sstables();
+    // Reshapes maintenance sstables according to the compaction strategy, and makes
+    // them subject to regular compaction.
+    future<> run_offstrategy_compaction();
+    // Number of token sub-ranges which major and cleanup compactions of this
+    // column family compact in parallel.
+    unsigned major_compaction_parallelism() const {
+        return _config.major_compaction_parallelism;
+    }
     // Compact all sstables provided in the vector.
     // If cleanup is set to true, compaction_sstables will run on behalf of a cleanup job,
     // meaning that irrelevant keys will be discarded.
@@ -738,6 +841,10 @@ class column_family : public enable_lw_shared_from_this<column_family> {
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
     std::vector<sstables::shared_sstable> candidates_for_compaction() const;
+    std::vector<sstables::shared_sstable> maintenance_sstables() const;
+    // Makes maintenance sstables, which off-strategy compaction is done with, subject
+    // to regular compaction.
+    void integrate_maintenance_sstables(const std::vector<sstables::shared_sstable>& sstables);
     std::vector<sstables::shared_sstable> sstables_need_rewrite() const;
     size_t sstables_count() const;
     std::vector<uint64_t> sstable_count_per_level() const;
@@ -1066,6 +1173,8 @@ struct database_config {
     seastar::scheduling_group commitlog_scheduling_group;
     seastar::scheduling_group query_scheduling_group;
     seastar::scheduling_group streaming_scheduling_group;
+    // Scheduling groups of the service levels, by name.
+    std::vector<std::pair<sstring, seastar::scheduling_group>> service_level_scheduling_groups;
 };
 
 // Policy for distributed<database>:
@@ -1116,6 +1225,7 @@ class database {
     reader_concurrency_semaphore _system_read_concurrency_sem;
 
     semaphore _sstable_load_concurrency_sem{max_concurrent_sstable_loads()};
+    future<> _deferred_filters_loaded = make_ready_future<>();
 
     concrete_execution_stage<future<lw_shared_ptr<query::result>>, column_family*, schema_ptr, const query::read_command&, query::result_options,
             const dht::partition_range_vector&, tracing::trace_state_ptr, query::result_memory_limiter&, uint64_t, db::timeout_clock::time_point> _data_query_stage;
@@ -1127,6 +1237,7 @@ class database {
     utils::UUID _version;
     // compaction_manager object is referenced by all column families of a database.
     std::unique_ptr<compaction_manager> _compaction_manager;
+    std::unique_ptr<sstables::index_summary_manager> _index_summary_manager;
     seastar::metrics::metric_groups _metrics;
     bool _enable_incremental_backups = false;
 
@@ -1178,6 +1289,9 @@ class database {
     }
 
     seastar::scheduling_group get_streaming_scheduling_group() const { return _dbcfg.streaming_scheduling_group; }
+    const std::vector<std::pair<sstring, seastar::scheduling_group>>& get_service_level_scheduling_groups() const {
+        return _dbcfg.service_level_scheduling_groups;
+    }
 
     compaction_manager& get_compaction_manager() {
         return *_compaction_manager;
@@ -1186,6 +1300,10 @@ class database {
         return *_compaction_manager;
     }
 
+    sstables::index_summary_manager& get_index_summary_manager() {
+        return *_index_summary_manager;
+    }
+
     void add_column_family(keyspace& ks, schema_ptr schema, column_family::config cfg);
     future<> add_column_family_and_make_directory(schema_ptr schema);
 
@@ -1296,6 +1414,8 @@ class database {
     semaphore& sstable_load_concurrency_sem() {
         return _sstable_load_concurrency_sem;
     }
+    // Starts loading, in the background, the sstable filters deferred during boot.
+    void load_deferred_filters();
     void register_connection_drop_notifier(netw::messaging_service& ms);
 
     db_stats& get_stats() {
@@ -1312,7 +1432,7 @@ class distributed_loader {
     static void reshard(distributed<database>& db, sstring ks_name, sstring cf_name);
     static future<> open_sstable(distributed<database>& db, sstables::entry_descriptor comps,
         std::function<future<> (column_family&, sstables::foreign_sstable_open_info)> func,
-        const io_priority_class& pc = default_priority_class());
+        const io_priority_class& pc = default_priority_class(), bool defer_filter = false);
     static future<> load_new_sstables(distributed<database>& db, sstring ks, sstring cf, std::vector<sstables::entry_descriptor> new_tables);
     static future<std::vector<sstables::entry_descriptor>> flush_upload_dir(distributed<database>& db, sstring ks_name, sstring cf_name);
     static future<sstables::entry_descriptor> probe_file(distributed<database>& db, sstring sstdir, sstring fname);
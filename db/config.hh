@@ -222,6 +222,18 @@ class config : public utils::config_file {
     val(compaction_large_partition_warning_threshold_mb, uint32_t, 1000, Used, \
             "Log a warning when compacting partitions larger than this value"   \
     )                                               \
+    val(compaction_fragment_size_in_mb, uint32_t, 1000, Used, \
+            "Size-tiered compactions split their output into a run of sstables of about this size, and delete each input sstable as soon as the output has moved past its last partition, rather than when the compaction finishes. This bounds the temporary disk space needed by a compaction to a small multiple of this size. Set to 0 to disable."   \
+    )                                               \
+    val(lazy_sstable_filter_loading, bool, true, Used, \
+            "When loading sstables at startup, don't read their bloom filters. They are read in the background once all sstables are loaded, and until then every partition is looked up in the sstable index. Speeds up startup of nodes with many sstables."   \
+    )                                               \
+    val(major_compaction_parallelism, uint32_t, 4, Used, \
+            "Major and cleanup compactions split the token range of their input into up to this many disjoint sub-ranges, about equal in size, and compact them in parallel, each into its own non-overlapping output. Set to 1 to disable."   \
+    )                                               \
+    val(offstrategy_compaction_delay_in_s, uint32_t, 60, Used, \
+            "Sstables written by streaming and repair, or loaded by refresh, are kept out of regular compaction, which would be swamped by many small overlapping sstables. Once none arrived for this many seconds, they are compacted on their own, reshaped according to the compaction strategy, and only then join the other sstables. Set to 0 to disable."   \
+    )                                               \
     /* Common memtable settings */  \
     val(memtable_total_space_in_mb, uint32_t, 0, Invalid,     \
             "Specifies the total memory used for all memtables on a node. This replaces the per-table storage settings memtable_operations_in_millions and memtable_throughput_in_mb."  \
@@ -311,8 +323,8 @@ class config : public utils::config_file {
             "The number of full memtables to allow pending flush (memtables waiting for a write thread). At a minimum, set to the maximum number of indexes created on a single table.\n"  \
             "Related information: Flushing data from the memtable"  \
     )   \
-    val(memtable_flush_writers, uint32_t, 1, Invalid,     \
-            "Sets the number of memtable flush writer threads. These threads are blocked by disk I/O, and each one holds a memtable in memory while blocked. If you have a large Java heap size and many data directories, you can increase the value for better flush performance."  \
+    val(memtable_flush_writers, uint32_t, 2, Used,     \
+            "Sets the number of memtables each shard may write to sstables concurrently, across all tables. A memtable's memory is only released once its flush completes, so higher values keep the disk busier under heavy write load at the cost of releasing memory later. Must be at least 1."  \
     )   \
     val(memtable_heap_space_in_mb, uint32_t, 0, Unused,     \
             "Total permitted memory to use for memtables. Triggers a flush based on memtable_cleanup_threshold. Cassandra stops accepting writes when the limit is exceeded until a flush completes. If unset, sets to default."  \
@@ -324,11 +336,11 @@ class config : public utils::config_file {
     val(column_index_size_in_kb, uint32_t, 64, Used,     \
             "Granularity of the index of rows within a partition. For huge rows, decrease this setting to improve seek time. If you use key cache, be careful not to make this setting too large because key cache will be overwhelmed. If you're unsure of the size of the rows, it's best to use the default setting."  \
     )   \
-    val(index_summary_capacity_in_mb, uint32_t, 0, Unused,     \
-            "Fixed memory pool size in MB for SSTable index summaries. If the memory usage of all index summaries exceeds this limit, any SSTables with low read rates shrink their index summaries to meet this limit. This is a best-effort process. In extreme conditions, Cassandra may need to use more than this amount of memory."  \
+    val(index_summary_capacity_in_mb, uint32_t, 0, Used,     \
+            "Fixed memory pool size in MB for SSTable index summaries, split evenly among shards. If the memory usage of all index summaries exceeds this limit, any SSTables with low read rates shrink their index summaries to meet this limit. This is a best-effort process. In extreme conditions, Scylla may need to use more than this amount of memory. If set to 0, 5% of the memory of each shard is used."  \
     )   \
-    val(index_summary_resize_interval_in_minutes, uint32_t, 60, Unused,     \
-            "How frequently index summaries should be re-sampled. This is done periodically to redistribute memory from the fixed-size pool to SSTables proportional their recent read rates. To disable, set to -1. This leaves existing index summaries at their current sampling level."  \
+    val(index_summary_resize_interval_in_minutes, uint32_t, 60, Used,     \
+            "How frequently index summaries should be re-sampled. This is done periodically to redistribute memory from the fixed-size pool to SSTables proportional their recent read rates. To disable, set to 0. This leaves existing index summaries at their current sampling level."  \
     )   \
     val(reduce_cache_capacity_to, double, .6, Invalid,     \
             "Sets the size percentage to which maximum cache capacity is reduced when Java heap usage reaches the threshold defined by reduce_cache_sizes_at. Together with flush_largest_memtables_at, these properties constitute an emergency measure for preventing sudden out-of-memory (OOM) errors."  \
@@ -697,6 +709,7 @@ class config : public utils::config_file {
     )                                                   \
     val(enable_in_memory_data_store, bool, false, Used, "Enable in memory mode (system tables are always persisted)") \
     val(enable_cache, bool, true, Used, "Enable cache") \
+    val(enable_cache_admission_filter, bool, true, Used, "Admit partitions read from sstables into the row cache only if they are accessed at least as frequently as the partitions they would displace. Protects the cache from being flushed by scans.") \
     val(enable_commitlog, bool, true, Used, "Enable commitlog") \
     val(volatile_system_keyspace_for_testing, bool, false, Used, "Don't persist system keyspace - testing only!") \
     val(api_port, uint16_t, 10000, Used, "Http Rest API port") \
@@ -735,6 +748,19 @@ class config : public utils::config_file {
     val(enable_sstable_data_integrity_check, bool, false, Used, "Enable interposer which checks for integrity of every sstable write." \
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.") \
     val(cpu_scheduler, bool, true, Used, "Enable cpu scheduling") \
+    val(service_levels, sstring, "", Used, "Comma separated list of service levels, as name:shares pairs, e.g. oltp:1000,analytics:200. " \
+        "Each service level runs the coordinator side of the CQL requests of its roles in a scheduling group of its own, with the given CPU shares. " \
+        "Requires cpu_scheduler; at most 8 service levels may be defined. Levels only govern the CPU time of the coordinator: " \
+        "replicas, including the coordinator's own, serve their part of a request like any other request, in the regular " \
+        "scheduling groups, reader concurrency semaphore and I/O priority classes.") \
+    val(role_service_levels, sstring, "", Used, "Comma separated list of role:service_level pairs attaching roles to the levels defined in service_levels. " \
+        "Requests of anonymous connections and of connections logged in as other roles run in the default scheduling group.") \
+    val(cql_load_shedding, bool, true, Used, "Reject QUERY, EXECUTE and BATCH requests with an Overloaded error when, given the number of requests " \
+        "in flight on the shard and its recent throughput, they are not expected to complete before the request timeout.") \
+    val(enable_read_coalescing, bool, true, Used, "Let identical single-partition reads arriving at a shard while one of them is running share its result " \
+        "instead of reading on their own. Writes to the partition end the sharing.") \
+    val(read_coalescing_window_in_ms, uint32_t, 5, Used, "How long, in milliseconds, the result of a coalesced read keeps being shared with identical reads " \
+        "after it completes, unless the partition is written to.") \
     /* done! */
 
 #define _make_value_member(name, type, deflt, status, desc, ...)    \
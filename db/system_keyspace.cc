@@ -93,7 +93,7 @@ api::timestamp_type schema_creation_timestamp() {
 
 // Increase whenever changing schema of any system table.
 // FIXME: Make automatic by calculating from schema structure.
-static const uint16_t version_sequence_number = 1;
+static const uint16_t version_sequence_number = 2;
 
 table_schema_version generate_schema_version(utils::UUID table_id) {
     md5_hasher h;
@@ -371,7 +371,11 @@ schema_ptr built_indexes() {
             {"columnfamily_name", utf8_type},
             {"compacted_at", timestamp_type},
             {"keyspace_name", utf8_type},
+            {"partitions_in", long_type},
+            {"partitions_out", long_type},
+            {"purged_tombstones", long_type},
             {"rows_merged", map_type_impl::get_instance(int32_type, long_type, true)},
+            {"started_at", timestamp_type},
         },
         // static columns
         {},
@@ -1694,21 +1698,22 @@ static map_type_impl::native_type prepare_rows_merged(std::unordered_map<int32_t
     return tmp;
 }
 
-future<> update_compaction_history(sstring ksname, sstring cfname, int64_t compacted_at, int64_t bytes_in, int64_t bytes_out,
-                                   std::unordered_map<int32_t, int64_t> rows_merged)
+future<> update_compaction_history(compaction_history_entry entry)
 {
     // don't write anything when the history table itself is compacted, since that would in turn cause new compactions
-    if (ksname == "system" && cfname == COMPACTION_HISTORY) {
+    if (entry.ks == "system" && entry.cf == COMPACTION_HISTORY) {
         return make_ready_future<>();
     }
 
     auto map_type = map_type_impl::get_instance(int32_type, long_type, true);
 
-    sstring req = sprint("INSERT INTO system.%s (id, keyspace_name, columnfamily_name, compacted_at, bytes_in, bytes_out, rows_merged) VALUES (?, ?, ?, ?, ?, ?, ?)"
+    sstring req = sprint("INSERT INTO system.%s (id, keyspace_name, columnfamily_name, started_at, compacted_at, bytes_in, bytes_out, "
+                    "partitions_in, partitions_out, purged_tombstones, rows_merged) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
                     , COMPACTION_HISTORY);
 
-    return execute_cql(req, utils::UUID_gen::get_time_UUID(), ksname, cfname, compacted_at, bytes_in, bytes_out,
-                       make_map_value(map_type, prepare_rows_merged(rows_merged))).discard_result();
+    return execute_cql(req, utils::UUID_gen::get_time_UUID(), entry.ks, entry.cf, entry.started_at, entry.compacted_at,
+                       entry.bytes_in, entry.bytes_out, entry.partitions_in, entry.partitions_out, entry.purged_tombstones,
+                       make_map_value(map_type, prepare_rows_merged(entry.rows_merged))).discard_result();
 }
 
 future<std::vector<compaction_history_entry>> get_compaction_history() {
@@ -1726,6 +1731,19 @@ future<std::vector<compaction_history_entry>> get_compaction_history() {
             if (row.has("rows_merged")) {
                 entry.rows_merged = row.get_map<int32_t, int64_t>("rows_merged");
             }
+            // Entries recorded by older versions lack the following.
+            if (row.has("started_at")) {
+                entry.started_at = row.get_as<int64_t>("started_at");
+            }
+            if (row.has("partitions_in")) {
+                entry.partitions_in = row.get_as<int64_t>("partitions_in");
+            }
+            if (row.has("partitions_out")) {
+                entry.partitions_out = row.get_as<int64_t>("partitions_out");
+            }
+            if (row.has("purged_tombstones")) {
+                entry.purged_tombstones = row.get_as<int64_t>("purged_tombstones");
+            }
             history.push_back(std::move(entry));
             return stop_iteration::no;
         }).then([&history]() {
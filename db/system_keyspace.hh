@@ -353,16 +353,20 @@ enum class bootstrap_state {
         utils::UUID id;
         sstring ks;
         sstring cf;
+        int64_t started_at = 0;
         int64_t compacted_at = 0;
         int64_t bytes_in = 0;
         int64_t bytes_out = 0;
+        int64_t partitions_in = 0;
+        int64_t partitions_out = 0;
+        int64_t purged_tombstones = 0;
         // Key: number of rows merged
         // Value: counter
         std::unordered_map<int32_t, int64_t> rows_merged;
     };
 
-    future<> update_compaction_history(sstring ksname, sstring cfname, int64_t compacted_at, int64_t bytes_in, int64_t bytes_out,
-                                       std::unordered_map<int32_t, int64_t> rows_merged);
+    // The id of the entry is generated.
+    future<> update_compaction_history(compaction_history_entry entry);
     future<std::vector<compaction_history_entry>> get_compaction_history();
 
     typedef std::vector<db::replay_position> replay_positions;
@@ -35,8 +35,13 @@ struct noop_hasher {
     std::array<uint8_t, 16> finalize_array() { return std::array<uint8_t, 16>(); };
 };
 
+// Like xx_hasher, but each row is fed as a single hash of its cells, which
+// cached rows keep precomputed (see row::prepare_hash()).
+struct row_hashing_xx_hasher : public xx_hasher {
+};
+
 class digester final {
-    std::variant<noop_hasher, md5_hasher, xx_hasher> _impl;
+    std::variant<noop_hasher, md5_hasher, xx_hasher, row_hashing_xx_hasher> _impl;
 
 public:
     explicit digester(digest_algorithm algo) {
@@ -47,6 +52,9 @@ class digester final {
         case digest_algorithm::xxHash:
             _impl = xx_hasher();
             break;
+        case digest_algorithm::xxHash_row_hashes:
+            _impl = row_hashing_xx_hasher();
+            break;
         case digest_algorithm ::none:
             _impl = noop_hasher();
             break;
@@ -75,4 +83,10 @@ using using_hash_of_hash = std::negation<std::disjunction<std::is_same<Hasher, m
 template<typename Hasher>
 inline constexpr bool using_hash_of_hash_v = using_hash_of_hash<Hasher>::value;
 
+template<typename Hasher>
+using using_row_hash = std::is_same<Hasher, row_hashing_xx_hasher>;
+
+template<typename Hasher>
+inline constexpr bool using_row_hash_v = using_row_hash<Hasher>::value;
+
 }
\ No newline at end of file
@@ -85,11 +85,14 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     // memory usage minus bytes that were already written to disk.
     logalloc::region_group _virtual_region_group;
 
-    // We would like to serialize the flushing of memtables. While flushing many memtables
+    // We would like to limit the concurrency of memtable flushes. While flushing many memtables
     // simultaneously can sustain high levels of throughput, the memory is not freed until the
     // memtable is totally gone. That means that if we have throttled requests, they will stay
     // throttled for a long time. Even when we have virtual dirty, that only provides a rough
-    // estimate, and we can't release requests that early.
+    // estimate, and we can't release requests that early. On the other hand, a single flush
+    // leaves the disk idle while it's serializing data, so we allow a few of them (see
+    // memtable_flush_writers) to overlap.
+    unsigned _max_concurrent_flushes;
     semaphore _flush_serializer;
     // We will accept a new flush before another one ends, once it is done with the data write.
     // That is so we can keep the disk always busy. But there is still some background work that is
@@ -100,6 +103,8 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     static constexpr unsigned _max_background_work = 20;
     semaphore _background_work_flush_serializer = { _max_background_work };
     condition_variable _should_flush;
+    // Signalled whenever a memtable flush finishes.
+    condition_variable _flush_finished;
     int64_t _dirty_bytes_released_pre_accounted = 0;
 
     future<> flush_when_needed();
@@ -149,19 +154,26 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
     //
     // We then set the soft limit to 80 % of the virtual dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(database& db, size_t threshold, double soft_limit)
+    //
+    // Concurrent flushes
+    // ------------------
+    // Up to max_concurrent_flushes memtables, possibly belonging to different tables, can be
+    // writing their data at the same time.
+    dirty_memory_manager(database& db, size_t threshold, double soft_limit, unsigned max_concurrent_flushes = 1)
         : logalloc::region_group_reclaimer(threshold / 2, threshold * soft_limit / 2)
         , _real_dirty_reclaimer(threshold)
         , _db(&db)
         , _real_region_group(_real_dirty_reclaimer)
         , _virtual_region_group(&_real_region_group, *this)
-        , _flush_serializer(1)
+        , _max_concurrent_flushes(std::max(max_concurrent_flushes, 1u))
+        , _flush_serializer(_max_concurrent_flushes)
         , _waiting_flush(flush_when_needed()) {}
 
     dirty_memory_manager() : logalloc::region_group_reclaimer()
         , _db(nullptr)
         , _real_region_group(_real_dirty_reclaimer)
         , _virtual_region_group(&_real_region_group, *this)
+        , _max_concurrent_flushes(1)
         , _flush_serializer(1)
         , _waiting_flush(make_ready_future<>()) {}
 
@@ -205,6 +217,11 @@ class dirty_memory_manager: public logalloc::region_group_reclaimer {
         return _virtual_region_group.memory_used();
     }
 
+    // Number of memtables whose data is being written right now.
+    unsigned concurrent_flushes() const {
+        return _max_concurrent_flushes - _flush_serializer.available_units();
+    }
+
     future<> flush_one(memtable_list& cf, flush_permit&& permit);
 
     future<flush_permit> get_flush_permit() {
@@ -32,7 +32,8 @@ class query_result stub [[writable]] {
 enum class digest_algorithm : uint8_t {
     none = 0,  // digest not required
     MD5 = 1,
-    xxHash = 2,// default algorithm
+    xxHash = 2,
+    xxHash_row_hashes = 3, // default algorithm, xxHash over one hash per row
 };
 
 }
@@ -30,6 +30,20 @@ class specific_ranges {
     std::vector<nonwrapping_range<clustering_key_prefix>> ranges();
 };
 
+enum class filter_operator : uint8_t {
+    eq,
+    lt,
+    lte,
+    gt,
+    gte,
+};
+
+class column_filter {
+    uint32_t column;
+    query::filter_operator op;
+    bytes value;
+};
+
 class partition_slice {
     std::vector<nonwrapping_range<clustering_key_prefix>> default_row_ranges();
     std::vector<uint32_t> static_columns;
@@ -38,6 +52,7 @@ class partition_slice {
     std::unique_ptr<query::specific_ranges> get_specific_ranges();
     cql_serialization_format cql_format();
     uint32_t partition_row_limit() [[version 1.3]] = std::numeric_limits<uint32_t>::max();
+    std::vector<query::column_filter> filters() [[version 2.2]];
 };
 
 class read_command {
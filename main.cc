@@ -33,6 +33,7 @@
 #include "service/storage_service.hh"
 #include "service/migration_manager.hh"
 #include "service/load_broadcaster.hh"
+#include "service/service_level.hh"
 #include "streaming/stream_session.hh"
 #include "db/system_keyspace.hh"
 #include "db/batchlog_manager.hh"
@@ -474,6 +475,11 @@ int main(int ac, char** av) {
             dbcfg.memtable_scheduling_group = make_sched_group("memtable", 1000);
             dbcfg.memtable_to_cache_scheduling_group = make_sched_group("memtable_to_cache", 200);
             dbcfg.commitlog_scheduling_group = make_sched_group("commitlog", 1000);
+            auto service_levels = service::parse_service_levels(cfg->service_levels());
+            service::parse_role_service_levels(cfg->role_service_levels(), service_levels); // validate early
+            for (auto&& sl : service_levels) {
+                dbcfg.service_level_scheduling_groups.emplace_back(sl.name, make_sched_group("sl:" + sl.name, sl.shares));
+            }
             db.start(std::ref(*cfg), dbcfg).get();
             engine().at_exit([&db, &return_value] {
                 // #293 - do not stop anything - not even db (for real)
@@ -590,6 +596,9 @@ int main(int ac, char** av) {
 
             supervisor::notify("loading sstables");
             distributed_loader::init_non_system_keyspaces(db, proxy).get();
+            db.invoke_on_all([] (database& db) {
+                db.load_deferred_filters();
+            }).get();
             // register connection drop notification to update cf's cache hit rate data
             db.invoke_on_all([] (database& db) {
                 db.register_connection_drop_notifier(netw::get_local_messaging_service());
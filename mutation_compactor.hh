@@ -22,6 +22,7 @@
 #pragma once
 
 #include "mutation_fragment.hh"
+#include "row_filter.hh"
 
 static inline bool has_ck_selector(const query::clustering_row_ranges& ranges) {
     // Like PK range, an empty row range, should be considered an "exclude all" restriction
@@ -30,6 +31,12 @@ static inline bool has_ck_selector(const query::clustering_row_ranges& ranges) {
     });
 }
 
+// Like has_ck_selector(), but also accounts for rows dropped by the
+// slice's column filters, which the data query path applies on the replica.
+static inline bool has_row_selector(const query::partition_slice& slice, const query::clustering_row_ranges& ranges) {
+    return !slice.filters().empty() || has_ck_selector(ranges);
+}
+
 enum class emit_only_live_rows {
     no,
     yes,
@@ -56,6 +63,10 @@ concept bool CompactedMutationsConsumer() {
     };
 }
 */
+// Consumers of compact_for_compaction also have to provide:
+//
+//   void on_tombstone_purged();
+//
 // emit_only_live::yes will cause compact_for_query to emit only live
 // static and clustering rows. It doesn't affect the way range tombstones are
 // emitted.
@@ -71,6 +82,7 @@ class compact_mutation {
     uint32_t _row_limit{};
     uint32_t _partition_limit{};
     uint32_t _partition_row_limit{};
+    query::row_filter _filter;
 
     CompactedMutationsConsumer _consumer;
     range_tombstone_accumulator _range_tombstones;
@@ -120,6 +132,13 @@ class compact_mutation {
         }
         return t.timestamp < _max_purgeable;
     };
+
+    // Lets consumers of sstable compaction account for purged tombstones.
+    void on_tombstone_purged() {
+        if constexpr (sstable_compaction()) {
+            _consumer.on_tombstone_purged();
+        }
+    }
 public:
     compact_mutation(compact_mutation&&) = delete; // Because 'this' is captured
 
@@ -133,6 +152,8 @@ class compact_mutation {
         , _row_limit(limit)
         , _partition_limit(partition_limit)
         , _partition_row_limit(_slice.options.contains(query::partition_slice::option::distinct) ? 1 : slice.partition_row_limit())
+        // Mutation queries feed reconciliation, which must see every row.
+        , _filter(only_live() ? query::row_filter(s, slice) : query::row_filter())
         , _consumer(std::move(consumer))
         , _range_tombstones(s, _slice.options.contains(query::partition_slice::option::reversed))
     {
@@ -157,7 +178,7 @@ class compact_mutation {
     void consume_new_partition(const dht::decorated_key& dk) {
         auto& pk = dk.key();
         _dk = &dk;
-        _has_ck_selector = has_ck_selector(_slice.row_ranges(_schema, pk));
+        _has_ck_selector = !_filter.empty() || has_ck_selector(_slice.row_ranges(_schema, pk));
         _empty_partition = true;
         _rows_in_current_partition = 0;
         _static_row_live = false;
@@ -170,6 +191,8 @@ class compact_mutation {
         _range_tombstones.set_partition_tombstone(t);
         if (!only_live() && !can_purge_tombstone(t)) {
             partition_is_not_empty();
+        } else if (t) {
+            on_tombstone_purged();
         }
     }
 
@@ -189,13 +212,19 @@ class compact_mutation {
     stop_iteration consume(clustering_row&& cr) {
         auto current_tombstone = _range_tombstones.tombstone_for_row(cr.key());
         auto t = cr.tomb();
-        if (t.tomb() <= current_tombstone || can_purge_tombstone(t)) {
+        if (t.tomb() <= current_tombstone) {
+            cr.remove_tombstone();
+        } else if (can_purge_tombstone(t)) {
             cr.remove_tombstone();
+            on_tombstone_purged();
         }
         t.apply(current_tombstone);
         bool is_live = cr.marker().compact_and_expire(t.tomb(), _query_time, _can_gc, _gc_before);
         is_live |= cr.cells().compact_and_expire(_schema, column_kind::regular_column, t, _query_time, _can_gc, _gc_before);
         if (only_live() && is_live) {
+            if (!_filter(cr.cells())) {
+                return stop_iteration::no;
+            }
             partition_is_not_empty();
             auto stop = _consumer.consume(std::move(cr), t, true);
             if (++_rows_in_current_partition == _current_partition_limit) {
@@ -219,7 +248,9 @@ class compact_mutation {
     stop_iteration consume(range_tombstone&& rt) {
         _range_tombstones.apply(rt);
         // FIXME: drop tombstone if it is fully covered by other range tombstones
-        if (!can_purge_tombstone(rt.tomb) && rt.tomb > _range_tombstones.get_partition_tombstone()) {
+        if (can_purge_tombstone(rt.tomb)) {
+            on_tombstone_purged();
+        } else if (rt.tomb > _range_tombstones.get_partition_tombstone()) {
             partition_is_not_empty();
             return _consumer.consume(std::move(rt));
         }
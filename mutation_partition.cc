@@ -641,10 +641,54 @@ struct max_timestamp {
     }
 };
 
+static cell_hash hash_of(const cell_and_hash& c_a_h, const column_definition& def) {
+    if (c_a_h.hash) {
+        return *c_a_h.hash;
+    }
+    query::default_hasher cellh;
+    feed_hash(cellh, c_a_h.cell, def);
+    return cell_hash{cellh.finalize_uint64()};
+}
+
+static api::timestamp_type max_timestamp_of(const cell_and_hash& c_a_h, const column_definition& def) {
+    if (def.is_atomic()) {
+        return c_a_h.cell.as_atomic_cell().timestamp();
+    }
+    auto&& ctype = static_pointer_cast<const collection_type_impl>(def.type);
+    return ctype->last_update(c_a_h.cell.as_collection_mutation());
+}
+
+// Returns true iff columns selects all columns of given kind, in column_id order,
+// so that the row hash computed by row::prepare_hash() can stand for the selected cells.
+static bool selects_all_columns(const schema& s, column_kind kind, const std::vector<column_id>& columns) {
+    auto count = kind == column_kind::static_column ? s.static_columns_count() : s.regular_columns_count();
+    return columns.size() == count && std::is_sorted(columns.begin(), columns.end());
+}
+
 template<>
 struct appending_hash<row> {
     template<typename Hasher>
     void operator()(Hasher& h, const row& cells, const schema& s, column_kind kind, const std::vector<column_id>& columns, max_timestamp& max_ts) const {
+        if constexpr (query::using_row_hash_v<Hasher>) {
+            if (cells.row_hash() && selects_all_columns(s, kind, columns)) {
+                feed_hash(h, *cells.row_hash());
+                max_ts.update(cells.row_max_timestamp());
+                return;
+            }
+            query::default_hasher rowh;
+            for (auto id : columns) {
+                const cell_and_hash* cell_and_hash = cells.find_cell_and_hash(id);
+                if (!cell_and_hash) {
+                    continue;
+                }
+                auto&& def = s.column_at(kind, id);
+                max_ts.update(max_timestamp_of(*cell_and_hash, def));
+                feed_hash(rowh, id);
+                feed_hash(rowh, hash_of(*cell_and_hash, def));
+            }
+            feed_hash(h, cell_hash{rowh.finalize_uint64()});
+            return;
+        }
         for (auto id : columns) {
             const cell_and_hash* cell_and_hash = cells.find_cell_and_hash(id);
             if (!cell_and_hash) {
@@ -697,13 +741,22 @@ cell_hash_opt row::cell_hash_for(column_id id) const {
 
 void row::prepare_hash(const schema& s, column_kind kind) const {
     // const to avoid removing const qualifiers on the read path
-    for_each_cell([&s, kind] (column_id id, const cell_and_hash& c_a_h) {
+    if (_row_hash) {
+        return;
+    }
+    query::default_hasher rowh;
+    max_timestamp max_ts;
+    for_each_cell([&s, kind, &rowh, &max_ts] (column_id id, const cell_and_hash& c_a_h) {
+        auto&& def = s.column_at(kind, id);
         if (!c_a_h.hash) {
-            query::default_hasher cellh;
-            feed_hash(cellh, c_a_h.cell, s.column_at(kind, id));
-            c_a_h.hash = cell_hash{cellh.finalize_uint64()};
+            c_a_h.hash = hash_of(c_a_h, def);
         }
+        max_ts.update(max_timestamp_of(c_a_h, def));
+        feed_hash(rowh, id);
+        feed_hash(rowh, *c_a_h.hash);
     });
+    _row_hash = cell_hash{rowh.finalize_uint64()};
+    _row_max_timestamp = max_ts.max;
 }
 
 template<typename RowWriter>
@@ -798,8 +851,22 @@ mutation_partition::query_compacted(query::result::partition_writer& pw, const s
 
     auto is_reversed = slice.options.contains(query::partition_slice::option::reversed);
     auto send_ck = slice.options.contains(query::partition_slice::option::send_clustering_key);
+    auto count_rows = slice.options.contains(query::partition_slice::option::count_rows);
+    auto write_row = [&] (const rows_entry& e) {
+        auto cells_wr = [&] {
+            if (send_ck) {
+                return rows_wr.add().write_key(e.key()).start_cells().start_cells();
+            } else {
+                return rows_wr.add().skip_key().start_cells().start_cells();
+            }
+        }();
+        get_compacted_row_slice(s, slice, column_kind::regular_column, e.row().cells(), slice.regular_columns, cells_wr);
+        std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
+    };
+    const rows_entry* last_row = nullptr;
+    query::row_filter filter(s, slice);
     for_each_row(s, query::clustering_range::make_open_ended_both_sides(), is_reversed, [&] (const rows_entry& e) {
-        if (e.dummy()) {
+        if (e.dummy() || !filter(e.row().cells())) {
             return stop_iteration::no;
         }
         auto& row = e.row();
@@ -813,16 +880,10 @@ mutation_partition::query_compacted(query::result::partition_writer& pw, const s
         }
 
         if (row.is_live(s)) {
-            if (pw.requested_result()) {
-                auto cells_wr = [&] {
-                    if (send_ck) {
-                        return rows_wr.add().write_key(e.key()).start_cells().start_cells();
-                    } else {
-                        return rows_wr.add().skip_key().start_cells().start_cells();
-                    }
-                }();
-                get_compacted_row_slice(s, slice, column_kind::regular_column, row.cells(), slice.regular_columns, cells_wr);
-                std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
+            if (count_rows) {
+                last_row = &e;
+            } else if (pw.requested_result()) {
+                write_row(e);
             }
             ++row_count;
             if (--limit == 0) {
@@ -832,6 +893,10 @@ mutation_partition::query_compacted(query::result::partition_writer& pw, const s
         return stop_iteration::no;
     });
 
+    if (last_row && pw.requested_result()) {
+        write_row(*last_row);
+    }
+
     pw.last_modified() = max_ts.max;
 
     // If we got no rows, but have live static columns, we should only
@@ -840,7 +905,7 @@ mutation_partition::query_compacted(query::result::partition_writer& pw, const s
     // If ck:s exist, and we do a restriction on them, we either have maching
     // rows, or return nothing, since cql does not allow "is null".
     if (row_count == 0
-            && (has_ck_selector(pw.ranges())
+            && (has_row_selector(slice, pw.ranges())
                     || !has_any_live_data(s, column_kind::static_column, static_row()))) {
         pw.retract();
     } else {
@@ -1058,6 +1123,7 @@ row::apply(const column_definition& column, atomic_cell_or_collection&& value, c
 
 template<typename Func>
 void row::consume_with(Func&& func) {
+    invalidate_row_hash();
     if (_type == storage_type::vector) {
         unsigned i = 0;
         for (; i < _storage.vector.v.size(); i++) {
@@ -1085,6 +1151,7 @@ row::apply_monotonically(const column_definition& column, atomic_cell_or_collect
                   "noexcept required for atomicity");
 
     // our mutations are not yet immutable
+    invalidate_row_hash();
     auto id = column.id;
     if (_type == storage_type::vector && id < max_vector_size) {
         if (id >= _storage.vector.v.size()) {
@@ -1117,6 +1184,7 @@ row::apply_monotonically(const column_definition& column, atomic_cell_or_collect
 
 void
 row::append_cell(column_id id, atomic_cell_or_collection value) {
+    invalidate_row_hash();
     if (_type == storage_type::vector && id < max_vector_size) {
         _storage.vector.v.resize(id);
         _storage.vector.v.emplace_back(cell_and_hash{std::move(value), cell_hash_opt()});
@@ -1379,6 +1447,8 @@ rows_entry::rows_entry(rows_entry&& o) noexcept
 row::row(const row& o)
     : _type(o._type)
     , _size(o._size)
+    , _row_hash(o._row_hash)
+    , _row_max_timestamp(o._row_max_timestamp)
 {
     if (_type == storage_type::vector) {
         new (&_storage.vector) vector_storage(o._storage.vector);
@@ -1499,13 +1569,15 @@ row::row() {
 }
 
 row::row(row&& other) noexcept
-    : _type(other._type), _size(other._size) {
+    : _type(other._type), _size(other._size)
+    , _row_hash(other._row_hash), _row_max_timestamp(other._row_max_timestamp) {
     if (_type == storage_type::vector) {
         new (&_storage.vector) vector_storage(std::move(other._storage.vector));
     } else {
         new (&_storage.set) map_type(std::move(other._storage.set));
     }
     other._size = 0;
+    other.invalidate_row_hash();
 }
 
 row& row::operator=(row&& other) noexcept {
@@ -1567,6 +1639,7 @@ bool row::compact_and_expire(const schema& s, column_kind kind, row_tombstone to
                 erase = can_erase_cell();
                 if (!erase) {
                     c = atomic_cell::make_dead(cell.timestamp(), cell.deletion_time());
+                    invalidate_row_hash();
                 }
             } else if (!cell.is_live()) {
                 erase = can_erase_cell();
@@ -1585,6 +1658,7 @@ bool row::compact_and_expire(const schema& s, column_kind kind, row_tombstone to
                 erase = true;
             } else {
                 c = ctype->serialize_mutation_form(m);
+                invalidate_row_hash();
             }
         }
         return erase;
@@ -1716,9 +1790,14 @@ class mutation_querier {
     uint32_t _live_clustering_rows = 0;
     stdx::optional<ser::qr_partition__rows<bytes_ostream>> _rows_wr;
     bool _short_reads_allowed;
+    bool _count_rows;
+    // With option::count_rows, the last live row, which is the only one written.
+    stdx::optional<clustering_row> _last_row;
 private:
     void query_static_row(const row& r, tombstone current_tombstone);
     void prepare_writers();
+    template<typename RowsWriter>
+    void write_row(RowsWriter& rows_writer, const clustering_row& cr);
 public:
     mutation_querier(const schema& s, query::result::partition_writer& pw,
                      query::result_memory_accounter& memory_accounter);
@@ -1738,6 +1817,7 @@ mutation_querier::mutation_querier(const schema& s, query::result::partition_wri
     , _pw(pw)
     , _static_cells_wr(pw.start().start_static_row().start_cells())
     , _short_reads_allowed(pw.slice().options.contains<query::partition_slice::option::allow_short_read>())
+    , _count_rows(pw.slice().options.contains<query::partition_slice::option::count_rows>())
 {
 }
 
@@ -1796,27 +1876,17 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
         _pw.last_modified() = max_ts.max;
     }
 
-    auto write_row = [&] (auto& rows_writer) {
-        auto cells_wr = [&] {
-            if (slice.options.contains(query::partition_slice::option::send_clustering_key)) {
-                return rows_writer.add().write_key(cr.key()).start_cells().start_cells();
-            } else {
-                return rows_writer.add().skip_key().start_cells().start_cells();
-            }
-        }();
-        get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
-        std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
-    };
-
     auto stop = stop_iteration::no;
-    if (_pw.requested_result()) {
+    if (_count_rows) {
+        _last_row = std::move(cr);
+    } else if (_pw.requested_result()) {
         auto start = _rows_wr->_out.size();
-        write_row(*_rows_wr);
+        write_row(*_rows_wr, cr);
         stop = _memory_accounter.update_and_check(_rows_wr->_out.size() - start);
     } else if (_short_reads_allowed) {
         seastar::measuring_output_stream stream;
         ser::qr_partition__rows<seastar::measuring_output_stream> out(stream, { });
-        write_row(out);
+        write_row(out, cr);
         stop = _memory_accounter.update_and_check(stream.size());
     }
 
@@ -1824,16 +1894,36 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
     return stop && stop_iteration(_short_reads_allowed);
 }
 
+template<typename RowsWriter>
+void mutation_querier::write_row(RowsWriter& rows_writer, const clustering_row& cr) {
+    const query::partition_slice& slice = _pw.slice();
+    auto cells_wr = [&] {
+        if (slice.options.contains(query::partition_slice::option::send_clustering_key)) {
+            return rows_writer.add().write_key(cr.key()).start_cells().start_cells();
+        } else {
+            return rows_writer.add().skip_key().start_cells().start_cells();
+        }
+    }();
+    get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+    std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
+}
+
 uint32_t mutation_querier::consume_end_of_stream() {
     prepare_writers();
 
+    if (_last_row && _pw.requested_result()) {
+        auto start = _rows_wr->_out.size();
+        write_row(*_rows_wr, *_last_row);
+        _memory_accounter.update(_rows_wr->_out.size() - start);
+    }
+
     // If we got no rows, but have live static columns, we should only
     // give them back IFF we did not have any CK restrictions.
     // #589
     // If ck:s exist, and we do a restriction on them, we either have maching
     // rows, or return nothing, since cql does not allow "is null".
     if (!_live_clustering_rows
-        && (has_ck_selector(_pw.ranges()) || !_live_data_in_static_row)) {
+        && (has_row_selector(_pw.slice(), _pw.ranges()) || !_live_data_in_static_row)) {
         _pw.retract();
         return 0;
     } else {
@@ -135,6 +135,13 @@ class row {
     storage_type _type = storage_type::vector;
     size_type _size = 0;
 
+    // Hash of all cells of the row, as fed by row-hashing digesters, and the
+    // highest timestamp among them. Filled in by prepare_hash(), so that digest
+    // reads of cached rows don't have to visit every cell. Must be reset by
+    // every modification of the row.
+    mutable cell_hash_opt _row_hash;
+    mutable api::timestamp_type _row_max_timestamp = api::missing_timestamp;
+
     using map_type = boost::intrusive::set<cell_entry,
         boost::intrusive::member_hook<cell_entry, boost::intrusive::set_member_hook<>, &cell_entry::_link>,
         boost::intrusive::compare<cell_entry::compare>, boost::intrusive::constant_time_size<false>>;
@@ -190,6 +197,7 @@ class row {
                 }
                 auto& c = _storage.vector.v[i].cell;
                 if (func(i, c)) {
+                    invalidate_row_hash();
                     c = atomic_cell_or_collection();
                     _storage.vector.present.reset(i);
                     _size--;
@@ -198,6 +206,7 @@ class row {
         } else {
             for (auto it = _storage.set.begin(); it != _storage.set.end();) {
                 if (func(it->id(), it->cell())) {
+                    invalidate_row_hash();
                     auto& entry = *it;
                     it = _storage.set.erase(it);
                     current_allocator().destroy(&entry);
@@ -249,6 +258,7 @@ class row {
     // noexcept if Func doesn't throw.
     template<typename Func>
     void for_each_cell(Func&& func) {
+        invalidate_row_hash();
         if (_type == storage_type::vector) {
             for (auto i : bitsets::for_each_set(_storage.vector.present)) {
                 maybe_invoke_with_hash(func, i, _storage.vector.v[i]);
@@ -327,6 +337,12 @@ class row {
 
     void prepare_hash(const schema& s, column_kind kind) const;
 
+    // Returns the hash of all cells of the row, if prepare_hash() computed it
+    // and the row wasn't modified since.
+    const cell_hash_opt& row_hash() const { return _row_hash; }
+    api::timestamp_type row_max_timestamp() const { return _row_max_timestamp; }
+    void invalidate_row_hash() const { _row_hash = { }; }
+
     friend std::ostream& operator<<(std::ostream& os, const row& r);
 };
 
@@ -72,6 +72,38 @@ to_data_query_result(const reconcilable_result& r, schema_ptr s, const query::pa
     return builder.build();
 }
 
+query::result
+to_filtered_data_query_result(const reconcilable_result& r, schema_ptr s, const query::partition_slice& slice,
+        uint32_t max_rows, uint32_t max_partitions, uint32_t examined_row_limit) {
+    query::result::builder builder(slice, query::result_options::only_result(), { });
+    auto is_reversed = slice.options.contains<query::partition_slice::option::reversed>();
+    auto rows_left = examined_row_limit;
+    stdx::optional<query::examined_position> last_examined;
+    for (const partition& p : r.partitions()) {
+        if (!rows_left || builder.row_count() >= max_rows || builder.partition_count() >= max_partitions) {
+            break;
+        }
+        auto m = p.mut().unfreeze(s);
+        auto& mp = m.partition();
+        rows_left -= mp.compact_for_query(*s, gc_clock::time_point::min(), slice.row_ranges(*s, m.key()), is_reversed,
+                std::min(rows_left, slice.partition_row_limit()));
+        const auto& rows = mp.clustered_rows();
+        if (!rows.empty()) {
+            last_examined = query::examined_position{m.key(), is_reversed ? rows.begin()->key() : rows.rbegin()->key()};
+        }
+        auto pw = builder.add_partition(*s, m.key());
+        mp.query_compacted(pw, *s, std::min(max_rows - builder.row_count(), slice.partition_row_limit()));
+    }
+    if (r.is_short_read()) {
+        builder.mark_as_short_read();
+    }
+    auto result = builder.build();
+    if (last_examined && !result.row_count().value_or(0)) {
+        result.set_last_examined(std::move(*last_examined));
+    }
+    return result;
+}
+
 std::ostream& operator<<(std::ostream& out, const reconcilable_result::printer& pr) {
     out << "{rows=" << pr.self.row_count() << ", short_read="
         << pr.self.is_short_read() << ", [";
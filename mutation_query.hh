@@ -108,6 +108,14 @@ class reconcilable_result {
 
 query::result to_data_query_result(const reconcilable_result&, schema_ptr, const query::partition_slice&, uint32_t row_limit, uint32_t partition_limit, query::result_options opts = query::result_options::only_result());
 
+// Like to_data_query_result(), but for slices with column filters, which
+// mutation queries do not apply. Replicas counted rows before filtering, so
+// the reconciled result can only be trusted up to examined_row_limit live
+// rows; rows past that point are never returned, even if fewer than
+// row_limit rows passed the filters.
+query::result to_filtered_data_query_result(const reconcilable_result&, schema_ptr, const query::partition_slice&,
+        uint32_t row_limit, uint32_t partition_limit, uint32_t examined_row_limit);
+
 // Performs a query on given data source returning data in reconcilable form.
 //
 // Reads at most row_limit rows. If less rows are returned, the data source
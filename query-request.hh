@@ -92,6 +92,23 @@ class specific_ranges {
     clustering_row_ranges _ranges;
 };
 
+enum class filter_operator : uint8_t {
+    eq,
+    lt,
+    lte,
+    gt,
+    gte,
+};
+
+// A restriction on a regular column, checked by the replicas against the
+// cells of each row before the row is added to the result. Rows whose cell
+// is missing never match.
+struct column_filter {
+    column_id column;
+    filter_operator op;
+    bytes value; // Serialized like the cells of the column
+};
+
 constexpr auto max_rows = std::numeric_limits<uint32_t>::max();
 
 // Specifies subset of rows, columns and cell attributes to be returned in a query.
@@ -100,7 +117,10 @@ constexpr auto max_rows = std::numeric_limits<uint32_t>::max();
 class partition_slice {
 public:
     enum class option { send_clustering_key, send_partition_key, send_timestamp, send_expiry, reversed, distinct, collections_as_maps, send_ttl,
-                        allow_short_read, with_digest };
+                        allow_short_read, with_digest, bypass_cache,
+                        // Rows are counted in query::result::row_count() but only
+                        // the last row of each partition is written to the result.
+                        count_rows };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
         option::send_partition_key,
@@ -111,7 +131,9 @@ class partition_slice {
         option::collections_as_maps,
         option::send_ttl,
         option::allow_short_read,
-        option::with_digest>>;
+        option::with_digest,
+        option::bypass_cache,
+        option::count_rows>>;
     clustering_row_ranges _row_ranges;
 public:
     std::vector<column_id> static_columns; // TODO: consider using bitmap
@@ -121,12 +143,14 @@ class partition_slice {
     std::unique_ptr<specific_ranges> _specific_ranges;
     cql_serialization_format _cql_format;
     uint32_t _partition_row_limit;
+    std::vector<column_filter> _filters;
 public:
     partition_slice(clustering_row_ranges row_ranges, std::vector<column_id> static_columns,
         std::vector<column_id> regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges = nullptr,
         cql_serialization_format = cql_serialization_format::internal(),
-        uint32_t partition_row_limit = max_rows);
+        uint32_t partition_row_limit = max_rows,
+        std::vector<column_filter> filters = {});
     partition_slice(const partition_slice&);
     partition_slice(partition_slice&&);
     ~partition_slice();
@@ -154,6 +178,11 @@ class partition_slice {
     void set_partition_row_limit(uint32_t limit) {
         _partition_row_limit = limit;
     }
+    // Rows not matching all of the filters are left out of query results.
+    // Mutation queries, used for reconciliation, ignore them.
+    const std::vector<column_filter>& filters() const {
+        return _filters;
+    }
 
     friend std::ostream& operator<<(std::ostream& out, const partition_slice& ps);
     friend std::ostream& operator<<(std::ostream& out, const specific_ranges& ps);
@@ -335,6 +335,12 @@ class result_digest {
 struct short_read_tag { };
 using short_read = bool_class<short_read_tag>;
 
+// Position of a clustering row, see result::last_examined().
+struct examined_position {
+    partition_key partition;
+    clustering_key row;
+};
+
 class result {
     bytes_ostream _w;
     stdx::optional<result_digest> _digest;
@@ -343,6 +349,8 @@ class result {
     short_read _short_read;
     query::result_memory_tracker _memory_tracker;
     stdx::optional<uint32_t> _partition_count;
+    // Not serialized, only set by the coordinator.
+    stdx::optional<examined_position> _last_examined;
 public:
     class builder;
     class partition_writer;
@@ -400,6 +408,21 @@ class result {
         return _partition_count;
     }
 
+    // For short reads which returned no rows, the last live row which was
+    // examined and rejected by the slice's filters, if any. Paging resumes
+    // after it instead of reading the same rows again.
+    const stdx::optional<examined_position>& last_examined() const {
+        return _last_examined;
+    }
+
+    void set_last_examined(examined_position pos) {
+        _last_examined = std::move(pos);
+    }
+
+    void mark_as_short_read() {
+        _short_read = short_read::yes;
+    }
+
     void ensure_counts();
 
     struct printer {
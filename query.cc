@@ -54,6 +54,9 @@ std::ostream& operator<<(std::ostream& out, const partition_slice& ps) {
     out << ", options=" << sprint("%x", ps.options.mask()); // FIXME: pretty print options
     out << ", cql_format=" << ps.cql_format();
     out << ", partition_row_limit=" << ps._partition_row_limit;
+    if (!ps._filters.empty()) {
+        out << ", filters=" << ps._filters.size();
+    }
     return out << "}";
 }
 
@@ -77,7 +80,8 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     option_set options,
     std::unique_ptr<specific_ranges> specific_ranges,
     cql_serialization_format cql_format,
-    uint32_t partition_row_limit)
+    uint32_t partition_row_limit,
+    std::vector<column_filter> filters)
     : _row_ranges(std::move(row_ranges))
     , static_columns(std::move(static_columns))
     , regular_columns(std::move(regular_columns))
@@ -85,6 +89,7 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     , _specific_ranges(std::move(specific_ranges))
     , _cql_format(std::move(cql_format))
     , _partition_row_limit(partition_row_limit)
+    , _filters(std::move(filters))
 {}
 
 partition_slice::partition_slice(partition_slice&&) = default;
@@ -101,6 +106,7 @@ partition_slice::partition_slice(const partition_slice& s)
     , _specific_ranges(s._specific_ranges ? std::make_unique<specific_ranges>(*s._specific_ranges) : nullptr)
     , _cql_format(s._cql_format)
     , _partition_row_limit(s._partition_row_limit)
+    , _filters(s._filters)
 {}
 
 partition_slice::~partition_slice()
@@ -202,6 +208,21 @@ static void write_partial_partition(ser::writer_of_qr_partition<bytes_ostream>&&
     std::move(rows_wr).end_rows().end_qr_partition();
 }
 
+std::vector<partition_result> split_by_partition(const query::result& r) {
+    std::vector<partition_result> partitions;
+    auto v = ser::query_result_view{ser::as_input_stream(r.buf())};
+    for (auto&& pv : v.partitions()) {
+        bytes_ostream w;
+        auto wr = ser::writer_of_query_result<bytes_ostream>(w).start_partitions();
+        wr.add(pv);
+        std::move(wr).end_partitions().end_query_result();
+        auto rows = pv.rows();
+        const uint32_t row_count = rows.size() ? : 1;
+        partitions.push_back(partition_result{*pv.key(), make_lw_shared<query::result>(std::move(w), short_read::no, row_count, 1)});
+    }
+    return partitions;
+}
+
 foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
     if (_partial.size() == 1) {
         return std::move(_partial[0]);
@@ -212,6 +233,7 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
     uint32_t row_count = 0;
     short_read is_short_read;
     uint32_t partition_count = 0;
+    stdx::optional<examined_position> last_examined;
 
     for (auto&& r : _partial) {
         result_view::do_with(*r, [&] (result_view rv) {
@@ -237,6 +259,7 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
         });
         if (r->is_short_read()) {
             is_short_read = short_read::yes;
+            last_examined = r->last_examined();
             break;
         }
         if (row_count >= _max_rows || partition_count >= _max_partitions) {
@@ -246,7 +269,26 @@ foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
 
     std::move(partitions).end_partitions().end_query_result();
 
-    return make_foreign(make_lw_shared<query::result>(std::move(w), is_short_read, row_count, partition_count));
+    if (_digest_algo == digest_algorithm::none) {
+        auto result = make_lw_shared<query::result>(std::move(w), is_short_read, row_count, partition_count);
+        if (last_examined && !row_count) {
+            result->set_last_examined(std::move(*last_examined));
+        }
+        return make_foreign(std::move(result));
+    }
+
+    // Digests of all accepted results are combined, including those beyond
+    // the limits, so that the digest depends only on the data read.
+    digester d(_digest_algo);
+    auto last_modified = api::missing_timestamp;
+    for (auto&& r : _partial) {
+        for (auto b : r->digest()->get()) {
+            d.feed_hash(b);
+        }
+        last_modified = std::max(last_modified, r->last_modified());
+    }
+    return make_foreign(make_lw_shared<query::result>(std::move(w), result_digest(d.finalize_array()), last_modified,
+            is_short_read, row_count, partition_count));
 }
 
 }
@@ -32,10 +32,14 @@ class result_merger {
     std::vector<foreign_ptr<lw_shared_ptr<query::result>>> _partial;
     const uint32_t _max_rows;
     const uint32_t _max_partitions;
+    const digest_algorithm _digest_algo;
 public:
-    explicit result_merger(uint32_t max_rows, uint32_t max_partitions)
+    // When digest_algo is not none the merged result carries a digest
+    // combined from the digests of the merged results.
+    explicit result_merger(uint32_t max_rows, uint32_t max_partitions, digest_algorithm digest_algo = digest_algorithm::none)
             : _max_rows(max_rows)
             , _max_partitions(max_partitions)
+            , _digest_algo(digest_algo)
     { }
 
     void reserve(size_t size) {
@@ -55,4 +59,13 @@ class result_merger {
     foreign_ptr<lw_shared_ptr<query::result>> get();
 };
 
+struct partition_result {
+    partition_key key;
+    lw_shared_ptr<query::result> result;
+};
+
+// Splits a result into single-partition results, in the order of the result.
+// The result must carry partition keys (partition_slice::option::send_partition_key).
+std::vector<partition_result> split_by_partition(const query::result& r);
+
 }
@@ -138,6 +138,7 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     //
     autoupdating_underlying_reader _underlying;
     uint64_t _underlying_created = 0;
+    uint64_t _partitions_missed = 0;
 
     mutation_source_opt _underlying_snapshot;
     dht::partition_range _sm_range;
@@ -191,6 +192,15 @@ class read_context final : public enable_lw_shared_from_this<read_context> {
     row_cache::phase_type phase() const { return _phase; }
     const dht::decorated_key& key() const { return *_key; }
     void on_underlying_created() { ++_underlying_created; }
+    // Called for every partition which this read populates from the underlying source.
+    // Returns true iff the read is considered a scan.
+    bool on_partition_miss() {
+        if (++_partitions_missed == cache_tracker::scan_detection_threshold + 1) {
+            _cache._tracker.on_scan_detected();
+        }
+        return is_scan();
+    }
+    bool is_scan() const { return _range_query && _partitions_missed > cache_tracker::scan_detection_threshold; }
     bool digest_requested() const { return _slice.options.contains<query::partition_slice::option::with_digest>(); }
 private:
     future<> ensure_underlying(db::timeout_clock::time_point timeout) {
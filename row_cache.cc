@@ -120,6 +120,10 @@ cache_tracker::setup_metrics() {
             sm::description("total number of rows in memtables which were dropped during cache update on memtable flush")),
         sm::make_derive("rows_merged_from_memtable", _stats.rows_merged_from_memtable,
             sm::description("total number of rows in memtables which were merged with existing rows during cache update on memtable flush")),
+        sm::make_derive("partition_admission_rejections", _stats.partition_admission_rejections,
+            sm::description("total number of partitions read from sstables which were not inserted into cache because they are accessed less frequently than the cached ones")),
+        sm::make_derive("scans_detected", _stats.scans_detected,
+            sm::description("total number of range reads which were detected to be scans by the admission filter")),
     });
 }
 
@@ -201,6 +205,67 @@ void cache_tracker::on_partition_eviction() {
     ++_stats.partition_evictions;
 }
 
+void cache_tracker::on_partition_eviction(const dht::decorated_key& dk) {
+    on_partition_eviction();
+    if (_admission_sketch) {
+        sync_victim_frequency();
+        _victim_frequency = _admission_sketch->estimate(admission_hash(dk));
+    }
+}
+
+void cache_tracker::enable_admission_filter(size_t expected_partitions) {
+    _admission_sketch = std::make_unique<utils::frequency_sketch>(expected_partitions);
+    _admission_sketch_resets = 0;
+    _victim_frequency = 0;
+}
+
+void cache_tracker::disable_admission_filter() {
+    _admission_sketch = {};
+    _victim_frequency = 0;
+}
+
+uint64_t cache_tracker::admission_hash(const dht::decorated_key& dk) const {
+    return std::hash<dht::decorated_key>()(dk);
+}
+
+// The frequency of the last victim ages together with the sketch, so that
+// a single eviction of a hot partition doesn't block admission indefinitely.
+void cache_tracker::sync_victim_frequency() {
+    auto resets = _admission_sketch->resets();
+    while (_admission_sketch_resets < resets && _victim_frequency) {
+        _victim_frequency /= 2;
+        ++_admission_sketch_resets;
+    }
+    _admission_sketch_resets = resets;
+}
+
+void cache_tracker::record_access(const dht::decorated_key& dk) {
+    if (_admission_sketch) {
+        _admission_sketch->record(admission_hash(dk));
+    }
+}
+
+bool cache_tracker::admit(const dht::decorated_key& dk, bool scan) {
+    if (!_admission_sketch) {
+        return true;
+    }
+    auto h = admission_hash(dk);
+    _admission_sketch->record(h);
+    sync_victim_frequency();
+    auto frequency = _admission_sketch->estimate(h);
+    bool admitted = scan ? frequency > _victim_frequency : frequency >= _victim_frequency;
+    if (!admitted) {
+        ++_stats.partition_admission_rejections;
+        // Rejections evict nothing, so they would leave the victim's frequency in place
+        // until the sketch ages. Lower it with each of them, so that partitions which
+        // became popular after a hot one was evicted get into cache soon.
+        if (_victim_frequency) {
+            --_victim_frequency;
+        }
+    }
+    return admitted;
+}
+
 void cache_tracker::on_row_eviction() {
     --_stats.rows;
     ++_stats.row_evictions;
@@ -399,6 +464,9 @@ class single_partition_populating_reader final : public flat_mutation_reader::im
                     _cache._tracker.on_mispopulate();
                 }
                 _end_of_stream = true;
+            } else if (!_cache._tracker.admit(mfopt->as_partition_start().key(), false)) {
+                _reader = read_directly_from_underlying(*_read_context);
+                this->push_mutation_fragment(std::move(*mfopt));
             } else if (phase == _cache.phase_of(_read_context->range().start()->value())) {
                 _reader = _cache._read_section(_cache._tracker.region(), [&] {
                     cache_entry& e = _cache.find_or_create(mfopt->as_partition_start().key(), mfopt->as_partition_start().partition_tombstone(), phase);
@@ -543,6 +611,12 @@ class range_populating_reader {
                 _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
+                if (!_cache._tracker.admit(key, _read_context.on_partition_miss())) {
+                    // The gap left by the partition which is not cached must not be marked continuous.
+                    _last_key = {};
+                    return make_ready_future<flat_mutation_reader_opt, mutation_fragment_opt>(
+                        read_directly_from_underlying(_read_context), std::move(mfopt));
+                }
                 if (_reader.creation_phase() == _cache.phase_of(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create(key,
@@ -592,6 +666,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader::impl {
     flat_mutation_reader read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
         _cache.on_partition_hit();
+        _cache._tracker.record_access(ce.key());
         return ce.read(_cache, *_read_context);
     }
 
@@ -775,6 +850,7 @@ row_cache::make_reader(schema_ptr s,
                     cache_entry& e = *i;
                     upgrade_entry(e);
                     on_partition_hit();
+                    _tracker.record_access(e.key());
                     return e.read(*this, *ctx);
                 } else if (i->continuous()) {
                     return make_empty_flat_reader(std::move(s));
@@ -1199,9 +1275,9 @@ void row_cache::set_schema(schema_ptr new_schema) noexcept {
 void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
     auto it = row_cache::partitions_type::s_iterator_to(*this);
     std::next(it)->set_continuous(false);
+    tracker.on_partition_eviction(_key);
     evict(tracker);
     current_deleter<cache_entry>()(this);
-    tracker.on_partition_eviction();
 }
 
 void rows_entry::on_evicted(cache_tracker& tracker) noexcept {
@@ -36,6 +36,7 @@
 #include "utils/histogram.hh"
 #include "partition_version.hh"
 #include "utils/estimated_histogram.hh"
+#include "utils/frequency_sketch.hh"
 #include "tracing/trace_state.hh"
 #include <seastar/core/metrics_registration.hh>
 #include "flat_mutation_reader.hh"
@@ -220,6 +221,8 @@ class cache_tracker final {
         uint64_t reads_with_misses;
         uint64_t reads_done;
         uint64_t pinned_dirty_memory_overload;
+        uint64_t partition_admission_rejections;
+        uint64_t scans_detected;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -230,8 +233,22 @@ class cache_tracker final {
     seastar::metrics::metric_groups _metrics;
     logalloc::region _region;
     lru_type _lru;
+    // Admission filter, engaged when enabled by enable_admission_filter().
+    std::unique_ptr<utils::frequency_sketch> _admission_sketch;
+    // Estimated frequency of the partition which was most recently evicted,
+    // lowered by each rejection. Partitions read from the underlying source
+    // are admitted only if they are accessed at least as frequently as the
+    // ones they displace.
+    unsigned _victim_frequency = 0;
+    uint64_t _admission_sketch_resets = 0;
 private:
     void setup_metrics();
+    uint64_t admission_hash(const dht::decorated_key&) const;
+    void sync_victim_frequency();
+public:
+    // Number of partitions which a range read must miss in cache before
+    // it is considered a scan, to which admission is more restrictive.
+    static constexpr uint64_t scan_detection_threshold = 32;
 public:
     cache_tracker();
     ~cache_tracker();
@@ -249,6 +266,7 @@ class cache_tracker final {
     void on_partition_hit();
     void on_partition_miss();
     void on_partition_eviction();
+    void on_partition_eviction(const dht::decorated_key&);
     void on_row_eviction();
     void on_row_hit();
     void on_row_miss();
@@ -258,6 +276,22 @@ class cache_tracker final {
     void on_row_dropped_from_memtable() { ++_stats.rows_dropped_from_memtable; }
     void on_row_merged_from_memtable() { ++_stats.rows_merged_from_memtable; }
     void pinned_dirty_memory_overload(uint64_t bytes);
+    void on_scan_detected() { ++_stats.scans_detected; }
+
+    // Enables frequency-based admission of partitions into cache (TinyLFU),
+    // sized for tracking expected_partitions distinct partitions.
+    // When disabled, every partition read from the underlying source is
+    // admitted. A tracker starts with the filter disabled; the database
+    // enables it unless the enable_cache_admission_filter option is off.
+    void enable_admission_filter(size_t expected_partitions);
+    void disable_admission_filter();
+    bool admission_filter_enabled() const { return bool(_admission_sketch); }
+    // Records an access to a partition for the purpose of admission decisions.
+    void record_access(const dht::decorated_key&);
+    // Records an access to a partition missing in cache and decides whether it
+    // should be inserted into cache. Reads which were detected to be scans
+    // must be strictly more frequent than the victim to be admitted.
+    bool admit(const dht::decorated_key&, bool scan);
     allocation_strategy& allocator();
     logalloc::region& region();
     const logalloc::region& region() const;
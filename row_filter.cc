@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "row_filter.hh"
+#include "mutation_partition.hh"
+#include "types.hh"
+
+namespace query {
+
+// Must agree with the compare() of the corresponding types, empty values
+// sorting before all others.
+template<typename T>
+static int compare_integral(const abstract_type&, bytes_view a, bytes_view b) {
+    if (a.empty() || b.empty()) {
+        return int(!a.empty()) - int(!b.empty());
+    }
+    auto x = read_simple_exactly<T>(a);
+    auto y = read_simple_exactly<T>(b);
+    return x == y ? 0 : x < y ? -1 : 1;
+}
+
+static int compare_double(const abstract_type&, bytes_view a, bytes_view b) {
+    if (a.empty() || b.empty()) {
+        return int(!a.empty()) - int(!b.empty());
+    }
+    auto decode = [] (bytes_view v) {
+        auto i = read_simple_exactly<int64_t>(v);
+        double d;
+        std::memcpy(&d, &i, sizeof(d));
+        return d;
+    };
+    auto x = decode(a);
+    auto y = decode(b);
+    // Like the double type, -0 is equal to 0, and NaN is greater than everything,
+    // itself included, so it never matches an equality filter.
+    return x == y ? 0 : x < y ? -1 : 1;
+}
+
+static int compare_generic(const abstract_type& t, bytes_view a, bytes_view b) {
+    return t.compare(a, b);
+}
+
+static row_filter::compare_fn comparator_for(const data_type& t) {
+    if (t == int32_type) {
+        return compare_integral<int32_t>;
+    } else if (t == long_type || t == timestamp_type) {
+        return compare_integral<int64_t>;
+    } else if (t == double_type) {
+        return compare_double;
+    }
+    return compare_generic;
+}
+
+row_filter::row_filter(const schema& s, const partition_slice& slice) {
+    _filters.reserve(slice.filters().size());
+    for (auto&& f : slice.filters()) {
+        auto& def = s.regular_column_at(f.column);
+        _filters.push_back(prepared_filter{f.column, f.op, f.value, def.type, comparator_for(def.type)});
+    }
+}
+
+bool row_filter::matches(const row& cells) const {
+    for (auto&& f : _filters) {
+        auto* cell = cells.find_cell(f.id);
+        if (!cell) {
+            return false;
+        }
+        auto c = cell->as_atomic_cell();
+        if (!c.is_live()) {
+            return false;
+        }
+        auto cmp = f.compare(*f.type, c.value(), f.value);
+        bool match;
+        switch (f.op) {
+        case filter_operator::eq: match = cmp == 0; break;
+        case filter_operator::lt: match = cmp < 0; break;
+        case filter_operator::lte: match = cmp <= 0; break;
+        case filter_operator::gt: match = cmp > 0; break;
+        case filter_operator::gte: match = cmp >= 0; break;
+        default: abort();
+        }
+        if (!match) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "schema.hh"
+#include "query-request.hh"
+
+class row;
+
+namespace query {
+
+// The column filters of a partition_slice, prepared for matching the rows of a schema.
+//
+// The comparison is chosen once per filter: fixed-width types (int, bigint,
+// timestamp, double) are compared by decoding the serialized cells in place,
+// other types go through abstract_type::compare().
+class row_filter {
+public:
+    using compare_fn = int (*)(const abstract_type&, bytes_view, bytes_view);
+private:
+    struct prepared_filter {
+        column_id id;
+        filter_operator op;
+        bytes value;
+        data_type type;
+        compare_fn compare;
+    };
+    std::vector<prepared_filter> _filters;
+public:
+    row_filter() = default;
+    row_filter(const schema& s, const partition_slice& slice);
+
+    bool empty() const {
+        return _filters.empty();
+    }
+
+    // Checks whether the regular cells of a compacted row match all filters.
+    bool operator()(const row& cells) const {
+        return _filters.empty() || matches(cells);
+    }
+private:
+    bool matches(const row& cells) const;
+};
+
+}
@@ -43,6 +43,7 @@
 
 #include "paging_state.hh"
 #include "cql3/result_set.hh"
+#include "cql3/result_generator.hh"
 #include "cql3/selection/selection.hh"
 
 namespace service {
@@ -85,6 +86,18 @@ class query_pager {
      */
     virtual future<> fetch_page(cql3::selection::result_set_builder&, uint32_t page_size, gc_clock::time_point) = 0;
 
+    /**
+     * Fetches the next page, whose rows are then generated straight from
+     * the query result. The selection must be trivial.
+     */
+    virtual future<cql3::result_generator> fetch_page_generator(uint32_t page_size, gc_clock::time_point) = 0;
+
+    /**
+     * Fetches the next page, having the replicas count its rows instead of
+     * returning them, and returns the number of rows in it.
+     */
+    virtual future<uint32_t> fetch_page_row_count(uint32_t page_size) = 0;
+
     /**
      * Whether or not this pager is exhausted, i.e. whether or not a call to
      * fetchPage may return more result.
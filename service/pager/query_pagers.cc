@@ -71,7 +71,7 @@ class service::pager::query_pagers::impl : public query_pager {
                && !cmd.slice.options.contains<query::partition_slice::option::distinct>();
     }
 
-    future<> fetch_page(cql3::selection::result_set_builder& builder, uint32_t page_size, gc_clock::time_point now) override {
+    future<foreign_ptr<lw_shared_ptr<query::result>>> do_fetch_page(uint32_t page_size) {
         auto state = _options.get_paging_state();
 
         if (!_last_pkey && state) {
@@ -205,10 +205,60 @@ class service::pager::query_pagers::impl : public query_pager {
         auto ranges = _ranges;
         auto command = ::make_lw_shared<query::read_command>(*_cmd);
         return get_local_storage_proxy().query(_schema, std::move(command), std::move(ranges),
-                _options.get_consistency(), _state.get_trace_state()).then(
-                [this, &builder, page_size, now](foreign_ptr<lw_shared_ptr<query::result>> results) {
-                    handle_result(builder, std::move(results), page_size, now);
-                });
+                _options.get_consistency(), _state.get_trace_state());
+    }
+
+    future<> fetch_page(cql3::selection::result_set_builder& builder, uint32_t page_size, gc_clock::time_point now) override {
+        return do_fetch_page(page_size).then([this, &builder, page_size, now] (foreign_ptr<lw_shared_ptr<query::result>> results) {
+            handle_result(builder, std::move(results), page_size, now);
+        });
+    }
+
+    // Finds where a page ends, for results whose rows are not otherwise visited.
+    struct last_key_visitor {
+        uint32_t total_rows = 0;
+        std::experimental::optional<partition_key> last_pkey;
+        std::experimental::optional<clustering_key> last_ckey;
+
+        void accept_new_partition(uint32_t) {
+            throw std::logic_error("Should not reach!");
+        }
+        void accept_new_partition(const partition_key& key, uint32_t row_count) {
+            total_rows += std::max(row_count, 1u);
+            last_pkey = key;
+            last_ckey = { };
+        }
+        void accept_new_row(const clustering_key& key, const query::result_row_view&, const query::result_row_view&) {
+            last_ckey = key;
+        }
+        void accept_new_row(const query::result_row_view&, const query::result_row_view&) { }
+        void accept_partition_end(const query::result_row_view&) { }
+    };
+
+    future<cql3::result_generator> fetch_page_generator(uint32_t page_size, gc_clock::time_point now) override {
+        return do_fetch_page(page_size).then([this, page_size] (foreign_ptr<lw_shared_ptr<query::result>> results) {
+            // The generator consumes the result with the slice of this page,
+            // which the next page is going to modify.
+            lw_shared_ptr<const query::read_command> cmd = make_lw_shared<query::read_command>(*_cmd);
+            last_key_visitor v;
+            query::result_view::consume(*results, _cmd->slice, v);
+            update_state(v.total_rows, std::move(v.last_pkey), std::move(v.last_ckey), *results, page_size);
+            return cql3::result_generator(_schema, std::move(results), std::move(cmd), _selection);
+        });
+    }
+
+    future<uint32_t> fetch_page_row_count(uint32_t page_size) override {
+        _cmd->slice.options.set<query::partition_slice::option::count_rows>();
+        return do_fetch_page(page_size).then([this, page_size] (foreign_ptr<lw_shared_ptr<query::result>> results) {
+            // Only the last row of each partition is sent, which is all that's
+            // needed to know where the next page starts.
+            last_key_visitor v;
+            query::result_view::consume(*results, _cmd->slice, v);
+            results->ensure_counts();
+            auto row_count = *results->row_count();
+            update_state(row_count, std::move(v.last_pkey), std::move(v.last_ckey), *results, page_size);
+            return row_count;
+        });
     }
 
     future<std::unique_ptr<cql3::result_set>> fetch_page(uint32_t page_size,
@@ -267,7 +317,16 @@ class service::pager::query_pagers::impl : public query_pager {
 
         myvisitor v(builder, *_schema, *_selection);
         query::result_view::consume(*results, _cmd->slice, v);
+        update_state(v.total_rows, std::move(v.last_pkey), std::move(v.last_ckey), *results, page_size);
+    }
 
+    void update_state(uint32_t total_rows, std::experimental::optional<partition_key> last_pkey,
+            std::experimental::optional<clustering_key> last_ckey, const query::result& results, uint32_t page_size) {
+        if (!last_pkey && results.last_examined()) {
+            // No row on this page passed the filters, resume after those which were rejected.
+            last_pkey = results.last_examined()->partition;
+            last_ckey = results.last_examined()->row;
+        }
         if (_last_pkey) {
             // refs #752, when doing aggregate queries we will re-use same
             // slice repeatedly. Since "specific ck ranges" only deal with
@@ -277,12 +336,12 @@ class service::pager::query_pagers::impl : public query_pager {
             _cmd->slice.clear_range(*_schema, *_last_pkey);
         }
 
-        _max = _max - v.total_rows;
-        _exhausted = (v.total_rows < page_size && !results->is_short_read()) || _max == 0;
-        _last_pkey = v.last_pkey;
-        _last_ckey = v.last_ckey;
+        _max = _max - total_rows;
+        _exhausted = (total_rows < page_size && !results.is_short_read()) || _max == 0;
+        _last_pkey = std::move(last_pkey);
+        _last_ckey = std::move(last_ckey);
 
-        qlogger.debug("Fetched {} rows, max_remain={} {}", v.total_rows, _max, _exhausted ? "(exh)" : "");
+        qlogger.debug("Fetched {} rows, max_remain={} {}", total_rows, _max, _exhausted ? "(exh)" : "");
 
         if (_last_pkey) {
             qlogger.debug("Last partition key: {}", *_last_pkey);
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+
+#include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/range/algorithm/find.hpp>
+
+#include "service/service_level.hh"
+#include "core/print.hh"
+
+namespace service {
+
+// Splits a comma separated list of key:value pairs.
+static std::vector<std::pair<sstring, sstring>> parse_pairs(const sstring& option, const char* what) {
+    std::vector<std::pair<sstring, sstring>> pairs;
+    std::vector<std::string> items;
+    boost::split(items, option, boost::is_any_of(","));
+    for (auto& item : items) {
+        boost::trim(item);
+        if (item.empty()) {
+            continue;
+        }
+        auto pos = item.find(':');
+        if (pos == std::string::npos) {
+            throw std::invalid_argument(sprint("Invalid %s entry '%s', expected a colon separated pair", what, item));
+        }
+        auto key = boost::trim_copy(item.substr(0, pos));
+        auto value = boost::trim_copy(item.substr(pos + 1));
+        if (key.empty() || value.empty()) {
+            throw std::invalid_argument(sprint("Invalid %s entry '%s', expected a colon separated pair", what, item));
+        }
+        pairs.emplace_back(sstring(key), sstring(value));
+    }
+    return pairs;
+}
+
+std::vector<service_level_config> parse_service_levels(const sstring& option) {
+    std::vector<service_level_config> levels;
+    for (auto& p : parse_pairs(option, "service_levels")) {
+        unsigned shares;
+        try {
+            shares = boost::lexical_cast<unsigned>(p.second);
+        } catch (const boost::bad_lexical_cast&) {
+            throw std::invalid_argument(sprint("Invalid shares '%s' for service level %s", p.second, p.first));
+        }
+        if (shares < 1 || shares > 1000) {
+            throw std::invalid_argument(sprint("Shares of service level %s must be between 1 and 1000, got %d", p.first, shares));
+        }
+        auto same_name = [&p] (const service_level_config& l) { return l.name == p.first; };
+        if (boost::algorithm::any_of(levels, same_name)) {
+            throw std::invalid_argument(sprint("Service level %s defined more than once", p.first));
+        }
+        levels.push_back(service_level_config{std::move(p.first), shares});
+    }
+    if (levels.size() > max_service_levels) {
+        throw std::invalid_argument(sprint("At most %d service levels may be defined, got %d", max_service_levels, levels.size()));
+    }
+    return levels;
+}
+
+std::unordered_map<sstring, sstring> parse_role_service_levels(const sstring& option, const std::vector<service_level_config>& levels) {
+    std::unordered_map<sstring, sstring> role_levels;
+    for (auto& p : parse_pairs(option, "role_service_levels")) {
+        auto same_name = [&p] (const service_level_config& l) { return l.name == p.second; };
+        if (!boost::algorithm::any_of(levels, same_name)) {
+            throw std::invalid_argument(sprint("Role %s is attached to undefined service level %s", p.first, p.second));
+        }
+        if (role_levels.count(p.first)) {
+            throw std::invalid_argument(sprint("Role %s is attached to more than one service level", p.first));
+        }
+        role_levels.emplace(std::move(p.first), std::move(p.second));
+    }
+    return role_levels;
+}
+
+role_service_levels::role_service_levels(const std::unordered_map<sstring, sstring>& role_levels, const std::vector<sstring>& level_names) {
+    for (auto&& rl : role_levels) {
+        auto it = boost::find(level_names, rl.second);
+        if (it != level_names.end()) {
+            _levels.emplace(rl.first, it - level_names.begin());
+        }
+    }
+}
+
+std::optional<size_t> role_service_levels::find(const std::optional<sstring>& role) const {
+    if (!role) {
+        return { };
+    }
+    auto it = _levels.find(*role);
+    if (it == _levels.end()) {
+        return { };
+    }
+    return it->second;
+}
+
+}
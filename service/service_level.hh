@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <seastar/core/sstring.hh>
+
+#include "seastarx.hh"
+
+namespace service {
+
+// A service level is a named class of CQL workload. The coordinator side of the
+// requests of the roles attached to it runs in a scheduling group of its own,
+// so that it gets CPU according to the shares of the level instead of competing
+// with the requests of all other roles. That's all a level controls: the work
+// replicas do for the request, including the coordinator's own shards when they
+// are reached through the storage proxy, runs in the regular scheduling groups,
+// with the regular reader concurrency semaphore and I/O priority classes.
+struct service_level_config {
+    sstring name;
+    unsigned shares;
+};
+
+static constexpr size_t max_service_levels = 8;
+
+// Parses the service_levels option, a comma separated list of name:shares pairs.
+// Throws std::invalid_argument if the option is malformed.
+std::vector<service_level_config> parse_service_levels(const sstring& option);
+
+// Parses the role_service_levels option, a comma separated list of role:service_level pairs,
+// into a map from role name to service level name. Throws std::invalid_argument if the option
+// is malformed or names service levels which are not in levels.
+std::unordered_map<sstring, sstring> parse_role_service_levels(const sstring& option, const std::vector<service_level_config>& levels);
+
+// Resolves the service level of the role a connection logged in as. Levels are
+// identified by their position in the list of names given to the constructor.
+class role_service_levels {
+    std::unordered_map<sstring, size_t> _levels;
+public:
+    role_service_levels() = default;
+    // Roles attached to levels missing from level_names are ignored.
+    role_service_levels(const std::unordered_map<sstring, sstring>& role_levels, const std::vector<sstring>& level_names);
+
+    // Returns the position of the level of the role, or nothing if requests of the role
+    // run in the default scheduling group, as do those of anonymous connections.
+    std::optional<size_t> find(const std::optional<sstring>& role) const;
+
+    bool empty() const {
+        return _levels.empty();
+    }
+};
+
+}
@@ -63,6 +63,7 @@
 #include <boost/range/adaptors.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/algorithm/cxx11/none_of.hpp>
+#include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/range/algorithm/count_if.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/find_if.hpp>
@@ -73,6 +74,7 @@
 #include <boost/range/empty.hpp>
 #include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/irange.hpp>
 #include "utils/latency.hh"
 #include "schema.hh"
 #include "schema_registry.hh"
@@ -565,6 +567,9 @@ storage_proxy::storage_proxy(distributed<database>& db, stdx::optional<std::vect
         sm::make_current_bytes("background_write_bytes", [this] { return _stats.background_write_bytes; },
                        sm::description("number of bytes in pending background write requests")),
 
+        sm::make_total_operations("grouped_mutations", [this] { return _stats.grouped_mutations; },
+                       sm::description("number of mutations sent to replicas together with other mutations of the same write")),
+
         sm::make_queue_length("foreground_reads", [this] { return _stats.reads - _stats.background_reads; },
                        sm::description("number of currently pending foreground read requests")),
 
@@ -574,6 +579,9 @@ storage_proxy::storage_proxy(distributed<database>& db, stdx::optional<std::vect
         sm::make_total_operations("read_retries", [this] { return _stats.read_retries; },
                        sm::description("number of read retry attempts")),
 
+        sm::make_total_operations("grouped_reads", [this] { return _stats.grouped_reads; },
+                       sm::description("number of partitions read from replicas together with other partitions of the same query")),
+
         sm::make_total_operations("canceled_read_repairs", [this] { return _stats.global_read_repairs_canceled_due_to_concurrent_write; },
                        sm::description("number of global read repairs canceled due to a concurrent write")),
 
@@ -1199,7 +1207,14 @@ future<std::vector<storage_proxy::unique_response_handler>> storage_proxy::mutat
 
 future<> storage_proxy::mutate_begin(std::vector<unique_response_handler> ids, db::consistency_level cl,
                                      stdx::optional<clock_type::time_point> timeout_opt) {
-    return parallel_for_each(ids, [this, cl, timeout_opt] (unique_response_handler& protected_response) {
+    // Mutations of a multi-mutation write (e.g. a batch) which go to the same
+    // replica are sent to it in a single message.
+    mutation_groups groups;
+    auto groups_ptr = ids.size() > 1 && get_local_storage_service().cluster_supports_batched_mutations() ? &groups : nullptr;
+    auto timeout = timeout_opt.value_or(clock_type::now() + std::chrono::milliseconds(_db.local().get_config().write_request_timeout_in_ms()));
+    // parallel_for_each() invokes the function for all elements before returning,
+    // so the groups are complete when it returns.
+    auto f = parallel_for_each(ids, [this, cl, timeout, groups_ptr] (unique_response_handler& protected_response) {
         auto response_id = protected_response.id;
         // it is better to send first and hint afterwards to reduce latency
         // but request may complete before hint_to_dead_endpoints() is called and
@@ -1207,12 +1222,13 @@ future<> storage_proxy::mutate_begin(std::vector<unique_response_handler> ids, d
         // frozen_mutation copy, or manage handler live time differently.
         hint_to_dead_endpoints(response_id, cl);
 
-        auto timeout = timeout_opt.value_or(clock_type::now() + std::chrono::milliseconds(_db.local().get_config().write_request_timeout_in_ms()));
         // call before send_to_live_endpoints() for the same reason as above
         auto f = response_wait(response_id, timeout);
-        send_to_live_endpoints(protected_response.release(), timeout); // response is now running and it will either complete or timeout
+        send_to_live_endpoints(protected_response.release(), timeout, groups_ptr); // response is now running and it will either complete or timeout
         return std::move(f);
     });
+    send_mutation_groups(std::move(groups), timeout);
+    return f;
 }
 
 // this function should be called with a future that holds result of mutation attempt (usually
@@ -1560,7 +1576,7 @@ future<> storage_proxy::send_to_endpoint(mutation m, gms::inet_address target, d
  * @throws OverloadedException if the hints cannot be written/enqueued
  */
  // returned future is ready when sent is complete, not when mutation is executed on all (or any) targets!
-void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type response_id, clock_type::time_point timeout)
+void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type response_id, clock_type::time_point timeout, mutation_groups* groups)
 {
     // extra-datacenter replicas, grouped by dc
     std::unordered_map<sstring, std::vector<gms::inet_address>> dc_groups;
@@ -1634,6 +1650,9 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
 
             if (coordinator == my_address) {
                 f = futurize<void>::apply(lmutate, std::move(m));
+            } else if (groups && forward.empty() && !handler.read_repair_write()) {
+                // sent later, together with other mutations for this replica
+                (*groups)[coordinator].push_back(grouped_mutation{response_id, handler_ptr, std::move(m)});
             } else {
                 f = futurize<void>::apply(rmutate, coordinator, std::move(forward), *m);
             }
@@ -1658,6 +1677,61 @@ void storage_proxy::send_to_live_endpoints(storage_proxy::response_id_type respo
     }
 }
 
+void storage_proxy::send_mutation_groups(mutation_groups groups, clock_type::time_point timeout) {
+    auto my_address = utils::fb_utilities::get_broadcast_address();
+    send_mutation_groups(std::move(groups), [timeout, my_address] (gms::inet_address dest, const std::vector<lw_shared_ptr<const frozen_mutation>>& fms,
+            std::vector<response_id_type> ids, tracing::trace_state_ptr tr_state) {
+        return netw::get_local_messaging_service().send_mutations(netw::messaging_service::msg_addr{dest, 0}, timeout, fms,
+                my_address, engine().cpu_id(), std::move(ids), tracing::make_trace_info(tr_state));
+    });
+}
+
+void storage_proxy::send_mutation_groups(mutation_groups groups, mutation_group_sender send) {
+    for (auto&& g : groups) {
+        auto dest = g.first;
+        auto& group = g.second;
+        // The mutations are shared with their response handlers, not copied.
+        std::vector<lw_shared_ptr<const frozen_mutation>> fms;
+        std::vector<response_id_type> ids;
+        fms.reserve(group.size());
+        ids.reserve(group.size());
+        size_t msize = 0;
+        for (auto&& gm : group) {
+            fms.push_back(gm.mutation);
+            ids.push_back(gm.id);
+            msize += gm.mutation->representation().size();
+        }
+        _stats.queued_write_bytes += msize;
+        _stats.grouped_mutations += group.size();
+
+        // all mutations of a single write share the trace state
+        auto& tr_state = group.front().handler->get_trace_state();
+        tracing::trace(tr_state, "Sending {} mutations to /{}", group.size(), dest);
+
+        auto f = futurize<void>::apply(send, dest, fms, std::move(ids), tr_state);
+        f.finally([this, p = shared_from_this(), fms = std::move(fms), msize] {
+            _stats.queued_write_bytes -= msize;
+            unthrottle();
+        }).handle_exception([this, p = shared_from_this(), group = std::move(group), dest] (std::exception_ptr eptr) {
+            // the group keeps the handlers alive until the message is sent
+            _stats.writes_errors.get_ep_stat(dest) += group.size();
+            // none of the mutations reached the replica
+            for (auto&& gm : group) {
+                got_failure_response(gm.id, dest, 1);
+            }
+            try {
+                std::rethrow_exception(eptr);
+            } catch(rpc::closed_error&) {
+                // ignore, disconnect will be logged by gossiper
+            } catch(seastar::gate_closed_exception&) {
+                // may happen during shutdown, ignore it
+            } catch(...) {
+                slogger.error("exception during mutations write to {}: {}", dest, std::current_exception());
+            }
+        });
+    }
+}
+
 // returns number of hints stored
 template<typename Range>
 size_t storage_proxy::hint_to_dead_endpoints(std::unique_ptr<mutation_holder>& mh, const Range& targets, tracing::trace_state_ptr tr_state) noexcept
@@ -2457,7 +2531,11 @@ class data_read_resolver : public abstract_read_resolver {
 };
 
 query::digest_algorithm digest_algorithm() {
-    return service::get_local_storage_service().cluster_supports_xxhash_digest_algorithm()
+    auto& ss = service::get_local_storage_service();
+    if (ss.cluster_supports_row_hashes_digest_algorithm()) {
+        return query::digest_algorithm::xxHash_row_hashes;
+    }
+    return ss.cluster_supports_xxhash_digest_algorithm()
          ? query::digest_algorithm::xxHash
          : query::digest_algorithm::MD5;
 }
@@ -2473,7 +2551,8 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     shared_ptr<storage_proxy> _proxy;
     lw_shared_ptr<query::read_command> _cmd;
     lw_shared_ptr<query::read_command> _retry_cmd;
-    dht::partition_range _partition_range;
+    // More than one range only for point reads sharing their replicas, in ring order
+    dht::partition_range_vector _partition_ranges;
     db::consistency_level _cl;
     size_t _block_for;
     std::vector<gms::inet_address> _targets;
@@ -2482,9 +2561,9 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     lw_shared_ptr<column_family> _cf;
 
 public:
-    abstract_read_executor(schema_ptr s, lw_shared_ptr<column_family> cf, shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr, db::consistency_level cl, size_t block_for,
+    abstract_read_executor(schema_ptr s, lw_shared_ptr<column_family> cf, shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector prs, db::consistency_level cl, size_t block_for,
             std::vector<gms::inet_address> targets, tracing::trace_state_ptr trace_state) :
-                           _schema(std::move(s)), _proxy(std::move(proxy)), _cmd(std::move(cmd)), _partition_range(std::move(pr)), _cl(cl), _block_for(block_for), _targets(std::move(targets)), _trace_state(std::move(trace_state)),
+                           _schema(std::move(s)), _proxy(std::move(proxy)), _cmd(std::move(cmd)), _partition_ranges(std::move(prs)), _cl(cl), _block_for(block_for), _targets(std::move(targets)), _trace_state(std::move(trace_state)),
                            _cf(std::move(cf)) {
         _proxy->_stats.reads++;
     }
@@ -2497,11 +2576,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         ++_proxy->_stats.mutation_data_read_attempts.get_ep_stat(ep);
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_mutation_data: querying locally");
-            return _proxy->query_mutations_locally(_schema, cmd, _partition_range, timeout, _trace_state);
+            return _proxy->query_mutations_locally(_schema, cmd, _partition_ranges, timeout, _trace_state);
         } else {
             auto& ms = netw::get_local_messaging_service();
             tracing::trace(_trace_state, "read_mutation_data: sending a message to /{}", ep);
-            return ms.send_read_mutation_data(netw::messaging_service::msg_addr{ep, 0}, timeout, *cmd, _partition_range).then([this, ep](reconcilable_result&& result, rpc::optional<cache_temperature> hit_rate) {
+            return ms.send_read_mutation_data(netw::messaging_service::msg_addr{ep, 0}, timeout, *cmd, _partition_ranges).then([this, ep](reconcilable_result&& result, rpc::optional<cache_temperature> hit_rate) {
                 tracing::trace(_trace_state, "read_mutation_data: got response from /{}", ep);
                 return make_ready_future<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>(make_foreign(::make_lw_shared<reconcilable_result>(std::move(result))), hit_rate.value_or(cache_temperature::invalid()));
             });
@@ -2514,11 +2593,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                   : query::result_options{query::result_request::only_result, query::digest_algorithm::none};
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_data: querying locally");
-            return _proxy->query_result_local(_schema, _cmd, _partition_range, opts, _trace_state, timeout);
+            return _proxy->query_result_local(_schema, _cmd, _partition_ranges, opts, _trace_state, timeout);
         } else {
             auto& ms = netw::get_local_messaging_service();
             tracing::trace(_trace_state, "read_data: sending a message to /{}", ep);
-            return ms.send_read_data(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_range, opts.digest_algo).then([this, ep](query::result&& result, rpc::optional<cache_temperature> hit_rate) {
+            return ms.send_read_data(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_ranges, opts.digest_algo).then([this, ep](query::result&& result, rpc::optional<cache_temperature> hit_rate) {
                 tracing::trace(_trace_state, "read_data: got response from /{}", ep);
                 return make_ready_future<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>(make_foreign(::make_lw_shared<query::result>(std::move(result))), hit_rate.value_or(cache_temperature::invalid()));
             });
@@ -2528,11 +2607,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         ++_proxy->_stats.digest_read_attempts.get_ep_stat(ep);
         if (fbu::is_me(ep)) {
             tracing::trace(_trace_state, "read_digest: querying locally");
-            return _proxy->query_result_local_digest(_schema, _cmd, _partition_range, _trace_state, timeout, digest_algorithm());
+            return _proxy->query_result_local_digest(_schema, _cmd, _partition_ranges, _trace_state, timeout, digest_algorithm());
         } else {
             auto& ms = netw::get_local_messaging_service();
             tracing::trace(_trace_state, "read_digest: sending a message to /{}", ep);
-            return ms.send_read_digest(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_range, digest_algorithm()).then([this, ep] (query::result_digest d, rpc::optional<api::timestamp_type> t,
+            return ms.send_read_digest(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_ranges, digest_algorithm()).then([this, ep] (query::result_digest d, rpc::optional<api::timestamp_type> t,
                     rpc::optional<cache_temperature> hit_rate) {
                 tracing::trace(_trace_state, "read_digest: got response from /{}", ep);
                 return make_ready_future<query::result_digest, api::timestamp_type, cache_temperature>(d, t ? t.value() : api::missing_timestamp, hit_rate.value_or(cache_temperature::invalid()));
@@ -2601,6 +2680,16 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     uint32_t original_partition_limit() const {
         return _cmd->partition_limit;
     }
+    static constexpr uint64_t max_filtered_row_limit_growth = 8;
+    // How many unfiltered rows a filtered read may examine before returning a
+    // short page, if the client pages; unpaged reads have to read until the end.
+    uint32_t max_filtered_row_limit() const {
+        if (!_cmd->slice.options.contains<query::partition_slice::option::allow_short_read>()) {
+            return query::max_rows;
+        }
+        return static_cast<uint32_t>(std::min(static_cast<uint64_t>(query::max_rows),
+                max_filtered_row_limit_growth * static_cast<uint64_t>(original_row_limit())));
+    }
     void reconcile(db::consistency_level cl, storage_proxy::clock_type::time_point timeout, lw_shared_ptr<query::read_command> cmd) {
         data_resolver_ptr data_resolver = ::make_shared<data_read_resolver>(_schema, cl, _targets.size(), timeout);
         auto exec = shared_from_this();
@@ -2610,17 +2699,44 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         data_resolver->done().then_wrapped([this, exec, data_resolver, cmd = std::move(cmd), cl, timeout] (future<> f) {
             try {
                 f.get();
-                auto rr_opt = data_resolver->resolve(_schema, *cmd, original_row_limit(), original_per_partition_row_limit(), original_partition_limit()); // reconciliation happens here
+                // Mutation queries do not apply the slice's column filters, so for filtered
+                // reads the replicas' row limits, and hence the part of the reconciled
+                // result which can be trusted, are in terms of unfiltered rows.
+                bool filtered = !_cmd->slice.filters().empty();
+                auto rr_opt = data_resolver->resolve(_schema, *cmd, filtered ? cmd->row_limit : original_row_limit(),
+                        original_per_partition_row_limit(), original_partition_limit()); // reconciliation happens here
+
+                stdx::optional<query::result> filtered_result;
+                uint32_t row_count = 0;
+                uint32_t live_partition_count = data_resolver->live_partition_count();
+                if (rr_opt && filtered) {
+                    filtered_result = to_filtered_data_query_result(*rr_opt, _schema, _cmd->slice, original_row_limit(),
+                            original_partition_limit(), cmd->row_limit);
+                    row_count = filtered_result->row_count().value_or(0);
+                    live_partition_count = filtered_result->partition_count().value_or(0);
+                } else if (rr_opt) {
+                    row_count = rr_opt->row_count();
+                }
 
                 // We generate a retry if at least one node reply with count live columns but after merge we have less
                 // than the total number of column we are interested in (which may be < count on a retry).
                 // So in particular, if no host returned count live columns, we know it's not a short read.
-                bool can_send_short_read = rr_opt && rr_opt->is_short_read() && rr_opt->row_count() > 0;
-                if (rr_opt && (can_send_short_read || data_resolver->all_reached_end() || rr_opt->row_count() >= original_row_limit()
-                               || data_resolver->live_partition_count() >= original_partition_limit())
+                bool can_send_short_read = rr_opt && rr_opt->is_short_read() && row_count > 0;
+                // Paged filtered reads stop reading further once a retry examined enough rows
+                // and return what passed the filters as a short page. If nothing did, the
+                // page is empty and the pager resumes after the last examined row.
+                bool filtered_limit_reached = filtered && rr_opt && cmd->row_limit >= max_filtered_row_limit()
+                        && _cmd->slice.options.contains<query::partition_slice::option::allow_short_read>()
+                        && (row_count > 0 || filtered_result->last_examined());
+                if (rr_opt && (can_send_short_read || filtered_limit_reached || data_resolver->all_reached_end()
+                               || row_count >= original_row_limit() || live_partition_count >= original_partition_limit())
                         && !data_resolver->any_partition_short_read()) {
-                    auto result = ::make_foreign(::make_lw_shared(
-                            to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, _cmd->row_limit, cmd->partition_limit)));
+                    if (filtered_limit_reached && !data_resolver->all_reached_end()
+                            && row_count < original_row_limit() && live_partition_count < original_partition_limit()) {
+                        filtered_result->mark_as_short_read();
+                    }
+                    auto result = ::make_foreign(::make_lw_shared(filtered_result ? std::move(*filtered_result)
+                            : to_data_query_result(std::move(*rr_opt), _schema, _cmd->slice, _cmd->row_limit, cmd->partition_limit)));
                     // wait for write to complete before returning result to prevent multiple concurrent read requests to
                     // trigger repair multiple times and to prevent quorum read to return an old value, even after a quorum
                     // another read had returned a newer value (but the newer value had not yet been sent to the other replicas)
@@ -2647,7 +2763,15 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                         auto ret = std::min(static_cast<uint64_t>(query::max_rows), l == 0 ? t + 1 : ((t * t) / l) + 1);
                         return static_cast<uint32_t>(ret);
                     };
-                    if (data_resolver->any_partition_short_read() || data_resolver->increase_per_partition_limit()) {
+                    if (filtered && !data_resolver->any_partition_short_read() && !data_resolver->increase_per_partition_limit()) {
+                        // How many of the reconciled rows pass the filters says little about
+                        // the rows the replicas have not sent yet, so just read further.
+                        auto new_limit = std::min(static_cast<uint64_t>(query::max_rows), 2 * static_cast<uint64_t>(cmd->row_limit));
+                        if (cmd->row_limit < max_filtered_row_limit()) {
+                            new_limit = std::min(new_limit, static_cast<uint64_t>(max_filtered_row_limit()));
+                        }
+                        _retry_cmd->row_limit = static_cast<uint32_t>(new_limit);
+                    } else if (data_resolver->any_partition_short_read() || data_resolver->increase_per_partition_limit()) {
                         // The number of live rows was bounded by the per partition limit.
                         auto new_limit = x(cmd->slice.partition_row_limit(), data_resolver->max_per_partition_live_count());
                         _retry_cmd->slice.set_partition_row_limit(new_limit);
@@ -2749,8 +2873,8 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
 
 class never_speculating_read_executor : public abstract_read_executor {
 public:
-    never_speculating_read_executor(schema_ptr s, lw_shared_ptr<column_family> cf, shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr, db::consistency_level cl, std::vector<gms::inet_address> targets, tracing::trace_state_ptr trace_state) :
-                                        abstract_read_executor(std::move(s), std::move(cf), std::move(proxy), std::move(cmd), std::move(pr), cl, 0, std::move(targets), std::move(trace_state)) {
+    never_speculating_read_executor(schema_ptr s, lw_shared_ptr<column_family> cf, shared_ptr<storage_proxy> proxy, lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector prs, db::consistency_level cl, std::vector<gms::inet_address> targets, tracing::trace_state_ptr trace_state) :
+                                        abstract_read_executor(std::move(s), std::move(cf), std::move(proxy), std::move(cmd), std::move(prs), cl, 0, std::move(targets), std::move(trace_state)) {
         _block_for = _targets.size();
     }
 };
@@ -2844,8 +2968,9 @@ db::read_repair_decision storage_proxy::new_read_repair_decision(const schema& s
     return db::read_repair_decision::NONE;
 }
 
-::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_ptr<query::read_command> cmd, dht::partition_range pr, db::consistency_level cl, tracing::trace_state_ptr trace_state) {
-    const dht::token& token = pr.start()->value().token();
+::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector prs, db::consistency_level cl, tracing::trace_state_ptr trace_state) {
+    // All ranges share the replicas of the first one
+    const dht::token& token = prs.front().start()->value().token();
     schema_ptr schema = local_schema_registry().get(cmd->schema_version);
     keyspace& ks = _db.local().find_keyspace(schema->ks_name());
     speculative_retry::type retry_type = schema->speculative_retry().get_type();
@@ -2883,21 +3008,21 @@ ::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_
     // Speculative retry is disabled *OR* there are simply no extra replicas to speculate.
     if (retry_type == speculative_retry::type::NONE || block_for == all_replicas.size()
             || (repair_decision == db::read_repair_decision::DC_LOCAL && is_datacenter_local(cl) && block_for == target_replicas.size())) {
-        return ::make_shared<never_speculating_read_executor>(schema, cf, p, cmd, std::move(pr), cl, std::move(target_replicas), std::move(trace_state));
+        return ::make_shared<never_speculating_read_executor>(schema, cf, p, cmd, std::move(prs), cl, std::move(target_replicas), std::move(trace_state));
     }
 
     if (target_replicas.size() == all_replicas.size()) {
         // CL.ALL, RRD.GLOBAL or RRD.DC_LOCAL and a single-DC.
         // We are going to contact every node anyway, so ask for 2 full data requests instead of 1, for redundancy
         // (same amount of requests in total, but we turn 1 digest request into a full blown data request).
-        return ::make_shared<always_speculating_read_executor>(schema, cf, p, cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state));
+        return ::make_shared<always_speculating_read_executor>(schema, cf, p, cmd, std::move(prs), cl, block_for, std::move(target_replicas), std::move(trace_state));
     }
 
     // RRD.NONE or RRD.DC_LOCAL w/ multiple DCs.
     if (target_replicas.size() == block_for) { // If RRD.DC_LOCAL extra replica may already be present
         if (is_datacenter_local(cl) && !db::is_local(extra_replica)) {
             slogger.trace("read executor no extra target to speculate");
-            return ::make_shared<never_speculating_read_executor>(schema, cf, p, cmd, std::move(pr), cl, std::move(target_replicas), std::move(trace_state));
+            return ::make_shared<never_speculating_read_executor>(schema, cf, p, cmd, std::move(prs), cl, std::move(target_replicas), std::move(trace_state));
         } else {
             target_replicas.push_back(extra_replica);
             slogger.trace("creating read executor with extra target {}", extra_replica);
@@ -2905,15 +3030,15 @@ ::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_
     }
 
     if (retry_type == speculative_retry::type::ALWAYS) {
-        return ::make_shared<always_speculating_read_executor>(schema, cf, p, cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state));
+        return ::make_shared<always_speculating_read_executor>(schema, cf, p, cmd, std::move(prs), cl, block_for, std::move(target_replicas), std::move(trace_state));
     } else {// PERCENTILE or CUSTOM.
-        return ::make_shared<speculating_read_executor>(schema, cf, p, cmd, std::move(pr), cl, block_for, std::move(target_replicas), std::move(trace_state));
+        return ::make_shared<speculating_read_executor>(schema, cf, p, cmd, std::move(prs), cl, block_for, std::move(target_replicas), std::move(trace_state));
     }
 }
 
 future<query::result_digest, api::timestamp_type, cache_temperature>
-storage_proxy::query_result_local_digest(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr, tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout, query::digest_algorithm da, uint64_t max_size) {
-    return query_result_local(std::move(s), std::move(cmd), pr, query::result_options::only_digest(da), std::move(trace_state), timeout, max_size).then([] (foreign_ptr<lw_shared_ptr<query::result>> result, cache_temperature hit_rate) {
+storage_proxy::query_result_local_digest(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs, tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout, query::digest_algorithm da, uint64_t max_size) {
+    return query_result_local(std::move(s), std::move(cmd), prs, query::result_options::only_digest(da), std::move(trace_state), timeout, max_size).then([] (foreign_ptr<lw_shared_ptr<query::result>> result, cache_temperature hit_rate) {
         return make_ready_future<query::result_digest, api::timestamp_type, cache_temperature>(*result->digest(), result->last_modified(), hit_rate);
     });
 }
@@ -2939,6 +3064,35 @@ storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_comman
     }
 }
 
+future<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>
+storage_proxy::query_result_local(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs, query::result_options opts,
+                                  tracing::trace_state_ptr trace_state, storage_proxy::clock_type::time_point timeout, uint64_t max_size) {
+    if (prs.size() == 1) {
+        return query_result_local(std::move(s), std::move(cmd), prs.front(), opts, std::move(trace_state), timeout, max_size);
+    }
+    // Each partition is read on its own shard, all of them at once. The results
+    // are merged in the order of the ranges, which the coordinator sorted in ring order,
+    // and their digests combined so that data and digest replicas agree.
+    using result_and_hit_rate = std::pair<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>;
+    return do_with(std::vector<stdx::optional<result_and_hit_rate>>(prs.size()), [this, s = std::move(s), cmd = std::move(cmd), &prs, opts, trace_state = std::move(trace_state), timeout, max_size]
+            (std::vector<stdx::optional<result_and_hit_rate>>& results) mutable {
+        return parallel_for_each(boost::irange<size_t>(0, prs.size()), [this, &results, &prs, s, cmd, opts, trace_state, timeout, max_size] (size_t i) {
+            return query_result_local(s, cmd, prs[i], opts, trace_state, timeout, max_size).then([&results, i] (foreign_ptr<lw_shared_ptr<query::result>> r, cache_temperature ht) {
+                results[i].emplace(std::move(r), ht);
+            });
+        }).then([&results, cmd, opts] {
+            query::result_merger merger(cmd->row_limit, cmd->partition_limit, opts.digest_algo);
+            merger.reserve(results.size());
+            float hit_rate = 0;
+            for (auto&& r : results) {
+                hit_rate += float(r->second);
+                merger(std::move(r->first));
+            }
+            return make_ready_future<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>(merger.get(), cache_temperature(hit_rate / results.size()));
+        });
+    });
+}
+
 void storage_proxy::handle_read_error(std::exception_ptr eptr, bool range) {
     try {
         std::rethrow_exception(eptr);
@@ -2965,7 +3119,7 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd, dht::parti
         if (!pr.is_singular()) {
             throw std::runtime_error("mixed singular and non singular range are not supported");
         }
-        exec.push_back(get_read_executor(cmd, std::move(pr), cl, trace_state));
+        exec.push_back(get_read_executor(cmd, dht::partition_range_vector{std::move(pr)}, cl, trace_state));
     }
 
     query::result_merger merger(cmd->row_limit, cmd->partition_limit);
@@ -2988,6 +3142,153 @@ storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd, dht::parti
     });
 }
 
+// Reads the partitions of a multi-partition point query, like "pk IN (...)", with
+// one read for all partitions having the same replicas, instead of one read for
+// each partition. The replicas return the partitions of a read in ring order, so
+// the results are put back in the order of the ranges. When a read stopped early,
+// at a limit or with a short read, the partitions it might not have reached are
+// read the ordinary way, which keeps the limits applying in the order of the ranges.
+future<foreign_ptr<lw_shared_ptr<query::result>>>
+storage_proxy::query_singular_grouped(lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector&& partition_ranges, db::consistency_level cl,
+                                      tracing::trace_state_ptr trace_state,
+                                      clock_type::time_point timeout) {
+    using per_range_results = std::vector<stdx::optional<foreign_ptr<lw_shared_ptr<query::result>>>>;
+    schema_ptr schema = local_schema_registry().get(cmd->schema_version);
+    keyspace& ks = _db.local().find_keyspace(schema->ks_name());
+    auto ranges = make_lw_shared<dht::partition_range_vector>(std::move(partition_ranges));
+
+    std::vector<std::vector<size_t>> groups;
+    std::map<std::vector<gms::inet_address>, size_t> group_of_replicas;
+    for (size_t i = 0; i < ranges->size(); ++i) {
+        auto& pr = (*ranges)[i];
+        if (!pr.is_singular()) {
+            throw std::runtime_error("mixed singular and non singular range are not supported");
+        }
+        auto it = group_of_replicas.emplace(get_live_sorted_endpoints(ks, pr.start()->value().token()), groups.size()).first;
+        if (it->second == groups.size()) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+
+    // Partition keys tell which range each partition of a grouped read belongs to
+    auto group_cmd = make_lw_shared<query::read_command>(*cmd);
+    group_cmd->slice.options.set<query::partition_slice::option::send_partition_key>();
+
+    dht::ring_position_comparator cmp(*schema);
+    std::vector<::shared_ptr<abstract_read_executor>> exec;
+    exec.reserve(groups.size());
+    for (auto& group : groups) {
+        if (group.size() == 1) {
+            exec.push_back(get_read_executor(cmd, dht::partition_range_vector{(*ranges)[group.front()]}, cl, trace_state));
+            continue;
+        }
+        boost::sort(group, [&] (size_t a, size_t b) {
+            return cmp((*ranges)[a].start()->value(), (*ranges)[b].start()->value()) < 0;
+        });
+        dht::partition_range_vector prs;
+        prs.reserve(group.size());
+        for (auto i : group) {
+            prs.push_back((*ranges)[i]);
+        }
+        _stats.grouped_reads += group.size();
+        exec.push_back(get_read_executor(group_cmd, std::move(prs), cl, trace_state));
+    }
+    tracing::trace(trace_state, "Reading {} partitions with {} reads", ranges->size(), exec.size());
+
+    auto f = do_with(std::move(exec), std::vector<foreign_ptr<lw_shared_ptr<query::result>>>(), [timeout] (auto& exec, auto& results) {
+        results.resize(exec.size());
+        return parallel_for_each(boost::irange<size_t>(0, exec.size()), [&exec, &results, timeout] (size_t i) {
+            auto rex = exec[i];
+            utils::latency_counter lc;
+            lc.start();
+            return rex->execute(timeout).then([&results, i] (foreign_ptr<lw_shared_ptr<query::result>> r) {
+                results[i] = std::move(r);
+            }).finally([lc, rex] () mutable {
+                if (lc.is_start()) {
+                    rex->get_cf()->add_coordinator_read_latency(lc.stop().latency());
+                }
+            });
+        }).then([&results] {
+            return std::move(results);
+        });
+    }).then([schema, cmd, ranges, groups = std::move(groups)] (std::vector<foreign_ptr<lw_shared_ptr<query::result>>> results) {
+        // Disengaged for the ranges a grouped read might not have reached, null for
+        // partitions which don't exist.
+        per_range_results per_range(ranges->size());
+        dht::ring_position_comparator cmp(*schema);
+        for (size_t g = 0; g < groups.size(); ++g) {
+            auto& group = groups[g];
+            if (group.size() == 1) {
+                per_range[group.front()] = std::move(results[g]);
+                continue;
+            }
+            auto partitions = query::split_by_partition(*results[g]);
+            std::vector<dht::decorated_key> keys;
+            keys.reserve(partitions.size());
+            uint32_t row_count = 0;
+            for (auto&& p : partitions) {
+                keys.push_back(dht::global_partitioner().decorate_key(*schema, p.key));
+                row_count += *p.result->row_count();
+            }
+            bool complete = !results[g]->is_short_read() && row_count < cmd->row_limit && partitions.size() < cmd->partition_limit;
+            size_t j = 0;
+            for (auto i : group) {
+                auto& pos = (*ranges)[i].start()->value();
+                if (!complete && (keys.empty() || cmp(keys.back(), pos) <= 0)) {
+                    continue;
+                }
+                while (j < keys.size() && cmp(keys[j], pos) < 0) {
+                    ++j;
+                }
+                if (j < keys.size() && cmp(keys[j], pos) == 0) {
+                    per_range[i] = make_foreign(partitions[j].result);
+                } else {
+                    per_range[i] = foreign_ptr<lw_shared_ptr<query::result>>();
+                }
+            }
+        }
+        return per_range;
+    }).handle_exception([p = shared_from_this()] (std::exception_ptr eptr) {
+        p->handle_read_error(eptr, false);
+        return make_exception_future<per_range_results>(eptr);
+    });
+
+    return f.then([p = shared_from_this(), cmd, ranges, cl, trace_state = std::move(trace_state), timeout] (per_range_results per_range) mutable {
+        query::result_merger merger(cmd->row_limit, cmd->partition_limit);
+        merger.reserve(per_range.size() + 1);
+        uint32_t row_count = 0;
+        uint32_t partition_count = 0;
+        bool counts_known = true;
+        bool done = false;
+        auto it = per_range.begin();
+        for (; it != per_range.end() && *it && !done; ++it) {
+            auto& r = **it;
+            if (!r) {
+                continue;
+            }
+            if (r->row_count() && r->partition_count()) {
+                row_count += *r->row_count();
+                partition_count += *r->partition_count();
+            } else {
+                counts_known = false;
+            }
+            done = r->is_short_read() || (counts_known && (row_count >= cmd->row_limit || partition_count >= cmd->partition_limit));
+            merger(std::move(r));
+        }
+        if (done || it == per_range.end()) {
+            return make_ready_future<foreign_ptr<lw_shared_ptr<query::result>>>(merger.get());
+        }
+        auto first = ranges->begin() + std::distance(per_range.begin(), it);
+        dht::partition_range_vector rest(std::make_move_iterator(first), std::make_move_iterator(ranges->end()));
+        tracing::trace(trace_state, "Reading {} remaining partitions one by one", rest.size());
+        return p->query_singular(cmd, std::move(rest), cl, std::move(trace_state), timeout).then([merger = std::move(merger)] (foreign_ptr<lw_shared_ptr<query::result>> r) mutable {
+            merger(std::move(r));
+            return merger.get();
+        });
+    });
+}
+
 future<std::vector<foreign_ptr<lw_shared_ptr<query::result>>>>
 storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::time_point timeout, std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
         lw_shared_ptr<query::read_command> cmd, db::consistency_level cl, dht::partition_range_vector::iterator&& i,
@@ -3076,7 +3377,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
             throw;
         }
 
-        exec.push_back(::make_shared<range_slice_read_executor>(schema, cf.shared_from_this(), p, cmd, std::move(range), cl, std::move(filtered_endpoints), trace_state));
+        exec.push_back(::make_shared<range_slice_read_executor>(schema, cf.shared_from_this(), p, cmd, dht::partition_range_vector{std::move(range)}, cl, std::move(filtered_endpoints), trace_state));
     }
 
     query::result_merger merger(cmd->row_limit, cmd->partition_limit);
@@ -3209,7 +3510,10 @@ storage_proxy::do_query(schema_ptr s,
 
     if (query::is_single_partition(partition_ranges[0])) { // do not support mixed partitions (yet?)
         try {
-            return query_singular(cmd, std::move(partition_ranges), cl, std::move(trace_state), std::move(timeout)).finally([lc, p] () mutable {
+            auto f = partition_ranges.size() > 1 && service::get_local_storage_service().cluster_supports_multi_partition_point_reads()
+                   ? query_singular_grouped(cmd, std::move(partition_ranges), cl, std::move(trace_state), std::move(timeout))
+                   : query_singular(cmd, std::move(partition_ranges), cl, std::move(trace_state), std::move(timeout));
+            return f.finally([lc, p] () mutable {
                     p->_stats.read.mark(lc.stop().latency());
                     if (lc.is_start()) {
                         p->_stats.estimated_read.add(lc.latency(), p->_stats.read.hist.count);
@@ -3786,6 +4090,67 @@ void storage_proxy::init_messaging_service() {
             });
         });
     });
+    ms.register_mutations([] (const rpc::client_info& cinfo, rpc::opt_time_point t, std::vector<frozen_mutation> in, gms::inet_address reply_to, unsigned shard, std::vector<storage_proxy::response_id_type> response_ids, rpc::optional<std::experimental::optional<tracing::trace_info>> trace_info) {
+        tracing::trace_state_ptr trace_state_ptr;
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+
+        if (trace_info && *trace_info) {
+            tracing::trace_info& tr_info = **trace_info;
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(tr_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "Message with {} mutations received from /{}", in.size(), src_addr.addr);
+        }
+
+        storage_proxy::clock_type::time_point timeout;
+        if (!t) {
+            auto timeout_in_ms = get_local_shared_storage_proxy()->_db.local().get_config().write_request_timeout_in_ms();
+            timeout = clock_type::now() + std::chrono::milliseconds(timeout_in_ms);
+        } else {
+            timeout = *t;
+        }
+
+        return do_with(std::move(in), std::move(response_ids), get_local_shared_storage_proxy(),
+                [src_addr = std::move(src_addr), reply_to, shard, trace_state_ptr, timeout] (const std::vector<frozen_mutation>& mutations, const std::vector<storage_proxy::response_id_type>& response_ids, shared_ptr<storage_proxy>& p) {
+            p->_stats.received_mutations += mutations.size();
+            // Each mutation is applied on its owning shard and acknowledged on its own,
+            // so that the coordinator sees the same responses as for separate MUTATION messages.
+            return parallel_for_each(boost::irange<size_t>(0, mutations.size()), [&mutations, &response_ids, &p, src_addr, reply_to, shard, timeout] (size_t i) {
+                auto& m = mutations[i];
+                auto response_id = response_ids[i];
+                return futurize<void>::apply([&m, &p, timeout, src_addr] () mutable {
+                    return get_schema_for_write(m.schema_version(), std::move(src_addr)).then([&m, &p, timeout] (schema_ptr s) {
+                        return p->mutate_locally(std::move(s), m, timeout);
+                    });
+                }).then_wrapped([reply_to, shard, response_id] (future<> f) {
+                    auto& ms = netw::get_local_messaging_service();
+                    if (!f.failed()) {
+                        f.ignore_ready_future();
+                        return ms.send_mutation_done(netw::messaging_service::msg_addr{reply_to, shard}, shard, response_id);
+                    }
+                    auto eptr = f.get_exception();
+                    seastar::log_level l = seastar::log_level::warn;
+                    try {
+                        std::rethrow_exception(eptr);
+                    } catch (timed_out_error&) {
+                        // ignore timeouts so that logs are not flooded.
+                        // database total_writes_timedout counter was incremented.
+                        l = seastar::log_level::debug;
+                    } catch (...) {
+                        // ignore
+                    }
+                    slogger.log(l, "Failed to apply mutation from {}#{}: {}", reply_to, shard, eptr);
+                    return ms.send_mutation_failed(netw::messaging_service::msg_addr{reply_to, shard}, shard, response_id, 1);
+                }).then_wrapped([] (future<> f) {
+                    // ignore errors of the reply, the coordinator will time out
+                    f.ignore_ready_future();
+                });
+            }).then([] {
+                return netw::messaging_service::no_wait();
+            }).finally([trace_state_ptr] {
+                tracing::trace(trace_state_ptr, "Mutations handling is done");
+            });
+        });
+    });
     ms.register_mutation_done([] (const rpc::client_info& cinfo, unsigned shard, storage_proxy::response_id_type response_id) {
         auto& from = cinfo.retrieve_auxiliary<gms::inet_address>("baddr");
         return get_storage_proxy().invoke_on(shard, [from, response_id] (storage_proxy& sp) {
@@ -3800,7 +4165,7 @@ void storage_proxy::init_messaging_service() {
             return netw::messaging_service::no_wait();
         });
     });
-    ms.register_read_data([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> oda) {
+    ms.register_read_data([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> oda, rpc::optional<dht::partition_range_vector> oar) {
         tracing::trace_state_ptr trace_state_ptr;
         auto src_addr = netw::messaging_service::get_source(cinfo);
         if (cmd.trace_info) {
@@ -3810,10 +4175,10 @@ void storage_proxy::init_messaging_service() {
         }
         auto da = oda.value_or(query::digest_algorithm::MD5);
         auto max_size = cinfo.retrieve_auxiliary<uint64_t>("max_result_size");
-        return do_with(std::move(pr), get_local_shared_storage_proxy(), std::move(trace_state_ptr), [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), da, max_size, t] (compat::wrapping_partition_range& pr, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
+        return do_with(std::move(pr), oar ? std::move(*oar) : dht::partition_range_vector(), get_local_shared_storage_proxy(), std::move(trace_state_ptr), [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), da, max_size, t] (compat::wrapping_partition_range& pr, dht::partition_range_vector& prs, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
             p->_stats.replica_data_reads++;
             auto src_ip = src_addr.addr;
-            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, da, &pr, &p, &trace_state_ptr, max_size, t] (schema_ptr s) {
+            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, da, &pr, &prs, &p, &trace_state_ptr, max_size, t] (schema_ptr s) {
                 auto pr2 = compat::unwrap(std::move(pr), *s);
                 if (pr2.second) {
                     // this function assumes singular queries but doesn't validate
@@ -3823,13 +4188,14 @@ void storage_proxy::init_messaging_service() {
                 opts.digest_algo = da;
                 opts.request = da == query::digest_algorithm::none ? query::result_request::only_result : query::result_request::result_and_digest;
                 auto timeout = t ? *t : db::no_timeout;
-                return p->query_result_local(std::move(s), cmd, std::move(pr2.first), opts, trace_state_ptr, timeout, max_size);
+                prs.insert(prs.begin(), std::move(pr2.first));
+                return p->query_result_local(std::move(s), cmd, prs, opts, trace_state_ptr, timeout, max_size);
             }).finally([&trace_state_ptr, src_ip] () mutable {
                 tracing::trace(trace_state_ptr, "read_data handling is done, sending a response to /{}", src_ip);
             });
         });
     });
-    ms.register_read_mutation_data([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr) {
+    ms.register_read_mutation_data([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr, rpc::optional<dht::partition_range_vector> oar) {
         tracing::trace_state_ptr trace_state_ptr;
         auto src_addr = netw::messaging_service::get_source(cinfo);
         if (cmd.trace_info) {
@@ -3839,26 +4205,33 @@ void storage_proxy::init_messaging_service() {
         }
         auto max_size = cinfo.retrieve_auxiliary<uint64_t>("max_result_size");
         return do_with(std::move(pr),
+                       oar ? std::move(*oar) : dht::partition_range_vector(),
                        get_local_shared_storage_proxy(),
                        std::move(trace_state_ptr),
                        compat::one_or_two_partition_ranges({}),
                        [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), max_size, t] (
                                compat::wrapping_partition_range& pr,
+                               dht::partition_range_vector& prs,
                                shared_ptr<storage_proxy>& p,
                                tracing::trace_state_ptr& trace_state_ptr,
                                compat::one_or_two_partition_ranges& unwrapped) mutable {
             p->_stats.replica_mutation_data_reads++;
             auto src_ip = src_addr.addr;
-            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, &pr, &p, &trace_state_ptr, max_size, &unwrapped, t] (schema_ptr s) mutable {
+            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, &pr, &prs, &p, &trace_state_ptr, max_size, &unwrapped, t] (schema_ptr s) mutable {
                 unwrapped = compat::unwrap(std::move(pr), *s);
                 auto timeout = t ? *t : db::no_timeout;
+                if (!prs.empty()) {
+                    // Only point reads come with additional ranges, so the first one doesn't wrap
+                    prs.insert(prs.begin(), std::move(unwrapped.first));
+                    return p->query_mutations_locally(std::move(s), std::move(cmd), prs, timeout, trace_state_ptr, max_size);
+                }
                 return p->query_mutations_locally(std::move(s), std::move(cmd), unwrapped, timeout, trace_state_ptr, max_size);
             }).finally([&trace_state_ptr, src_ip] () mutable {
                 tracing::trace(trace_state_ptr, "read_mutation_data handling is done, sending a response to /{}", src_ip);
             });
         });
     });
-    ms.register_read_digest([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> oda) {
+    ms.register_read_digest([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> oda, rpc::optional<dht::partition_range_vector> oar) {
         tracing::trace_state_ptr trace_state_ptr;
         auto src_addr = netw::messaging_service::get_source(cinfo);
         if (cmd.trace_info) {
@@ -3868,17 +4241,18 @@ void storage_proxy::init_messaging_service() {
         }
         auto da = oda.value_or(query::digest_algorithm::MD5);
         auto max_size = cinfo.retrieve_auxiliary<uint64_t>("max_result_size");
-        return do_with(std::move(pr), get_local_shared_storage_proxy(), std::move(trace_state_ptr), [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), da, max_size, t] (compat::wrapping_partition_range& pr, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
+        return do_with(std::move(pr), oar ? std::move(*oar) : dht::partition_range_vector(), get_local_shared_storage_proxy(), std::move(trace_state_ptr), [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), da, max_size, t] (compat::wrapping_partition_range& pr, dht::partition_range_vector& prs, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
             p->_stats.replica_digest_reads++;
             auto src_ip = src_addr.addr;
-            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, &pr, &p, &trace_state_ptr, max_size, t, da] (schema_ptr s) {
+            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, &pr, &prs, &p, &trace_state_ptr, max_size, t, da] (schema_ptr s) {
                 auto pr2 = compat::unwrap(std::move(pr), *s);
                 if (pr2.second) {
                     // this function assumes singular queries but doesn't validate
                     throw std::runtime_error("READ_DIGEST called with wrapping range");
                 }
                 auto timeout = t ? *t : db::no_timeout;
-                return p->query_result_local_digest(std::move(s), cmd, std::move(pr2.first), trace_state_ptr, timeout, da, max_size);
+                prs.insert(prs.begin(), std::move(pr2.first));
+                return p->query_result_local_digest(std::move(s), cmd, prs, trace_state_ptr, timeout, da, max_size);
             }).finally([&trace_state_ptr, src_ip] () mutable {
                 tracing::trace(trace_state_ptr, "read_digest handling is done, sending a response to /{}", src_ip);
             });
@@ -3904,6 +4278,7 @@ void storage_proxy::init_messaging_service() {
 void storage_proxy::uninit_messaging_service() {
     auto& ms = netw::get_local_messaging_service();
     ms.unregister_mutation();
+    ms.unregister_mutations();
     ms.unregister_mutation_done();
     ms.unregister_mutation_failed();
     ms.unregister_read_data();
@@ -4113,6 +4488,37 @@ storage_proxy::query_mutations_locally(schema_ptr s, lw_shared_ptr<query::read_c
     }
 }
 
+future<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>
+storage_proxy::query_mutations_locally(schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs,
+                                       storage_proxy::clock_type::time_point timeout,
+                                       tracing::trace_state_ptr trace_state, uint64_t max_size) {
+    if (prs.size() == 1) {
+        return query_mutations_locally(std::move(s), std::move(cmd), prs.front(), timeout, std::move(trace_state), max_size);
+    }
+    if (!boost::algorithm::all_of(prs, std::mem_fn(&dht::partition_range::is_singular))) {
+        return query_nonsingular_mutations_locally(std::move(s), std::move(cmd), dht::partition_range_vector(prs), std::move(trace_state), max_size, timeout);
+    }
+    // Point reads of several partitions: as in query_result_local(), read each
+    // partition on its own shard, all of them at once.
+    return do_with(mutation_result_merger{s, cmd}, 0.0f, [this, s, cmd, &prs, timeout, trace_state = std::move(trace_state), max_size]
+            (mutation_result_merger& mrm, float& hit_rate) {
+        return _db.local().get_result_memory_limiter().new_mutation_read(max_size).then([this, s, cmd, &prs, timeout, trace_state, max_size, &mrm, &hit_rate]
+                (query::result_memory_accounter ma) {
+            mrm.memory() = std::move(ma);
+            return parallel_for_each(boost::irange<unsigned>(0, prs.size()), [this, s, cmd, &prs, timeout, trace_state, max_size, &mrm, &hit_rate] (unsigned i) {
+                return query_mutations_locally(s, cmd, prs[i], timeout, trace_state, max_size).then([&mrm, &hit_rate, i]
+                        (foreign_ptr<lw_shared_ptr<reconcilable_result>> r, cache_temperature ht) {
+                    hit_rate += float(ht);
+                    mrm.add_result(i, std::move(r));
+                });
+            });
+        }).then([&mrm, &hit_rate, n = prs.size()] {
+            return make_ready_future<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>(
+                    make_foreign(make_lw_shared(std::move(mrm).get())), cache_temperature(hit_rate / n));
+        });
+    });
+}
+
 }
 
 namespace {
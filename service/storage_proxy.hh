@@ -90,6 +90,19 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy> /*imp
         response_id_type release();
     };
 
+    // A mutation of a multi-mutation write, waiting to be sent to a replica
+    // together with other mutations destined to it.
+    struct grouped_mutation {
+        response_id_type id;
+        ::shared_ptr<abstract_write_response_handler> handler;
+        lw_shared_ptr<const frozen_mutation> mutation;
+    };
+    using mutation_groups = std::unordered_map<gms::inet_address, std::vector<grouped_mutation>>;
+    // Sends the mutations of a group, along with the ids of their response handlers,
+    // to their replica in a single message.
+    using mutation_group_sender = std::function<future<> (gms::inet_address dest, const std::vector<lw_shared_ptr<const frozen_mutation>>& fms,
+            std::vector<response_id_type> ids, tracing::trace_state_ptr tr_state)>;
+
     static const sstring COORDINATOR_STATS_CATEGORY;
     static const sstring REPLICA_STATS_CATEGORY;
 
@@ -159,6 +172,12 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy> /*imp
         // number of mutations received as a coordinator
         uint64_t received_mutations = 0;
 
+        // number of mutations sent to replicas as part of a multi-mutation message
+        uint64_t grouped_mutations = 0;
+
+        // number of partitions read from replicas as part of a multi-partition read
+        uint64_t grouped_reads = 0;
+
         // number of counter updates received as a leader
         uint64_t received_counter_updates = 0;
 
@@ -242,7 +261,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy> /*imp
             const std::vector<gms::inet_address>& pending_endpoints, std::vector<gms::inet_address>, tracing::trace_state_ptr tr_state);
     response_id_type create_write_response_handler(const mutation&, db::consistency_level cl, db::write_type type, tracing::trace_state_ptr tr_state);
     response_id_type create_write_response_handler(const std::unordered_map<gms::inet_address, std::experimental::optional<mutation>>&, db::consistency_level cl, db::write_type type, tracing::trace_state_ptr tr_state);
-    void send_to_live_endpoints(response_id_type response_id, clock_type::time_point timeout);
+    void send_to_live_endpoints(response_id_type response_id, clock_type::time_point timeout, mutation_groups* groups = nullptr);
+    void send_mutation_groups(mutation_groups groups, clock_type::time_point timeout);
+    void send_mutation_groups(mutation_groups groups, mutation_group_sender send);
     template<typename Range>
     size_t hint_to_dead_endpoints(std::unique_ptr<mutation_holder>& mh, const Range& targets, tracing::trace_state_ptr tr_state) noexcept;
     void hint_to_dead_endpoints(response_id_type, db::consistency_level);
@@ -251,13 +272,24 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy> /*imp
     std::vector<gms::inet_address> get_live_endpoints(keyspace& ks, const dht::token& token);
     std::vector<gms::inet_address> get_live_sorted_endpoints(keyspace& ks, const dht::token& token);
     db::read_repair_decision new_read_repair_decision(const schema& s);
-    ::shared_ptr<abstract_read_executor> get_read_executor(lw_shared_ptr<query::read_command> cmd, dht::partition_range pr, db::consistency_level cl, tracing::trace_state_ptr trace_state);
+    ::shared_ptr<abstract_read_executor> get_read_executor(lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector prs, db::consistency_level cl, tracing::trace_state_ptr trace_state);
+    future<foreign_ptr<lw_shared_ptr<query::result>>> query_singular_grouped(lw_shared_ptr<query::read_command> cmd,
+                                                                             dht::partition_range_vector&& partition_ranges,
+                                                                             db::consistency_level cl,
+                                                                             tracing::trace_state_ptr trace_state,
+                                                                             clock_type::time_point timeout);
     future<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature> query_result_local(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
                                                                            query::result_options opts,
                                                                            tracing::trace_state_ptr trace_state,
                                                                            clock_type::time_point timeout,
                                                                            uint64_t max_size = query::result_memory_limiter::maximum_result_size);
-    future<query::result_digest, api::timestamp_type, cache_temperature> query_result_local_digest(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range& pr,
+    // Reads several singular ranges, in parallel, merging the results in the order of the ranges.
+    future<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature> query_result_local(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs,
+                                                                           query::result_options opts,
+                                                                           tracing::trace_state_ptr trace_state,
+                                                                           clock_type::time_point timeout,
+                                                                           uint64_t max_size = query::result_memory_limiter::maximum_result_size);
+    future<query::result_digest, api::timestamp_type, cache_temperature> query_result_local_digest(schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector& prs,
                                                                                                    tracing::trace_state_ptr trace_state,
                                                                                                    clock_type::time_point timeout,
                                                                                                    query::digest_algorithm da,
@@ -435,6 +467,7 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy> /*imp
     friend class abstract_read_executor;
     friend class abstract_write_response_handler;
     friend class speculating_read_executor;
+    friend class storage_proxy_test;
 };
 
 extern distributed<storage_proxy> _the_storage_proxy;
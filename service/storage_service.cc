@@ -94,6 +94,12 @@ static const sstring CORRECT_NON_COMPOUND_RANGE_TOMBSTONES = "CORRECT_NON_COMPOU
 static const sstring WRITE_FAILURE_REPLY_FEATURE = "WRITE_FAILURE_REPLY";
 static const sstring XXHASH_FEATURE = "XXHASH";
 static const sstring ROLES_FEATURE = "ROLES";
+static const sstring ROW_HASHES_DIGEST_FEATURE = "ROW_HASHES_DIGEST";
+static const sstring BATCHED_MUTATIONS_FEATURE = "BATCHED_MUTATIONS";
+static const sstring MULTI_PARTITION_POINT_READS_FEATURE = "MULTI_PARTITION_POINT_READS";
+static const sstring REPLICA_ROW_COUNT_FEATURE = "REPLICA_ROW_COUNT";
+static const sstring REPLICA_FILTERING_FEATURE = "REPLICA_FILTERING";
+static const sstring BYPASS_CACHE_FEATURE = "BYPASS_CACHE";
 
 distributed<storage_service> _the_storage_service;
 
@@ -144,6 +150,12 @@ sstring storage_service::get_config_supported_features() {
         WRITE_FAILURE_REPLY_FEATURE,
         XXHASH_FEATURE,
         ROLES_FEATURE,
+        ROW_HASHES_DIGEST_FEATURE,
+        BATCHED_MUTATIONS_FEATURE,
+        MULTI_PARTITION_POINT_READS_FEATURE,
+        REPLICA_ROW_COUNT_FEATURE,
+        REPLICA_FILTERING_FEATURE,
+        BYPASS_CACHE_FEATURE,
     };
     if (service::get_local_storage_service()._db.local().get_config().experimental()) {
         features.push_back(MATERIALIZED_VIEWS_FEATURE);
@@ -358,6 +370,12 @@ void storage_service::register_features() {
     _write_failure_reply_feature = gms::feature(WRITE_FAILURE_REPLY_FEATURE);
     _xxhash_feature = gms::feature(XXHASH_FEATURE);
     _roles_feature = gms::feature(ROLES_FEATURE);
+    _row_hashes_digest_feature = gms::feature(ROW_HASHES_DIGEST_FEATURE);
+    _batched_mutations_feature = gms::feature(BATCHED_MUTATIONS_FEATURE);
+    _multi_partition_point_reads_feature = gms::feature(MULTI_PARTITION_POINT_READS_FEATURE);
+    _replica_row_count_feature = gms::feature(REPLICA_ROW_COUNT_FEATURE);
+    _replica_filtering_feature = gms::feature(REPLICA_FILTERING_FEATURE);
+    _bypass_cache_feature = gms::feature(BYPASS_CACHE_FEATURE);
 
     if (_db.local().get_config().experimental()) {
         _materialized_views_feature = gms::feature(MATERIALIZED_VIEWS_FEATURE);
@@ -278,6 +278,12 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     gms::feature _write_failure_reply_feature;
     gms::feature _xxhash_feature;
     gms::feature _roles_feature;
+    gms::feature _row_hashes_digest_feature;
+    gms::feature _batched_mutations_feature;
+    gms::feature _multi_partition_point_reads_feature;
+    gms::feature _replica_row_count_feature;
+    gms::feature _replica_filtering_feature;
+    gms::feature _bypass_cache_feature;
 public:
     void enable_all_features() {
         _range_tombstones_feature.enable();
@@ -292,6 +298,12 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
         _write_failure_reply_feature.enable();
         _xxhash_feature.enable();
         _roles_feature.enable();
+        _row_hashes_digest_feature.enable();
+        _batched_mutations_feature.enable();
+        _multi_partition_point_reads_feature.enable();
+        _replica_row_count_feature.enable();
+        _replica_filtering_feature.enable();
+        _bypass_cache_feature.enable();
     }
 
     void finish_bootstrapping() {
@@ -2273,6 +2285,30 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     bool cluster_supports_roles() const {
         return bool(_roles_feature);
     }
+
+    bool cluster_supports_row_hashes_digest_algorithm() const {
+        return bool(_row_hashes_digest_feature);
+    }
+
+    bool cluster_supports_batched_mutations() const {
+        return bool(_batched_mutations_feature);
+    }
+
+    bool cluster_supports_multi_partition_point_reads() const {
+        return bool(_multi_partition_point_reads_feature);
+    }
+
+    bool cluster_supports_replica_row_count() const {
+        return bool(_replica_row_count_feature);
+    }
+
+    bool cluster_supports_replica_filtering() const {
+        return bool(_replica_filtering_feature);
+    }
+
+    bool cluster_supports_bypass_cache() const {
+        return bool(_bypass_cache_feature);
+    }
 };
 
 inline future<> init_storage_service(distributed<database>& db, sharded<auth::service>& auth_service) {
@@ -145,15 +145,70 @@ class compacting_sstable_writer {
     stop_iteration consume(clustering_row&& cr, row_tombstone, bool) { return _writer->consume(std::move(cr)); }
     stop_iteration consume(range_tombstone&& rt) { return _writer->consume(std::move(rt)); }
 
+    void on_tombstone_purged();
+
     stop_iteration consume_end_of_partition();
     void consume_end_of_stream();
 };
 
+// Counts the input sstables each partition of a compaction is merged from.
+//
+// Sstable readers start partitions ahead of the merged stream, so the count of
+// a partition is complete once the merged stream reaches it.
+class partition_merge_counter {
+    std::map<dht::decorated_key, int32_t, dht::decorated_key::less_comparator> _pending;
+public:
+    explicit partition_merge_counter(schema_ptr s)
+        : _pending(dht::decorated_key::less_comparator(std::move(s))) { }
+
+    void on_partition_start(const dht::decorated_key& dk) {
+        _pending.emplace(dk, 0).first->second++;
+    }
+
+    // Returns the number of sstables the partition, which the merged stream has
+    // just reached, was read from. Partitions before it, which were read but left
+    // out of the stream (e.g. ones owned by other shards), are forgotten.
+    int32_t on_partition_merged(const dht::decorated_key& dk) {
+        int32_t count = 0;
+        auto it = _pending.lower_bound(dk);
+        if (it != _pending.end() && !_pending.key_comp()(dk, it->first)) {
+            count = it->second;
+            ++it;
+        }
+        _pending.erase(_pending.begin(), it);
+        return count;
+    }
+};
+
+// Used by compactions which don't track their progress in the backlog tracker.
+struct merge_counting_read_monitor_generator final : public read_monitor_generator {
+    class merge_counting_read_monitor final : public sstables::read_monitor {
+        partition_merge_counter& _merge_counter;
+    public:
+        explicit merge_counting_read_monitor(partition_merge_counter& mc) : _merge_counter(mc) { }
+
+        virtual void on_read_started(const sstables::reader_position_tracker&) override { }
+        virtual void on_read_completed() override { }
+        virtual void on_partition_start(const dht::decorated_key& dk) override {
+            _merge_counter.on_partition_start(dk);
+        }
+    };
+
+    virtual sstables::read_monitor& operator()(sstables::shared_sstable) override {
+        return _monitor;
+    }
+
+    explicit merge_counting_read_monitor_generator(partition_merge_counter& mc) : _monitor(mc) { }
+private:
+    merge_counting_read_monitor _monitor;
+};
+
 struct compaction_read_monitor_generator final : public read_monitor_generator {
     class compaction_read_monitor final : public  sstables::read_monitor, public backlog_read_progress_manager {
         sstables::shared_sstable _sst;
         compaction_manager& _compaction_manager;
         column_family& _cf;
+        partition_merge_counter& _merge_counter;
         const sstables::reader_position_tracker* _tracker = nullptr;
         uint64_t _last_position_seen = 0;
     public:
@@ -169,6 +224,10 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
             }
         }
 
+        virtual void on_partition_start(const dht::decorated_key& dk) override {
+            _merge_counter.on_partition_start(dk);
+        }
+
         virtual uint64_t compacted() const override {
             if (_tracker) {
                 return _tracker->position;
@@ -177,14 +236,18 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
         }
 
         void remove_sstable(bool is_tracking) {
-            if (is_tracking) {
+            if (is_tracking && _sst) {
                 _cf.get_compaction_strategy().get_backlog_tracker().remove_sstable(_sst);
             }
             _sst = {};
         }
 
-        compaction_read_monitor(sstables::shared_sstable sst, compaction_manager& cm, column_family &cf)
-            : _sst(std::move(sst)), _compaction_manager(cm), _cf(cf) { }
+        const sstables::shared_sstable& sstable() const {
+            return _sst;
+        }
+
+        compaction_read_monitor(sstables::shared_sstable sst, compaction_manager& cm, column_family &cf, partition_merge_counter& mc)
+            : _sst(std::move(sst)), _compaction_manager(cm), _cf(cf), _merge_counter(mc) { }
 
         ~compaction_read_monitor() {
             // We failed to finish handling this SSTable, so we have to update the backlog_tracker
@@ -196,12 +259,13 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
     };
 
     virtual sstables::read_monitor& operator()(sstables::shared_sstable sst) override {
-        _generated_monitors.emplace_back(std::move(sst), _compaction_manager, _cf);
+        _generated_monitors.emplace_back(std::move(sst), _compaction_manager, _cf, _merge_counter);
         return _generated_monitors.back();
     }
-    compaction_read_monitor_generator(compaction_manager& cm, column_family& cf)
+    compaction_read_monitor_generator(compaction_manager& cm, column_family& cf, partition_merge_counter& mc)
         : _compaction_manager(cm)
-        , _cf(cf) {}
+        , _cf(cf)
+        , _merge_counter(mc) {}
 
     void remove_sstables(bool is_tracking) {
         for (auto& rm : _generated_monitors) {
@@ -209,9 +273,18 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
         }
 
     }
+
+    void remove_sstables(const std::unordered_set<sstables::shared_sstable>& ssts, bool is_tracking) {
+        for (auto& rm : _generated_monitors) {
+            if (ssts.count(rm.sstable())) {
+                rm.remove_sstable(is_tracking);
+            }
+        }
+    }
 private:
      compaction_manager& _compaction_manager;
      column_family& _cf;
+     partition_merge_counter& _merge_counter;
      std::deque<compaction_read_monitor> _generated_monitors;
 };
 
@@ -297,12 +370,25 @@ class compaction {
     uint64_t _estimated_partitions = 0;
     std::vector<unsigned long> _ancestors;
     db::replay_position _rp;
+    // Number of new sstables, counting from the first one, which already replaced
+    // input sstables in the column family. They must be kept if compaction fails.
+    size_t _replaced_new_sstables = 0;
+    // Input sstables which are linked into the output instead of being rewritten,
+    // sorted by their first partition.
+    std::deque<shared_sstable> _sstables_to_link;
+    // Range of partitions written by this compaction, when it compacts one of
+    // the sub-ranges of its input in parallel with others.
+    dht::partition_range _range = query::full_partition_range;
+    partition_merge_counter _merge_counter;
+    mutable merge_counting_read_monitor_generator _merge_counting_monitor_generator;
 protected:
     compaction(column_family& cf, std::vector<shared_sstable> sstables, uint64_t max_sstable_size, uint32_t sstable_level)
         : _cf(cf)
         , _sstables(std::move(sstables))
         , _max_sstable_size(max_sstable_size)
         , _sstable_level(sstable_level)
+        , _merge_counter(cf.schema())
+        , _merge_counting_monitor_generator(_merge_counter)
     {
         _cf.get_compaction_manager().register_compaction(_info);
     }
@@ -345,6 +431,7 @@ class compaction {
         auto schema = _cf.schema();
         sstring formatted_msg = "[";
         auto fully_expired = get_fully_expired_sstables(_cf, _sstables, gc_clock::now() - schema->gc_grace_seconds());
+        std::vector<shared_sstable> compacting;
 
         for (auto& sst : _sstables) {
             // Compacted sstable keeps track of its ancestors.
@@ -359,12 +446,7 @@ class compaction {
                 continue;
             }
 
-            // We also capture the sstable, so we keep it alive while the read isn't done
-            ssts->insert(sst);
-            // FIXME: If the sstables have cardinality estimation bitmaps, use that
-            // for a better estimate for the number of partitions in the merged
-            // sstable than just adding up the lengths of individual sstables.
-            _estimated_partitions += sst->get_estimated_key_count();
+            compacting.push_back(sst);
             // TODO:
             // Note that this is not fully correct. Since we might be merging sstables that originated on
             // another shard (#cpu changed), we might be comparing RP:s with differing shard ids,
@@ -375,6 +457,39 @@ class compaction {
             _rp = std::max(_rp, sst->get_stats_metadata().position);
         }
         formatted_msg += "]";
+
+        auto to_link = select_sstables_to_link(compacting);
+        if (!to_link.empty()) {
+            boost::sort(to_link, [] (const shared_sstable& a, const shared_sstable& b) {
+                return a->compare_by_first_key(*b) < 0;
+            });
+            _sstables_to_link.assign(to_link.begin(), to_link.end());
+            auto linked = std::unordered_set<shared_sstable>(to_link.begin(), to_link.end());
+            compacting.erase(boost::remove_if(compacting, [&linked] (const shared_sstable& sst) {
+                return linked.count(sst);
+            }), compacting.end());
+            clogger.debug("Linking {} sstable(s) of {}.{} into compaction output without rewriting them",
+                    to_link.size(), schema->ks_name(), schema->cf_name());
+        }
+        for (auto& sst : compacting) {
+            // We also capture the sstable, so we keep it alive while the read isn't done
+            ssts->insert(sst);
+        }
+        // Overlapping sstables hold some partitions in common, so just adding up their key
+        // counts would make us build filters and summaries much larger than needed.
+        _estimated_partitions = estimate_distinct_partitions(compacting);
+        if (!_range.is_full()) {
+            auto token_range = _range.transform([] (const dht::ring_position& rp) { return rp.token(); });
+            uint64_t keys_in_range = 0;
+            uint64_t keys = 0;
+            for (auto& sst : compacting) {
+                keys_in_range += sst->estimated_keys_for_range(token_range);
+                keys += sst->get_estimated_key_count();
+            }
+            if (keys) {
+                _estimated_partitions = std::max(uint64_t(1), uint64_t(_estimated_partitions * (double(keys_in_range) / keys)));
+            }
+        }
         _info->sstables = _sstables.size();
         _info->ks = schema->ks_name();
         _info->cf = schema->cf_name();
@@ -384,6 +499,7 @@ class compaction {
     }
 
     compaction_info finish(std::chrono::time_point<db_clock> started_at, std::chrono::time_point<db_clock> ended_at) {
+        _info->started_at = std::chrono::duration_cast<std::chrono::milliseconds>(started_at.time_since_epoch()).count();
         _info->ended_at = std::chrono::duration_cast<std::chrono::milliseconds>(ended_at.time_since_epoch()).count();
         auto ratio = double(_info->end_size) / double(_info->start_size);
         auto duration = std::chrono::duration<float>(ended_at - started_at);
@@ -394,16 +510,20 @@ class compaction {
             new_sstables_msg += sprint("%s:level=%d, ", newtab->get_filename(), newtab->get_sstable_level());
         }
 
-        // FIXME: there is some missing information in the log message below.
-        // look at CompactionTask::runMayThrow() in origin for reference.
-        // - add support to merge summary (message: Partition merge counts were {%s}.).
-        // - there is no easy way, currently, to know the exact number of total partitions.
-        // By the time being, using estimated key count.
+        auto merge_counts = boost::copy_range<std::map<int32_t, int64_t>>(_info->merged_partitions);
+        sstring merge_counts_msg;
+        for (auto& mc : merge_counts) {
+            merge_counts_msg += sprint("%d:%d, ", mc.first, mc.second);
+        }
+
+        // Partitions of sstables which are linked into the output aren't read, so
+        // they're only accounted for in the written count, by estimate.
         sstring formatted_msg = sprint("%ld sstables to [%s]. %ld bytes to %ld (~%d%% of original) in %dms = %.2fMB/s. " \
-            "~%ld total partitions merged to %ld.",
+            "~%ld total partitions, %ld read, merged to %ld. Partition merge counts were {%s}. %ld tombstones purged.",
             _info->sstables, new_sstables_msg, _info->start_size, _info->end_size, int(ratio * 100),
             std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), throughput,
-            _info->total_partitions, _info->total_keys_written);
+            _info->total_partitions, _info->total_keys_read, _info->total_keys_written, merge_counts_msg,
+            _info->purged_tombstones);
         report_finish(formatted_msg, ended_at);
 
         backlog_tracker_adjust_charges();
@@ -429,6 +549,12 @@ class compaction {
         };
     }
 
+    // Returns the sstables, among the ones being compacted, which the compaction would
+    // copy to its output unchanged, so they can be linked into it instead.
+    virtual std::vector<shared_sstable> select_sstables_to_link(const std::vector<shared_sstable>& compacting) const {
+        return {};
+    }
+
     // select a sstable writer based on decorated key.
     virtual sstable_writer* select_sstable_writer(const dht::decorated_key& dk) = 0;
     // stop current writer
@@ -440,6 +566,16 @@ class compaction {
         return compacting_sstable_writer(*this);
     }
 
+    // Called for every partition of the merged input, including ones which are
+    // filtered out or purged entirely.
+    void on_partition_merged(const dht::decorated_key& dk) {
+        _info->total_keys_read++;
+        auto count = _merge_counter.on_partition_merged(dk);
+        if (count) {
+            _info->merged_partitions[count]++;
+        }
+    }
+
     const schema_ptr& schema() const {
         return _cf.schema();
     }
@@ -459,6 +595,10 @@ void compacting_sstable_writer::consume_new_partition(const dht::decorated_key&
     _c._info->total_keys_written++;
 }
 
+void compacting_sstable_writer::on_tombstone_purged() {
+    _c._info->purged_tombstones++;
+}
+
 stop_iteration compacting_sstable_writer::consume_end_of_partition() {
     auto ret = _writer->consume_end_of_partition();
     if (ret == stop_iteration::yes) {
@@ -475,7 +615,10 @@ void compacting_sstable_writer::consume_end_of_stream() {
 
 class regular_compaction : public compaction {
     std::function<shared_sstable()> _creator;
-    // store a clone of sstable set for column family, which needs to be alive for incremental selector.
+    // sstables being compacted which weren't replaced by the output yet.
+    std::unordered_set<shared_sstable> _compacting;
+    // store a clone of sstable set for column family, without the sstables being compacted,
+    // which needs to be alive for incremental selector.
     const sstable_set _set;
     // used to incrementally calculate max purgeable timestamp, as we iterate through decorated keys.
     sstable_set::incremental_selector _selector;
@@ -485,28 +628,73 @@ class regular_compaction : public compaction {
     stdx::optional<compaction_weight_registration> _weight_registration;
     mutable compaction_read_monitor_generator _monitor_generator;
     std::deque<compaction_write_monitor> _active_write_monitors = {};
+    compaction_sstable_replacer_fn _replacer;
+    bool _link_into_unsplit_output;
+private:
+    static sstable_set make_uncompacting_sstable_set(const column_family& cf, const std::unordered_set<shared_sstable>& compacting) {
+        auto set = cf.get_sstable_set();
+        for (auto& sst : compacting) {
+            if (set.all()->count(sst)) {
+                set.erase(sst);
+            }
+        }
+        return set;
+    }
 public:
-    regular_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator)
-        : compaction(cf, std::move(descriptor.sstables), descriptor.max_sstable_bytes, descriptor.level)
+    regular_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator,
+            dht::partition_range range = query::full_partition_range)
+        : compaction(cf, std::move(descriptor.sstables), std::min(descriptor.max_sstable_bytes, descriptor.fragment_size), descriptor.level)
         , _creator(std::move(creator))
-        , _set(cf.get_sstable_set())
+        , _compacting(_sstables.begin(), _sstables.end())
+        , _set(make_uncompacting_sstable_set(cf, _compacting))
         , _selector(_set.make_incremental_selector())
         , _weight_registration(std::move(descriptor.weight_registration))
-        , _monitor_generator(_cf.get_compaction_manager(), _cf)
+        , _monitor_generator(_cf.get_compaction_manager(), _cf, _merge_counter)
+        , _replacer(std::move(descriptor.replacer))
+        , _link_into_unsplit_output(descriptor.link_into_unsplit_output)
     {
+        _range = std::move(range);
+    }
+
+    // Compactions of sub-ranges read the same sstables concurrently, so none of them
+    // can account for the progress on them in the backlog tracker. It is adjusted
+    // once all of them are done instead.
+    read_monitor_generator& monitor_generator() const {
+        if (!_range.is_full()) {
+            return _merge_counting_monitor_generator;
+        }
+        return _monitor_generator;
     }
 
     flat_mutation_reader make_sstable_reader(lw_shared_ptr<sstables::sstable_set> ssts) const override {
+        if (_replacer) {
+            // Readers of single sstables are dropped by the combined reader as soon as they are
+            // exhausted, unlike ones made by a sstable set selector, so that exhausted sstables
+            // aren't kept alive until the end of the compaction.
+            auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(*ssts->all()
+                    | boost::adaptors::transformed([this] (const shared_sstable& sst) {
+                return sst->read_range_rows_flat(_cf.schema(),
+                        _range,
+                        _cf.schema()->full_slice(),
+                        service::get_local_compaction_priority(),
+                        no_resource_tracking(),
+                        ::streamed_mutation::forwarding::no,
+                        ::mutation_reader::forwarding::no,
+                        monitor_generator()(sst));
+            }));
+            return make_combined_reader(_cf.schema(), std::move(readers),
+                    ::streamed_mutation::forwarding::no, ::mutation_reader::forwarding::no);
+        }
         return ::make_local_shard_sstable_reader(_cf.schema(),
                 std::move(ssts),
-                query::full_partition_range,
+                _range,
                 _cf.schema()->full_slice(),
                 service::get_local_compaction_priority(),
                 no_resource_tracking(),
                 nullptr,
                 ::streamed_mutation::forwarding::no,
                 ::mutation_reader::forwarding::no,
-                _monitor_generator);
+                monitor_generator());
     }
 
     void report_start(const sstring& formatted_msg) const override {
@@ -525,9 +713,12 @@ class regular_compaction : public compaction {
     }
 
     virtual std::function<api::timestamp_type(const dht::decorated_key&)> max_purgeable_func() override {
-        std::unordered_set<shared_sstable> compacting(_sstables.begin(), _sstables.end());
-        return [this, compacting = std::move(compacting)] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_cf, _selector, compacting, dk);
+        return [this] (const dht::decorated_key& dk) {
+            auto timestamp = get_max_purgeable_timestamp(_cf, _selector, _compacting, dk);
+            if (_replacer) {
+                timestamp = std::min(timestamp, get_max_purgeable_timestamp_among_inputs(dk));
+            }
+            return timestamp;
         };
     }
 
@@ -537,7 +728,50 @@ class regular_compaction : public compaction {
         };
     }
 
+    // An sstable which shares no partitions with the other inputs, and holds no tombstones
+    // nor expiring cells, has nothing that compaction could merge, purge or expire.
+    // Its links join the output sstables, with which they form a run, so it must not exceed
+    // their size, otherwise compaction would rather merge it with the rest. It must not be
+    // much smaller either, or the run would be left with small sstables that compaction is
+    // meant to get rid of: below half the size of output sstables, or of the average input
+    // when the output isn't split, it's merged as well.
+    virtual std::vector<shared_sstable> select_sstables_to_link(const std::vector<shared_sstable>& compacting) const override {
+        auto& s = *_cf.schema();
+        std::vector<shared_sstable> ret;
+        // An sstable could span several sub-ranges, and be linked by each of them.
+        auto unsplit = _max_sstable_size == std::numeric_limits<uint64_t>::max();
+        if (compacting.empty() || !_range.is_full() || (unsplit && !_link_into_unsplit_output)) {
+            return ret;
+        }
+        uint64_t min_size;
+        if (unsplit) {
+            uint64_t total_size = 0;
+            for (auto& sst : compacting) {
+                total_size += sst->data_size();
+            }
+            min_size = total_size / compacting.size() / 2;
+        } else {
+            min_size = _max_sstable_size / 2;
+        }
+        for (auto& sst : compacting) {
+            if (sst->is_shared() || sst->data_size() > _max_sstable_size || sst->data_size() < min_size
+                    || !sst->get_stats_metadata().estimated_tombstone_drop_time.bin.empty()) {
+                continue;
+            }
+            auto overlaps = boost::algorithm::any_of(compacting, [&] (const shared_sstable& other) {
+                return other != sst
+                    && other->get_first_decorated_key().tri_compare(s, sst->get_last_decorated_key()) <= 0
+                    && sst->get_first_decorated_key().tri_compare(s, other->get_last_decorated_key()) <= 0;
+            });
+            if (!overlaps) {
+                ret.push_back(sst);
+            }
+        }
+        return ret;
+    }
+
     virtual sstable_writer* select_sstable_writer(const dht::decorated_key& dk) override {
+        link_sstables_before(&dk);
         if (!_writer) {
             _sst = _creator();
             setup_new_sstable(_sst);
@@ -555,6 +789,9 @@ class regular_compaction : public compaction {
 
     virtual void stop_sstable_writer() override {
         finish_new_sstable(_writer, _sst);
+        if (_replacer) {
+            replace_exhausted_sstables(_sst->get_last_decorated_key());
+        }
     }
 
     virtual void finish_sstable_writer() override {
@@ -562,6 +799,10 @@ class regular_compaction : public compaction {
         if (_writer) {
             stop_sstable_writer();
         }
+        link_sstables_before(nullptr);
+        if (_replacer) {
+            replace_sstables(_sstables);
+        }
     }
 private:
     void on_end_of_stream() {
@@ -569,16 +810,125 @@ class regular_compaction : public compaction {
             _cf.get_compaction_manager().on_compaction_complete(*_weight_registration);
         }
     }
+
+    // Links the sstables to be copied unchanged which start before the given partition,
+    // or all of them if there's none, into the output.
+    void link_sstables_before(const dht::decorated_key* dk) {
+        auto& s = *_cf.schema();
+        while (!_sstables_to_link.empty() && (!dk || _sstables_to_link.front()->get_first_decorated_key().less_compare(s, *dk))) {
+            // Keep the output sstables from overlapping with the linked one.
+            if (_writer) {
+                stop_sstable_writer();
+            }
+            auto input = std::move(_sstables_to_link.front());
+            _sstables_to_link.pop_front();
+            // Links have to be on the same file system as the sstable they're made to.
+            auto generation = _cf.calculate_generation_for_new_table();
+            _sst = input->link_as_compaction_output(input->get_dir(), generation, _sstable_level, _ancestors).get0();
+            _info->new_sstables.push_back(_sst);
+            _info->end_size += _sst->bytes_on_disk();
+            // Its partitions are neither read nor merged, but they're in the output all the same.
+            _info->total_keys_written += _sst->get_estimated_key_count();
+            _active_write_monitors.emplace_back(_sst, _cf);
+            if (_replacer) {
+                replace_exhausted_sstables(_sst->get_last_decorated_key());
+            }
+        }
+    }
+
+    // Input sstables are replaced at different times, so a tombstone may only be purged if
+    // it cannot shadow data in an input which outlives the one holding the tombstone.
+    // Otherwise, the shadowed data would come back once the latter is deleted.
+    api::timestamp_type get_max_purgeable_timestamp_among_inputs(const dht::decorated_key& dk) const {
+        auto& s = *_cf.schema();
+        auto hk = sstables::sstable::make_hashed_key(s, dk.key());
+        std::vector<shared_sstable> holders;
+        for (auto& sst : _sstables) {
+            if (sst->get_first_decorated_key().tri_compare(s, dk) <= 0 && dk.tri_compare(s, sst->get_last_decorated_key()) <= 0
+                    && sst->filter_has_key(hk)) {
+                holders.push_back(sst);
+            }
+        }
+        if (holders.size() < 2) {
+            return api::max_timestamp;
+        }
+        if (!_range.is_full()) {
+            // Inputs of compactions of sub-ranges are replaced once all the sub-ranges they
+            // overlap are done, in no particular order, so any of them could outlive the others.
+            auto timestamp = api::max_timestamp;
+            for (auto& sst : holders) {
+                timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+            }
+            return timestamp;
+        }
+        // Inputs ending first are replaced first, all at once, so only the later ones count.
+        auto& first_replaced = **boost::range::min_element(holders, [&s] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_last_decorated_key().less_compare(s, b->get_last_decorated_key());
+        });
+        auto timestamp = api::max_timestamp;
+        for (auto& sst : holders) {
+            if (sst->get_last_decorated_key().tri_compare(s, first_replaced.get_last_decorated_key()) > 0) {
+                timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+            }
+        }
+        return timestamp;
+    }
+
+    void replace_exhausted_sstables(const dht::decorated_key& last_written) {
+        auto& s = *_cf.schema();
+        auto exhausted = boost::copy_range<std::vector<shared_sstable>>(_sstables
+                | boost::adaptors::filtered([&] (const shared_sstable& sst) {
+            return sst->get_last_decorated_key().tri_compare(s, last_written) <= 0;
+        }));
+        if (!exhausted.empty()) {
+            replace_sstables(std::move(exhausted));
+        }
+    }
+
+    // Replaces given input sstables, which the output moved past, with all sealed output
+    // sstables in the column family, and drops our references to the former, so that
+    // their disk space can be released before the compaction finishes.
+    void replace_sstables(std::vector<shared_sstable> exhausted) {
+        auto sealed = boost::copy_range<std::vector<shared_sstable>>(_info->new_sstables
+                | boost::adaptors::sliced(_replaced_new_sstables, _info->new_sstables.size()));
+        if (exhausted.empty() && sealed.empty()) {
+            return;
+        }
+        clogger.debug("Replacing {} exhausted sstable(s) with {} new sstable(s) of {}.{}",
+                exhausted.size(), sealed.size(), _info->ks, _info->cf);
+
+        auto exhausted_set = std::unordered_set<shared_sstable>(exhausted.begin(), exhausted.end());
+        _replacer(compaction_completion_desc{std::move(exhausted), sealed});
+        _replaced_new_sstables = _info->new_sstables.size();
+
+        for (auto& sst : exhausted_set) {
+            _compacting.erase(sst);
+        }
+        _sstables.erase(boost::remove_if(_sstables, [&] (const shared_sstable& sst) {
+            return exhausted_set.count(sst);
+        }), _sstables.end());
+        _monitor_generator.remove_sstables(exhausted_set, _info->tracking);
+        for (size_t i = 0; i < sealed.size(); ++i) {
+            _active_write_monitors.front().add_sstable();
+            _active_write_monitors.pop_front();
+        }
+    }
 };
 
 class cleanup_compaction final : public regular_compaction {
 public:
-    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator)
-        : regular_compaction(cf, std::move(descriptor), std::move(creator))
+    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator,
+            dht::partition_range range = query::full_partition_range)
+        : regular_compaction(cf, std::move(descriptor), std::move(creator), std::move(range))
     {
         _info->type = compaction_type::Cleanup;
     }
 
+    // Cleanup has to filter out partitions of every sstable.
+    std::vector<shared_sstable> select_sstables_to_link(const std::vector<shared_sstable>& compacting) const override {
+        return {};
+    }
+
     void report_start(const sstring& formatted_msg) const override {
         clogger.info("Cleaning {}", formatted_msg);
     }
@@ -640,7 +990,8 @@ class resharding_compaction final : public compaction {
                 no_resource_tracking(),
                 nullptr,
                 ::streamed_mutation::forwarding::no,
-                ::mutation_reader::forwarding::no);
+                ::mutation_reader::forwarding::no,
+                _merge_counting_monitor_generator);
     }
 
     void report_start(const sstring& formatted_msg) const override {
@@ -700,9 +1051,15 @@ future<compaction_info> compaction::run(std::unique_ptr<compaction> c) {
             // leave this block either successfully or exceptionally with the reader object
             // destroyed.
             auto r = std::move(reader);
-            r.consume_in_thread(std::move(cfc), c->filter_func());
+            r.consume_in_thread(std::move(cfc), [c = c.get(), filter = c->filter_func()] (const dht::decorated_key& dk) {
+                c->on_partition_merged(dk);
+                return filter(dk);
+            });
         } catch (...) {
-            delete_sstables_for_interrupted_compaction(c->_info->new_sstables, c->_info->ks, c->_info->cf);
+            // New sstables which already replaced their input are part of the column family.
+            auto unreplaced = boost::copy_range<std::vector<shared_sstable>>(c->_info->new_sstables
+                    | boost::adaptors::sliced(c->_replaced_new_sstables, c->_info->new_sstables.size()));
+            delete_sstables_for_interrupted_compaction(unreplaced, c->_info->ks, c->_info->cf);
             c = nullptr; // make sure writers are stopped while running in thread context
             throw;
         }
@@ -720,11 +1077,176 @@ static std::unique_ptr<compaction> make_compaction(bool cleanup, Params&&... par
     }
 }
 
+// Bounds the number of summary entries split_into_subranges() decorates and sorts, which it
+// does without yielding.
+static constexpr size_t max_subrange_samples = 4096;
+
+// Splits the ring into at most count disjoint ranges holding about the same number of
+// partitions of the sstables, according to evenly spaced samples of their summaries.
+static std::vector<dht::partition_range>
+split_into_subranges(schema_ptr schema, const std::vector<shared_sstable>& sstables, unsigned count) {
+    auto& s = *schema;
+    // Each sample stands for the estimated number of partitions between it and the next
+    // one taken from the same sstable.
+    std::vector<std::pair<dht::decorated_key, uint64_t>> samples;
+    uint64_t total = 0;
+    auto samples_per_sstable = std::max<size_t>(1, max_subrange_samples / sstables.size());
+    for (auto& sst : sstables) {
+        auto& entries = sst->get_summary().entries;
+        if (entries.empty()) {
+            continue;
+        }
+        auto stride = (entries.size() + samples_per_sstable - 1) / samples_per_sstable;
+        auto taken = (entries.size() + stride - 1) / stride;
+        auto weight = std::max<uint64_t>(1, sst->get_estimated_key_count() / taken);
+        for (size_t i = 0; i < entries.size(); i += stride) {
+            auto pkey = entries[i].get_key().to_partition_key(s);
+            samples.emplace_back(dht::global_partitioner().decorate_key(s, std::move(pkey)), weight);
+            total += weight;
+        }
+    }
+    boost::sort(samples, [less = dht::decorated_key::less_comparator(schema)] (const auto& a, const auto& b) {
+        return less(a.first, b.first);
+    });
+
+    count = std::min(count, unsigned(samples.size()));
+    std::vector<dht::partition_range> ranges;
+    stdx::optional<dht::partition_range::bound> start;
+    const dht::decorated_key* previous = nullptr;
+    uint64_t seen = 0;
+    for (auto& sample : samples) {
+        if (ranges.size() + 1 >= count) {
+            break;
+        }
+        // Ranges start at the first of equal samples, and never at the first key.
+        if (previous && !previous->equal(s, sample.first) && seen >= (ranges.size() + 1) * total / count) {
+            auto boundary = dht::ring_position(sample.first);
+            ranges.emplace_back(std::move(start), dht::partition_range::bound(boundary, false));
+            start = dht::partition_range::bound(std::move(boundary), true);
+        }
+        seen += sample.second;
+        previous = &sample.first;
+    }
+    ranges.emplace_back(std::move(start), stdx::nullopt);
+    return ranges;
+}
+
+// Makes the replacers of the compactions of the given sub-ranges out of the replacer of the
+// whole compaction. Each compaction reports every input as exhausted, but an input is only
+// replaced once all the compactions whose sub-range it overlaps are done with it.
+static std::vector<compaction_sstable_replacer_fn>
+make_subrange_replacers(column_family& cf, const std::vector<shared_sstable>& sstables,
+        const std::vector<dht::partition_range>& ranges, compaction_sstable_replacer_fn replacer) {
+    auto& s = *cf.schema();
+    auto pending = make_lw_shared<std::unordered_map<shared_sstable, unsigned>>();
+    std::vector<std::unordered_set<shared_sstable>> overlapping(ranges.size());
+    for (auto& sst : sstables) {
+        auto sst_range = dht::partition_range::make(dht::ring_position(sst->get_first_decorated_key()),
+                dht::ring_position(sst->get_last_decorated_key()));
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (ranges[i].overlaps(sst_range, dht::ring_position_comparator(s))) {
+                overlapping[i].insert(sst);
+                ++(*pending)[sst];
+            }
+        }
+    }
+    auto shared_replacer = make_lw_shared<compaction_sstable_replacer_fn>(std::move(replacer));
+    return boost::copy_range<std::vector<compaction_sstable_replacer_fn>>(overlapping
+            | boost::adaptors::transformed([&cf, pending, shared_replacer] (std::unordered_set<shared_sstable>& ssts) {
+        return [&cf, pending, shared_replacer, ssts = std::move(ssts)] (compaction_completion_desc desc) {
+            std::vector<shared_sstable> exhausted;
+            for (auto& sst : desc.input_sstables) {
+                if (ssts.count(sst) && !--(*pending)[sst]) {
+                    pending->erase(sst);
+                    cf.get_compaction_strategy().get_backlog_tracker().remove_sstable(sst);
+                    exhausted.push_back(sst);
+                }
+            }
+            if (!exhausted.empty() || !desc.output_sstables.empty()) {
+                (*shared_replacer)(compaction_completion_desc{std::move(exhausted), std::move(desc.output_sstables)});
+            }
+        };
+    }));
+}
+
+// Compacts every range in parallel, all of them reading the whole input. Without a replacer,
+// the input is replaced by the caller once all of them succeeded. With one, every compaction
+// replaces its input incrementally, and an input sstable is replaced once all the compactions
+// whose range it overlaps have moved past it.
+static future<compaction_info>
+compact_sstables_in_parallel(sstables::compaction_descriptor descriptor, std::vector<dht::partition_range> ranges,
+        column_family& cf, std::function<shared_sstable()> creator, bool cleanup) {
+    auto incremental = bool(descriptor.replacer);
+    auto replacers = incremental
+            ? make_subrange_replacers(cf, descriptor.sstables, ranges, std::move(descriptor.replacer))
+            : std::vector<compaction_sstable_replacer_fn>(ranges.size());
+    auto sstables = descriptor.sstables;
+    std::vector<future<compaction_info>> compactions;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        auto d = sstables::compaction_descriptor(descriptor.sstables, descriptor.level, descriptor.max_sstable_bytes);
+        d.fragment_size = descriptor.fragment_size;
+        d.replacer = std::move(replacers[i]);
+        compactions.push_back(compaction::run(make_compaction(cleanup, cf, std::move(d), creator, std::move(ranges[i]))));
+    }
+    // The weight of the whole compaction is held until all of them are done.
+    return when_all(compactions.begin(), compactions.end()).then([&cf, sstables = std::move(sstables), incremental,
+            weight_registration = std::move(descriptor.weight_registration)] (std::vector<future<compaction_info>> results) {
+        std::vector<compaction_info> infos;
+        std::exception_ptr ex;
+        for (auto& f : results) {
+            if (f.failed()) {
+                ex = f.get_exception();
+            } else {
+                infos.push_back(f.get0());
+            }
+        }
+        if (ex) {
+            // Interrupted compactions already deleted their own output. That of incremental
+            // ones which succeeded is part of the column family already.
+            if (!incremental) {
+                for (auto& info : infos) {
+                    delete_sstables_for_interrupted_compaction(info.new_sstables, info.ks, info.cf);
+                }
+            }
+            return make_exception_future<compaction_info>(std::move(ex));
+        }
+
+        auto info = std::move(infos.front());
+        for (auto& i : boost::make_iterator_range(infos.begin() + 1, infos.end())) {
+            info.end_size += i.end_size;
+            info.total_keys_written += i.total_keys_written;
+            info.total_keys_read += i.total_keys_read;
+            info.purged_tombstones += i.purged_tombstones;
+            for (auto& mc : i.merged_partitions) {
+                info.merged_partitions[mc.first] += mc.second;
+            }
+            info.started_at = std::min(info.started_at, i.started_at);
+            info.ended_at = std::max(info.ended_at, i.ended_at);
+            info.tracking &= i.tracking;
+            std::move(i.new_sstables.begin(), i.new_sstables.end(), std::back_inserter(info.new_sstables));
+        }
+        if (info.tracking && !incremental) {
+            for (auto& sst : sstables) {
+                cf.get_compaction_strategy().get_backlog_tracker().remove_sstable(sst);
+            }
+        }
+        clogger.info("Compacted {} sstables of {}.{} in {} sub-ranges. {} bytes to {}.",
+                info.sstables, info.ks, info.cf, infos.size(), info.start_size, info.end_size);
+        return make_ready_future<compaction_info>(std::move(info));
+    });
+}
+
 future<compaction_info>
 compact_sstables(sstables::compaction_descriptor descriptor, column_family& cf, std::function<shared_sstable()> creator, bool cleanup) {
     if (descriptor.sstables.empty()) {
         throw std::runtime_error(sprint("Called compaction with empty set on behalf of {}.{}", cf.schema()->ks_name(), cf.schema()->cf_name()));
     }
+    if (descriptor.parallelism > 1) {
+        auto ranges = split_into_subranges(cf.schema(), descriptor.sstables, descriptor.parallelism);
+        if (ranges.size() > 1) {
+            return compact_sstables_in_parallel(std::move(descriptor), std::move(ranges), cf, std::move(creator), cleanup);
+        }
+    }
     auto c = make_compaction(cleanup, cf, std::move(descriptor), std::move(creator));
     return compaction::run(std::move(c));
 }
@@ -799,4 +1321,49 @@ get_fully_expired_sstables(column_family& cf, const std::vector<sstables::shared
     return candidates;
 }
 
+// Estimators with fewer registers than this are too imprecise for sizing sstable
+// components; older versions wrote ones with just 16 registers.
+static constexpr uint32_t min_cardinality_estimator_registers = 1024;
+
+uint64_t estimate_distinct_partitions(const std::vector<sstables::shared_sstable>& sstables) {
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    stdx::optional<hll::HyperLogLog> merged;
+    bool usable = true;
+    for (auto& sst : sstables) {
+        auto keys = sst->get_estimated_key_count();
+        sum += keys;
+        max = std::max(max, keys);
+        if (!usable) {
+            continue;
+        }
+        auto estimator = sst->get_cardinality_estimator();
+        if (!estimator || estimator->registerSize() < min_cardinality_estimator_registers
+                || (merged && merged->registerSize() != estimator->registerSize())) {
+            usable = false;
+        } else if (!merged) {
+            merged = std::move(*estimator);
+        } else {
+            merged->merge(*estimator);
+        }
+    }
+    if (!usable || !merged) {
+        return sum;
+    }
+    // The union can't hold fewer partitions than its largest member, nor more than all
+    // of them together, so keep the approximation within those bounds.
+    return std::clamp(uint64_t(merged->estimate()), max, sum);
+}
+
+double estimate_partition_overlap(const std::vector<sstables::shared_sstable>& sstables) {
+    uint64_t sum = 0;
+    for (auto& sst : sstables) {
+        sum += sst->get_estimated_key_count();
+    }
+    if (!sum) {
+        return 0;
+    }
+    return 1.0 - double(estimate_distinct_partitions(sstables)) / sum;
+}
+
 }
@@ -28,9 +28,20 @@
 #include "compaction_weight_registration.hh"
 #include <seastar/core/thread.hh>
 #include <functional>
+#include <unordered_map>
 
 namespace sstables {
 
+    struct compaction_completion_desc {
+        // Input sstables whose content is fully present in output_sstables.
+        std::vector<shared_sstable> input_sstables;
+        // Sealed output sstables which replace input_sstables.
+        std::vector<shared_sstable> output_sstables;
+    };
+
+    // Replaces input sstables of a compaction with its output in the column family.
+    using compaction_sstable_replacer_fn = std::function<void(compaction_completion_desc)>;
+
     struct compaction_descriptor {
         // List of sstables to be compacted.
         std::vector<sstables::shared_sstable> sstables;
@@ -40,6 +51,26 @@ namespace sstables {
         uint64_t max_sstable_bytes;
         // Holds ownership of a weight assigned to this compaction iff it's a regular one.
         stdx::optional<compaction_weight_registration> weight_registration;
+        // If set, compaction is incremental: output is split into fragments of at most
+        // fragment_size bytes, and the replacer is called with every input sstable as soon
+        // as the output moves past its last partition, so that it can be deleted before the
+        // compaction finishes. The replacer is also called with the remaining sstables at
+        // the end, so the caller doesn't have to replace them itself.
+        compaction_sstable_replacer_fn replacer;
+        uint64_t fragment_size = std::numeric_limits<uint64_t>::max();
+        // Called by the replacer with input sstables which are not compacting any more,
+        // so that whoever registered them as compacting can drop its references to them.
+        std::function<void(const std::vector<shared_sstable>&)> release_exhausted;
+        // Number of disjoint token sub-ranges into which compaction may split its input,
+        // so that they're compacted in parallel, each into its own non-overlapping output.
+        // Without a replacer, input sstables are replaced only once all of them are done.
+        // With one, each input sstable is replaced once all the sub-ranges it overlaps are.
+        unsigned parallelism = 1;
+        // Input sstables which compaction would copy unchanged are linked into output which is
+        // split into sstables of bounded size, as that's a run anyway. Output which isn't split
+        // is only linked into if this is set by the strategy, which then has to tell apart the
+        // run it forms from separate sstables, lest they keep being compacted together.
+        bool link_into_unsplit_output = false;
 
         compaction_descriptor() = default;
 
@@ -93,6 +124,13 @@ namespace sstables {
         uint64_t end_size = 0;
         uint64_t total_partitions = 0;
         uint64_t total_keys_written = 0;
+        // Number of distinct partitions read from the input sstables.
+        uint64_t total_keys_read = 0;
+        // Number of partition, row and range tombstones which were purged.
+        uint64_t purged_tombstones = 0;
+        // Number of partitions read, by the number of input sstables each was merged from.
+        std::unordered_map<int32_t, int64_t> merged_partitions;
+        int64_t started_at;
         int64_t ended_at;
         std::vector<shared_sstable> new_sstables;
         sstring stop_requested;
@@ -138,4 +176,14 @@ namespace sstables {
     // and possibly doesn't contain any tombstone that covers cells in other sstables.
     std::unordered_set<sstables::shared_sstable>
     get_fully_expired_sstables(column_family& cf, const std::vector<sstables::shared_sstable>& compacting, gc_clock::time_point gc_before);
+
+    // Estimates the number of distinct partitions in a set of sstables, by merging the
+    // cardinality estimators from their compaction metadata. Falls back to adding up
+    // their estimated key counts when any of them lacks a precise enough estimator.
+    uint64_t estimate_distinct_partitions(const std::vector<sstables::shared_sstable>& sstables);
+
+    // Estimates the fraction of partitions in a set of sstables which compacting them
+    // together would merge away: 0 when they hold disjoint partitions, approaching
+    // 1 - 1/N when N sstables all hold the same partitions.
+    double estimate_partition_overlap(const std::vector<sstables::shared_sstable>& sstables);
 }
@@ -27,6 +27,8 @@
 #include "exceptions.hh"
 #include <cmath>
 #include <boost/algorithm/cxx11/any_of.hpp>
+#include <boost/range/algorithm/remove_if.hpp>
+#include <boost/range/adaptor/filtered.hpp>
 
 static logging::logger cmlog("compaction_manager");
 
@@ -64,6 +66,15 @@ class compacting_sstable_registration {
             _cm->deregister_compacting_sstables(_compacting);
         }
     }
+
+    // Deregisters sstables which an incremental compaction is done with.
+    void release_compacting(const std::vector<sstables::shared_sstable>& sstables) {
+        _cm->deregister_compacting_sstables(sstables);
+        std::unordered_set<sstables::shared_sstable> s(sstables.begin(), sstables.end());
+        _compacting.erase(boost::remove_if(_compacting, [&s] (const sstables::shared_sstable& sst) {
+            return s.count(sst);
+        }), _compacting.end());
+    }
 };
 
 compaction_weight_registration::compaction_weight_registration(compaction_manager* cm, int weight)
@@ -202,6 +213,11 @@ std::vector<sstables::shared_sstable> compaction_manager::get_candidates(const c
     return candidates;
 }
 
+std::vector<sstables::shared_sstable> compaction_manager::get_maintenance_candidates(const column_family& cf) {
+    return boost::copy_range<std::vector<sstables::shared_sstable>>(cf.maintenance_sstables()
+        | boost::adaptors::filtered([this] (const sstables::shared_sstable& sst) { return !_compacting_sstables.count(sst); }));
+}
+
 void compaction_manager::register_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables) {
     for (auto& sst : sstables) {
         _compacting_sstables.insert(sst);
@@ -233,16 +249,29 @@ future<> compaction_manager::submit_major_compaction(column_family* cf) {
                 return make_ready_future<>();
             }
 
+            // Major compaction merges everything, so sstables waiting for off-strategy compaction
+            // join regular compaction right away. Off-strategy compaction holds the read lock,
+            // so none of them is being compacted now.
+            auto maintenance_sstables = get_maintenance_candidates(*cf);
+            if (!maintenance_sstables.empty()) {
+                cf->integrate_maintenance_sstables(maintenance_sstables);
+            }
+
             // candidates are sstables that aren't being operated on by other compaction types.
             // those are eligible for major compaction.
             // FIXME: we need to make major compaction compaction strategy aware. For example,
             // leveled strategy may want to promote the merged sstables of a level N.
             auto sstables = get_candidates(*cf);
-            auto compacting = compacting_sstable_registration(this, sstables);
-
-            return with_scheduling_group(_scheduling_group, [this, cf, sstables = std::move(sstables)] () mutable {
-                return cf->compact_sstables(sstables::compaction_descriptor(std::move(sstables)));
-            }).then([compacting = std::move(compacting)] {});
+            auto compacting = make_lw_shared<compacting_sstable_registration>(this, sstables);
+
+            return with_scheduling_group(_scheduling_group, [this, cf, sstables = std::move(sstables), compacting] () mutable {
+                auto descriptor = sstables::compaction_descriptor(std::move(sstables));
+                descriptor.parallelism = cf->major_compaction_parallelism();
+                descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted) {
+                    compacting->release_compacting(exhausted);
+                };
+                return cf->compact_sstables(std::move(descriptor));
+            }).then([compacting] {});
         });
     }).then_wrapped([this, task] (future<> f) {
         _stats.active_tasks--;
@@ -261,6 +290,96 @@ future<> compaction_manager::submit_major_compaction(column_family* cf) {
     return task->compaction_done.get_future().then([task] {});
 }
 
+inline bool compaction_manager::check_for_offstrategy(column_family* cf) {
+    for (auto& task : _tasks) {
+        if (task->compacting_cf == cf && task->offstrategy) {
+            return true;
+        }
+    }
+    return false;
+}
+
+future<> compaction_manager::submit_offstrategy_compaction(column_family* cf) {
+    if (_stopped || check_for_offstrategy(cf)) {
+        return make_ready_future<>();
+    }
+    auto task = make_lw_shared<compaction_manager::task>();
+    task->compacting_cf = cf;
+    task->offstrategy = true;
+    _tasks.push_back(task);
+    _stats.pending_tasks++;
+
+    // Every round compacts the maintenance sstables according to the reshaping jobs of the
+    // strategy, and its output replaces them in the maintenance set. Once the strategy has
+    // nothing left to reshape, they're handed over to regular compaction. A round may not
+    // reduce their count, as output is split into sstables of the strategy's target size,
+    // so that's no sign of lack of progress. Instead, the rounds are given as many jobs as
+    // there were sstables to begin with, which is more than enough, as each merges several,
+    // and the sstables are handed over as they are once that's used up.
+    auto jobs_left = make_lw_shared<stdx::optional<size_t>>();
+    task->compaction_done = repeat([this, task, cf, jobs_left] () mutable {
+        if (!can_proceed(task)) {
+            _stats.pending_tasks--;
+            return make_ready_future<stop_iteration>(stop_iteration::yes);
+        }
+        // Takes the read lock, like regular compaction, which can proceed in parallel as
+        // it doesn't use maintenance sstables.
+        return with_lock(_compaction_locks[cf].for_read(), [this, task, cf, jobs_left] () mutable {
+          return with_scheduling_group(_scheduling_group, [this, task, cf, jobs_left] () mutable {
+            auto sstables = get_maintenance_candidates(*cf);
+            if (!*jobs_left) {
+                *jobs_left = sstables.size();
+            }
+            auto jobs = cf->get_compaction_strategy().get_reshaping_jobs(*cf, sstables);
+            if (jobs.empty() || jobs.size() > **jobs_left) {
+                _stats.pending_tasks--;
+                if (!sstables.empty()) {
+                    cmlog.info("Off-strategy compaction of {}.{} done, {} sstable(s) join regular compaction",
+                        cf->schema()->ks_name(), cf->schema()->cf_name(), sstables.size());
+                    cf->integrate_maintenance_sstables(sstables);
+                }
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            }
+            **jobs_left -= jobs.size();
+            cmlog.debug("Off-strategy compaction of {}.{}: reshaping {} sstable(s) in {} job(s)",
+                cf->schema()->ks_name(), cf->schema()->cf_name(), sstables.size(), jobs.size());
+
+            auto compacting = make_lw_shared<compacting_sstable_registration>(this, sstables);
+            _stats.pending_tasks--;
+            _stats.active_tasks++;
+            return do_with(std::move(jobs), [cf, compacting] (std::vector<sstables::compaction_descriptor>& jobs) {
+                return do_for_each(jobs, [cf, compacting] (sstables::compaction_descriptor& descriptor) {
+                    descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted) {
+                        compacting->release_compacting(exhausted);
+                    };
+                    return cf->compact_sstables(std::move(descriptor));
+                });
+            }).then_wrapped([this, task, compacting] (future<> f) mutable {
+                _stats.active_tasks--;
+                if (!can_proceed(task)) {
+                    maybe_stop_on_error(std::move(f));
+                    return make_ready_future<stop_iteration>(stop_iteration::yes);
+                }
+                if (maybe_stop_on_error(std::move(f))) {
+                    _stats.errors++;
+                    _stats.pending_tasks++;
+                    return put_task_to_sleep(task).then([] {
+                        return make_ready_future<stop_iteration>(stop_iteration::no);
+                    });
+                }
+                _stats.pending_tasks++;
+                _stats.completed_tasks++;
+                task->compaction_retry.reset();
+                return make_ready_future<stop_iteration>(stop_iteration::no);
+            });
+          });
+        });
+    }).finally([this, task] {
+        _tasks.remove(task);
+    });
+    return task->compaction_done.get_future().then([task] {});
+}
+
 future<> compaction_manager::run_resharding_job(column_family* cf, std::function<future<>()> job) {
     if (_stopped) {
         return make_ready_future<>();
@@ -460,14 +579,17 @@ void compaction_manager::submit(column_family* cf) {
                 postpone_compaction_for_column_family(&cf);
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
-            auto compacting = compacting_sstable_registration(this, descriptor.sstables);
+            auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
             descriptor.weight_registration = compaction_weight_registration(this, weight);
+            descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted) {
+                compacting->release_compacting(exhausted);
+            };
             cmlog.debug("Accepted compaction job ({} sstable(s)) of weight {} for {}.{}",
                 descriptor.sstables.size(), weight, cf.schema()->ks_name(), cf.schema()->cf_name());
 
             _stats.pending_tasks--;
             _stats.active_tasks++;
-            return cf.run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting = std::move(compacting)] (future<> f) mutable {
+            return cf.run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting] (future<> f) mutable {
                 _stats.active_tasks--;
 
                 if (!can_proceed(task)) {
@@ -520,7 +642,12 @@ future<> compaction_manager::perform_cleanup(column_family* cf) {
             return make_ready_future<stop_iteration>(stop_iteration::yes);
         }
         column_family& cf = *task->compacting_cf;
-        sstables::compaction_descriptor descriptor = sstables::compaction_descriptor(get_candidates(cf));
+        // Sstables waiting for off-strategy compaction may hold data we no longer own too.
+        // Their cleaned up replacements keep waiting for it.
+        auto sstables = get_candidates(cf);
+        auto maintenance_sstables = get_maintenance_candidates(cf);
+        sstables.insert(sstables.end(), maintenance_sstables.begin(), maintenance_sstables.end());
+        sstables::compaction_descriptor descriptor = sstables::compaction_descriptor(std::move(sstables));
         auto compacting = compacting_sstable_registration(this, descriptor.sstables);
 
         _stats.pending_tasks--;
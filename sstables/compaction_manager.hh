@@ -58,6 +58,7 @@ class compaction_manager {
         exponential_backoff_retry compaction_retry = exponential_backoff_retry(std::chrono::seconds(5), std::chrono::seconds(300));
         bool stopping = false;
         bool cleanup = false;
+        bool offstrategy = false;
     };
 
     // compaction manager may have N fibers to allow parallel compaction per shard.
@@ -115,6 +116,9 @@ class compaction_manager {
     // Get candidates for compaction strategy, which are all sstables but the ones being compacted.
     std::vector<sstables::shared_sstable> get_candidates(const column_family& cf);
 
+    // Get candidates for off-strategy compaction, which are the maintenance sstables but the ones being compacted.
+    std::vector<sstables::shared_sstable> get_maintenance_candidates(const column_family& cf);
+
     void register_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables);
     void deregister_compacting_sstables(const std::vector<sstables::shared_sstable>& sstables);
 
@@ -124,6 +128,9 @@ class compaction_manager {
     // Check if column family is being cleaned up.
     inline bool check_for_cleanup(column_family *cf);
 
+    // Check if column family is undergoing off-strategy compaction.
+    inline bool check_for_offstrategy(column_family *cf);
+
     inline future<> put_task_to_sleep(lw_shared_ptr<task>& task);
 
     // Compaction manager stop itself if it finds an storage I/O error which results in
@@ -162,6 +169,11 @@ class compaction_manager {
     // Submit a column family for major compaction.
     future<> submit_major_compaction(column_family* cf);
 
+    // Submit a column family for off-strategy compaction, which reshapes its maintenance
+    // sstables according to its compaction strategy, and then makes them subject to
+    // regular compaction. Does nothing if one is already running for the column family.
+    future<> submit_offstrategy_compaction(column_family* cf);
+
     // Run a resharding job for a given column family.
     // it completes when future returned by job is ready or returns immediately
     // if manager was asked to stop.
@@ -52,6 +52,7 @@
 #include "sstable_set.hh"
 #include "compatible_ring_position.hh"
 #include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/adjacent_find.hpp>
 #include <boost/range/adaptors.hpp>
 #include <boost/icl/interval_map.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
@@ -360,6 +361,34 @@ compaction_strategy_impl::get_resharding_jobs(column_family& cf, std::vector<sst
     return jobs;
 }
 
+std::vector<compaction_descriptor>
+compaction_strategy_impl::make_reshaping_jobs(std::vector<shared_sstable> input, size_t max_inputs, int level, uint64_t max_sstable_bytes) {
+    std::vector<compaction_descriptor> jobs;
+    boost::sort(input, [] (const shared_sstable& a, const shared_sstable& b) {
+        return a->compare_by_first_key(*b) < 0;
+    });
+    max_inputs = std::max(max_inputs, size_t(2));
+    // Spread the sstables evenly, so that no job is left with a single one.
+    auto count = (input.size() + max_inputs - 1) / max_inputs;
+    auto it = input.begin();
+    for (size_t i = 0; i < count; i++) {
+        auto n = (input.size() * (i + 1)) / count - (input.size() * i) / count;
+        jobs.emplace_back(std::vector<shared_sstable>(it, it + n), level, max_sstable_bytes);
+        it += n;
+    }
+    return jobs;
+}
+
+// Size-tiered strategies are best off with few sstables of similar sizes, so the
+// input is just merged together, max_compaction_threshold sstables at a time.
+std::vector<compaction_descriptor>
+compaction_strategy_impl::get_reshaping_jobs(column_family& cf, std::vector<sstables::shared_sstable> input) {
+    if (input.size() < 2) {
+        return {};
+    }
+    return make_reshaping_jobs(std::move(input), cf.schema()->max_compaction_threshold());
+}
+
 // Backlog for one SSTable under STCS:
 //
 //   (1) Bi = Ei * log4 (T / Si),
@@ -511,6 +540,10 @@ class null_compaction_strategy : public compaction_strategy_impl {
         return sstables::compaction_descriptor();
     }
 
+    virtual std::vector<compaction_descriptor> get_reshaping_jobs(column_family& cf, std::vector<sstables::shared_sstable> input) override {
+        return {};
+    }
+
     virtual int64_t estimated_pending_compactions(column_family& cf) const override {
         return 0;
     }
@@ -567,6 +600,12 @@ leveled_compaction_strategy::leveled_compaction_strategy(const std::map<sstring,
         leveled_manifest::logger.warn("Max sstable size of {}MB is configured. Testing done for CASSANDRA-5727 indicates that performance" \
             "improves up to 160MB", _max_sstable_size_in_mb);
     }
+
+    tmp_value = compaction_strategy_impl::get_value(options, L0_COMPACTION_PARALLELISM_OPTION);
+    _l0_compaction_parallelism = std::max(property_definitions::to_int(L0_COMPACTION_PARALLELISM_OPTION, tmp_value, DEFAULT_L0_COMPACTION_PARALLELISM), 1);
+
+    tmp_value = compaction_strategy_impl::get_value(options, STCS_IN_L0_THRESHOLD_OPTION);
+    _stcs_in_l0_threshold = std::max(property_definitions::to_int(STCS_IN_L0_THRESHOLD_OPTION, tmp_value, leveled_manifest::MAX_COMPACTING_L0), 0);
     _compaction_counter.resize(leveled_manifest::MAX_LEVELS);
 }
 
@@ -636,6 +675,10 @@ std::vector<resharding_descriptor> compaction_strategy::get_resharding_jobs(colu
     return _compaction_strategy_impl->get_resharding_jobs(cf, std::move(candidates));
 }
 
+std::vector<compaction_descriptor> compaction_strategy::get_reshaping_jobs(column_family& cf, std::vector<sstables::shared_sstable> input) {
+    return _compaction_strategy_impl->get_reshaping_jobs(cf, std::move(input));
+}
+
 void compaction_strategy::notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) {
     _compaction_strategy_impl->notify_completion(removed, added);
 }
@@ -51,6 +51,11 @@ class compaction_strategy_impl {
         return it->second;
     }
 protected:
+    // Splits input into compactions of at most max_inputs sstables each, with sstables
+    // adjacent in token order compacted together.
+    static std::vector<compaction_descriptor> make_reshaping_jobs(std::vector<shared_sstable> input, size_t max_inputs,
+            int level = 0, uint64_t max_sstable_bytes = std::numeric_limits<uint64_t>::max());
+
     compaction_strategy_impl() = default;
     explicit compaction_strategy_impl(const std::map<sstring, sstring>& options) {
         using namespace cql3::statements;
@@ -68,6 +73,10 @@ class compaction_strategy_impl {
     virtual ~compaction_strategy_impl() {}
     virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) = 0;
     virtual std::vector<resharding_descriptor> get_resharding_jobs(column_family& cf, std::vector<sstables::shared_sstable> candidates);
+    // Returns compactions which bring sstables kept out of regular compaction, like the ones
+    // written by streaming, closer to the shape the strategy expects, or none if they can
+    // join the other sstables as they are.
+    virtual std::vector<compaction_descriptor> get_reshaping_jobs(column_family& cf, std::vector<sstables::shared_sstable> input);
     virtual void notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) { }
     virtual compaction_strategy_type type() const = 0;
     virtual bool parallel_compaction() const {
@@ -98,6 +98,20 @@ static inline size_t write_unsigned_var_int(unsigned int value, uint8_t* to) {
     return size;
 }
 
+static inline unsigned int read_unsigned_var_int(const uint8_t*& from, const uint8_t* end) {
+    unsigned int value = 0;
+    unsigned int shift = 0;
+    while (from != end && shift < 32) {
+        uint8_t byte = *from++;
+        value |= unsigned(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+        shift += 7;
+    }
+    throw std::invalid_argument("malformed variable-length integer");
+}
+
 /** @class HyperLogLog
  *  @brief Implement of 'HyperLogLog' estimate cardinality algorithm
  */
@@ -137,11 +151,42 @@ class HyperLogLog {
         alphaMM_ = alpha * m_ * m_;
     }
 
+    /**
+     * Creates a HyperLogLog from the format written by get_bytes().
+     *
+     * @exception std::invalid_argument the buffer is malformed or uses a format
+     *            which is not supported, like the sparse one.
+     */
     static HyperLogLog from_bytes(temporary_buffer<uint8_t> bytes) {
-        // FIXME: implement class that creates a HyperLogLog from an array of bytes.
-        // This will useful if we need to work with the cardinality data from the
-        // compaction metadata.
-        abort();
+        static constexpr int version = 2;
+
+        const uint8_t* p = bytes.get();
+        const uint8_t* end = p + bytes.size();
+        if (size_t(end - p) < sizeof(int)) {
+            throw std::invalid_argument("cardinality metadata is truncated");
+        }
+        if (read_be<int32_t>(reinterpret_cast<const char*>(p)) != -version) {
+            throw std::invalid_argument("unsupported cardinality metadata version");
+        }
+        p += sizeof(int);
+
+        auto b = read_unsigned_var_int(p, end);
+        auto sp = read_unsigned_var_int(p, end);
+        auto type = read_unsigned_var_int(p, end);
+        auto size = read_unsigned_var_int(p, end);
+        if (b < 4 || 16 < b) {
+            throw std::invalid_argument("bit width must be in the range [4,16]");
+        }
+        if (sp != 0 || type != 0) {
+            throw std::invalid_argument("sparse cardinality metadata is not supported");
+        }
+        if (size != (1u << b) || size_t(end - p) < size) {
+            throw std::invalid_argument("cardinality metadata has unexpected register size");
+        }
+
+        HyperLogLog ret(b);
+        std::copy(p, p + size, ret.M_.begin());
+        return ret;
     }
 
     /**
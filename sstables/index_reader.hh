@@ -380,6 +380,8 @@ class index_reader {
         , _index_lists(index_lists)
     {
         sstlog.trace("index {}: index_reader for {}", this, _sstable->get_filename());
+        ++_sstable->_active_index_readers;
+        ++_sstable->_index_reads;
     }
 
     index_reader(const index_reader& r)
@@ -396,6 +398,11 @@ class index_reader {
         , _element(r._element)
     {
         sstlog.trace("index {}: index_reader for {}", this, _sstable->get_filename());
+        ++_sstable->_active_index_readers;
+    }
+
+    ~index_reader() {
+        --_sstable->_active_index_readers;
     }
 
     // Valid if partition_data_ready()
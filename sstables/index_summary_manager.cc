@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cmath>
+#include <boost/range/algorithm/sort.hpp>
+#include <seastar/core/thread.hh>
+
+#include "sstables/index_summary_manager.hh"
+#include "sstables/sstables.hh"
+#include "sstables/downsampling.hh"
+#include "service/priority_manager.hh"
+#include "log.hh"
+
+namespace sstables {
+
+static logging::logger ismlog("index_summary_manager");
+
+index_summary_manager::index_summary_manager(size_t capacity, std::chrono::seconds interval, sstables_source sstables)
+    : _capacity(capacity)
+    , _sstables(std::move(sstables))
+    , _timer([this] {
+        redistribute().handle_exception([] (std::exception_ptr ep) {
+            ismlog.warn("Failed to redistribute index summaries: {}", ep);
+        });
+    })
+{
+    if (interval.count()) {
+        _timer.arm_periodic(interval);
+    }
+}
+
+future<> index_summary_manager::redistribute() {
+    if (_redistributing) {
+        return make_ready_future<>();
+    }
+    _redistributing = true;
+    return with_gate(_gate, [this] {
+        return do_redistribute();
+    }).finally([this] {
+        _redistributing = false;
+    });
+}
+
+future<> index_summary_manager::do_redistribute() {
+    return seastar::async([this] {
+        struct candidate {
+            shared_sstable sst;
+            uint64_t reads;
+            // Memory used by the summary at full sampling.
+            uint64_t full_size;
+            int min_sampling_level;
+        };
+        std::vector<candidate> candidates;
+        uint64_t fixed_size = 0;
+        uint64_t total_full_size = 0;
+        uint64_t total_reads = 0;
+        for (auto& sst : _sstables()) {
+            auto size = sst->get_summary().memory_footprint();
+            auto reads = sst->take_index_reads();
+            if (sst->is_shared()) {
+                fixed_size += size;
+                continue;
+            }
+            auto& s = *sst->get_schema();
+            auto min_sampling_level = std::max(1, downsampling::BASE_SAMPLING_LEVEL * s.min_index_interval() / s.max_index_interval());
+            auto full_size = size * downsampling::BASE_SAMPLING_LEVEL / sst->summary_sampling_level();
+            candidates.push_back(candidate{sst, reads, full_size, min_sampling_level});
+            total_full_size += full_size;
+            total_reads += reads;
+        }
+
+        // The densest summaries in terms of reads are the first to get full sampling,
+        // whatever share of the budget they don't need is left to the others.
+        boost::sort(candidates, [] (const candidate& a, const candidate& b) {
+            return double(a.reads) * b.full_size > double(b.reads) * a.full_size;
+        });
+        auto remaining_capacity = _capacity > fixed_size ? _capacity - fixed_size : 0;
+        auto fits = total_full_size <= remaining_capacity;
+        unsigned downsampled = 0;
+        unsigned upsampled = 0;
+        for (auto& c : candidates) {
+            int sampling_level = downsampling::BASE_SAMPLING_LEVEL;
+            if (!fits) {
+                auto share = total_reads
+                        ? remaining_capacity * (double(c.reads) / total_reads)
+                        : remaining_capacity * (double(c.full_size) / total_full_size);
+                sampling_level = std::ceil(downsampling::BASE_SAMPLING_LEVEL * share / std::max(c.full_size, uint64_t(1)));
+                sampling_level = std::max(c.min_sampling_level, std::min(sampling_level, int(downsampling::BASE_SAMPLING_LEVEL)));
+                auto size = c.full_size * sampling_level / downsampling::BASE_SAMPLING_LEVEL;
+                remaining_capacity -= std::min(size, remaining_capacity);
+                total_reads -= c.reads;
+                total_full_size -= c.full_size;
+            }
+
+            auto current_sampling_level = c.sst->summary_sampling_level();
+            if (sampling_level >= current_sampling_level * upsample_threshold
+                    || (sampling_level == downsampling::BASE_SAMPLING_LEVEL && current_sampling_level < sampling_level)) {
+                if (!c.sst->restore_summary(service::get_local_compaction_priority()).get0()) {
+                    continue;
+                }
+                current_sampling_level = downsampling::BASE_SAMPLING_LEVEL;
+                upsampled++;
+            }
+            if (sampling_level <= current_sampling_level * downsample_threshold && c.sst->can_resample_summary()) {
+                c.sst->downsample_summary(sampling_level);
+                downsampled++;
+            }
+            seastar::thread::yield();
+        }
+        ismlog.debug("Redistributed {} bytes of index summaries among {} sstables: {} downsampled, {} upsampled",
+                _capacity, candidates.size(), downsampled, upsampled);
+    });
+}
+
+future<> index_summary_manager::stop() {
+    _timer.cancel();
+    return _gate.close();
+}
+
+}
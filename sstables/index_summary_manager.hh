@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+#include "sstables/shared_sstable.hh"
+
+namespace sstables {
+
+// Keeps the memory used by the index summaries of the sstables of a shard within
+// a budget.
+//
+// Summaries are periodically resampled according to how often they were read
+// since the last time: the budget is split among sstables proportionally to
+// their reads, so the hottest ones keep full sampling, and cold ones are
+// downsampled, down to the minimum allowed by the max_index_interval of their
+// schema. A summary which got enough share of the budget back is read again at
+// full sampling from disk.
+class index_summary_manager {
+public:
+    using sstables_source = std::function<std::vector<shared_sstable>()>;
+    // A summary is only downsampled or upsampled by at least these factors,
+    // so that it isn't resampled back and forth for small changes in its reads.
+    static constexpr double downsample_threshold = 0.75;
+    static constexpr double upsample_threshold = 1.5;
+private:
+    size_t _capacity;
+    sstables_source _sstables;
+    timer<lowres_clock> _timer;
+    seastar::gate _gate;
+    bool _redistributing = false;
+private:
+    future<> do_redistribute();
+public:
+    // The sstables of the shard are enumerated by sstables. If interval
+    // is zero, summaries are only resampled by explicit calls to redistribute().
+    index_summary_manager(size_t capacity, std::chrono::seconds interval, sstables_source sstables);
+
+    // Resamples summaries of all sstables to fit into the budget.
+    future<> redistribute();
+
+    future<> stop();
+
+    size_t capacity() const {
+        return _capacity;
+    }
+};
+
+}
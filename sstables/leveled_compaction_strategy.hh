@@ -27,9 +27,15 @@ namespace sstables {
 
 class leveled_compaction_strategy : public compaction_strategy_impl {
     static constexpr int32_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 160;
+    static constexpr int32_t DEFAULT_L0_COMPACTION_PARALLELISM = 4;
     const sstring SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+    const sstring L0_COMPACTION_PARALLELISM_OPTION = "l0_compaction_parallelism";
+    const sstring STCS_IN_L0_THRESHOLD_OPTION = "stcs_in_l0_threshold";
 
     int32_t _max_sstable_size_in_mb = DEFAULT_MAX_SSTABLE_SIZE_IN_MB;
+    // Number of disjoint token sub-ranges L0 to L1 compactions are split into, and run in parallel.
+    int32_t _l0_compaction_parallelism = DEFAULT_L0_COMPACTION_PARALLELISM;
+    int32_t _stcs_in_l0_threshold = leveled_manifest::MAX_COMPACTING_L0;
     stdx::optional<std::vector<stdx::optional<dht::decorated_key>>> _last_compacted_keys;
     std::vector<int> _compaction_counter;
     size_tiered_compaction_strategy_options _stcs_options;
@@ -40,6 +46,8 @@ class leveled_compaction_strategy : public compaction_strategy_impl {
 
     virtual std::vector<resharding_descriptor> get_resharding_jobs(column_family& cf, std::vector<shared_sstable> candidates) override;
 
+    virtual std::vector<compaction_descriptor> get_reshaping_jobs(column_family& cf, std::vector<shared_sstable> input) override;
+
     virtual void notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) override;
 
     // for each level > 0, get newest sstable and use its last key as last
@@ -68,7 +76,7 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
     // lists managed by the manifest may become outdated. For example, one
     // sstable in it may be marked for deletion after compacted.
     // Currently, we create a new manifest whenever it's time for compaction.
-    leveled_manifest manifest = leveled_manifest::create(cfs, candidates, _max_sstable_size_in_mb, _stcs_options);
+    leveled_manifest manifest = leveled_manifest::create(cfs, candidates, _max_sstable_size_in_mb, _stcs_options, _stcs_in_l0_threshold);
     if (!_last_compacted_keys) {
         generate_last_compacted_keys(manifest);
     }
@@ -76,6 +84,15 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
 
     if (!candidate.sstables.empty()) {
         leveled_manifest::logger.debug("leveled: Compacting {} out of {} sstables", candidate.sstables.size(), cfs.get_sstables()->size());
+        // Promoting L0 rewrites all of the L1 sstables it overlaps, which takes long enough for L0
+        // to pile up under heavy writes. The output is a run of non-overlapping sstables anyway, so
+        // it's produced by compacting disjoint sub-ranges of the input in parallel.
+        auto promotes_l0 = candidate.level == 1 && boost::algorithm::any_of(candidate.sstables, [] (const shared_sstable& sst) {
+            return sst->get_sstable_level() == 0;
+        });
+        if (promotes_l0) {
+            candidate.parallelism = _l0_compaction_parallelism;
+        }
         return std::move(candidate);
     }
 
@@ -103,7 +120,7 @@ compaction_descriptor leveled_compaction_strategy::get_sstables_for_compaction(c
 }
 
 std::vector<resharding_descriptor> leveled_compaction_strategy::get_resharding_jobs(column_family& cf, std::vector<shared_sstable> candidates) {
-    leveled_manifest manifest = leveled_manifest::create(cf, candidates, _max_sstable_size_in_mb, _stcs_options);
+    leveled_manifest manifest = leveled_manifest::create(cf, candidates, _max_sstable_size_in_mb, _stcs_options, _stcs_in_l0_threshold);
 
     std::vector<resharding_descriptor> descriptors;
     shard_id target_shard = 0;
@@ -135,6 +152,46 @@ std::vector<resharding_descriptor> leveled_compaction_strategy::get_resharding_j
     return descriptors;
 }
 
+// Streamed sstables overlap each other, and would all land in level 0, where every read
+// has to look at them. They're merged into runs of non-overlapping sstables of the target
+// size instead, until they form a single run or no more progress can be made. A run which
+// doesn't overlap the sstables in level 1 is placed there, as LCS would promote it anyway.
+std::vector<compaction_descriptor> leveled_compaction_strategy::get_reshaping_jobs(column_family& cf, std::vector<shared_sstable> input) {
+    auto& s = *cf.schema();
+    boost::sort(input, [] (auto& i, auto& j) {
+        return i->compare_by_first_key(*j) < 0;
+    });
+    auto overlapping = boost::adjacent_find(input, [&s] (auto& i, auto& j) {
+        return i->get_last_decorated_key().tri_compare(s, j->get_first_decorated_key()) >= 0;
+    }) != input.end();
+
+    auto maintenance = boost::copy_range<std::unordered_set<shared_sstable>>(cf.maintenance_sstables());
+    auto level_1 = boost::copy_range<std::vector<shared_sstable>>(*cf.get_sstables()
+        | boost::adaptors::filtered([&maintenance] (const shared_sstable& sst) {
+            return sst->get_sstable_level() == 1 && !maintenance.count(sst);
+        }));
+    auto overlaps_level_1 = !input.empty() && !level_1.empty() && !leveled_manifest::overlapping(s, input, level_1).empty();
+    auto max_sstable_bytes = uint64_t(_max_sstable_size_in_mb)*1024*1024;
+
+    if (!overlapping) {
+        // Regular compaction may have written level 1 sstables overlapping the run since
+        // it was placed there, so it's sent back to level 0.
+        auto leveled = boost::algorithm::any_of(input, [] (const shared_sstable& sst) {
+            return sst->get_sstable_level() > 0;
+        });
+        if (leveled && overlaps_level_1) {
+            return { compaction_descriptor(std::move(input), 0, max_sstable_bytes) };
+        }
+        return {};
+    }
+    auto jobs = make_reshaping_jobs(std::move(input), s.max_compaction_threshold(), 0, max_sstable_bytes);
+    // Outputs of separate jobs overlap each other, so only a single one can go to level 1.
+    if (jobs.size() == 1 && !overlaps_level_1) {
+        jobs.front().level = 1;
+    }
+    return jobs;
+}
+
 void leveled_compaction_strategy::notify_completion(const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) {
     if (removed.empty() || added.empty()) {
         return;
@@ -180,7 +237,7 @@ int64_t leveled_compaction_strategy::estimated_pending_compactions(column_family
     for (auto& entry : *cf.get_sstables()) {
         sstables.push_back(entry);
     }
-    leveled_manifest manifest = leveled_manifest::create(cf, sstables, _max_sstable_size_in_mb, _stcs_options);
+    leveled_manifest manifest = leveled_manifest::create(cf, sstables, _max_sstable_size_in_mb, _stcs_options, _stcs_in_l0_threshold);
     return manifest.get_estimated_tasks();
 }
 
@@ -53,6 +53,9 @@ class leveled_manifest {
     std::vector<std::vector<sstables::shared_sstable>> _generations;
     uint64_t _max_sstable_size_in_bytes;
     const sstables::size_tiered_compaction_strategy_options& _stcs_options;
+    // Number of sstables in L0 above which it's size-tiered compacted before higher
+    // levels are, or 0 to never do that.
+    int _stcs_in_l0_threshold;
 
     struct candidates_info {
         std::vector<sstables::shared_sstable> candidates;
@@ -80,10 +83,12 @@ class leveled_manifest {
     // level to be considered worth compacting.
     static constexpr float TARGET_SCORE = 1.001f;
 private:
-    leveled_manifest(column_family& cfs, int max_sstable_size_in_MB, const sstables::size_tiered_compaction_strategy_options& stcs_options)
+    leveled_manifest(column_family& cfs, int max_sstable_size_in_MB, const sstables::size_tiered_compaction_strategy_options& stcs_options,
+            int stcs_in_l0_threshold)
         : _schema(cfs.schema())
         , _max_sstable_size_in_bytes(max_sstable_size_in_MB * 1024 * 1024)
         , _stcs_options(stcs_options)
+        , _stcs_in_l0_threshold(stcs_in_l0_threshold)
     {
         // allocate enough generations for a PB of data, with a 1-MB sstable size.  (Note that if maxSSTableSize is
         // updated, we will still have sstables of the older, potentially smaller size.  So don't make this
@@ -92,8 +97,8 @@ class leveled_manifest {
     }
 public:
     static leveled_manifest create(column_family& cf, std::vector<sstables::shared_sstable>& sstables, int max_sstable_size_in_mb,
-            const sstables::size_tiered_compaction_strategy_options& stcs_options) {
-        leveled_manifest manifest = leveled_manifest(cf, max_sstable_size_in_mb, stcs_options);
+            const sstables::size_tiered_compaction_strategy_options& stcs_options, int stcs_in_l0_threshold = MAX_COMPACTING_L0) {
+        leveled_manifest manifest = leveled_manifest(cf, max_sstable_size_in_mb, stcs_options, stcs_in_l0_threshold);
 
         // ensure all SSTables are in the manifest
         // FIXME: there can be tens of thousands of sstables. we can avoid this potentially expensive procedure if
@@ -224,8 +229,7 @@ class leveled_manifest {
                 continue;
             }
             // before proceeding with a higher level, let's see if L0 is far enough behind to warrant STCS
-            // TODO: we shouldn't proceed with size tiered strategy if cassandra.disable_stcs_in_l0 is true.
-            if (get_level_size(0) > MAX_COMPACTING_L0) {
+            if (_stcs_in_l0_threshold && get_level_size(0) > size_t(_stcs_in_l0_threshold)) {
                 auto most_interesting = sstables::size_tiered_compaction_strategy::most_interesting_bucket(get_level(0),
                     _schema->min_compaction_threshold(), _schema->max_compaction_threshold(), _stcs_options);
                 if (!most_interesting.empty()) {
@@ -1022,6 +1022,7 @@ class sstable_mutation_reader : public flat_mutation_reader::impl {
         _partition_finished = false;
         _end_of_stream = false;
         _current_partition_key = std::move(key);
+        _monitor.on_partition_start(*_current_partition_key);
         push_mutation_fragment(
             mutation_fragment(partition_start(*_current_partition_key, tomb)));
     }
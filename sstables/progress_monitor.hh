@@ -26,6 +26,10 @@
 #include <seastar/core/shared_ptr.hh>
 #include "shared_sstable.hh"
 
+namespace dht {
+class decorated_key;
+}
+
 namespace sstables {
 
 struct writer_offset_tracker {
@@ -61,6 +65,8 @@ class read_monitor {
     // parameters are the current position in the data file
     virtual void on_read_started(const reader_position_tracker&) = 0;
     virtual void on_read_completed() = 0;
+    // called whenever the reader emits the start of a partition
+    virtual void on_partition_start(const dht::decorated_key&) { }
 };
 
 struct noop_read_monitor final : public read_monitor {
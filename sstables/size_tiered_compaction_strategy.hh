@@ -115,35 +115,81 @@ class size_tiered_compaction_strategy_options {
 class size_tiered_compaction_strategy : public compaction_strategy_impl {
     size_tiered_compaction_strategy_options _options;
     compaction_backlog_tracker _backlog_tracker;
+public:
+    // Sstables written by a single compaction which splits its output, or links some of its
+    // input into it, form a run: they hold disjoint ranges of partitions and share the same
+    // ancestors. A run is tiered as if it were a single sstable, otherwise its sstables would
+    // keep being compacted with each other.
+    using sstable_run = std::vector<sstables::shared_sstable>;
+
+    static std::vector<sstable_run> group_into_runs(const std::vector<sstables::shared_sstable>& sstables);
+private:
+    static std::vector<sstables::shared_sstable> flatten(const std::vector<sstable_run>& runs) {
+        std::vector<sstables::shared_sstable> ret;
+        for (auto& run : runs) {
+            ret.insert(ret.end(), run.begin(), run.end());
+        }
+        return ret;
+    }
+
+    static uint64_t run_size(const sstable_run& run) {
+        uint64_t n = 0;
+        for (auto& sstable : run) {
+            // FIXME: Switch to sstable->bytes_on_disk() afterwards. That's what C* uses.
+            n += sstable->data_size();
+        }
+        return n;
+    }
 
-    // Return a list of pair of shared_sstable and its respective size.
-    std::vector<std::pair<sstables::shared_sstable, uint64_t>> create_sstable_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables) const;
+    // Return a list of pair of sstable run and its respective size.
+    std::vector<std::pair<sstable_run, uint64_t>> create_run_and_length_pairs(std::vector<sstable_run> runs) const;
 
-    // Group files of similar size into buckets.
-    std::vector<std::vector<sstables::shared_sstable>> get_buckets(const std::vector<sstables::shared_sstable>& sstables) const;
+    // Group runs of similar size into buckets.
+    std::vector<std::vector<sstable_run>> get_buckets(const std::vector<sstables::shared_sstable>& sstables) const;
 
     // Maybe return a bucket of sstables to compact
     std::vector<sstables::shared_sstable>
-    most_interesting_bucket(std::vector<std::vector<sstables::shared_sstable>> buckets, unsigned min_threshold, unsigned max_threshold);
+    most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets, unsigned min_threshold, unsigned max_threshold);
 
-    // Return the average size of a given list of sstables.
-    uint64_t avg_size(std::vector<sstables::shared_sstable>& sstables) {
-        assert(sstables.size() > 0); // this should never fail
+    // Return the average size of a given list of runs.
+    uint64_t avg_size(std::vector<sstable_run>& runs) {
+        assert(runs.size() > 0); // this should never fail
         uint64_t n = 0;
 
-        for (auto& sstable : sstables) {
-            // FIXME: Switch to sstable->bytes_on_disk() afterwards. That's what C* uses.
-            n += sstable->data_size();
+        for (auto& run : runs) {
+            n += run_size(run);
         }
 
-        return n / sstables.size();
+        return n / runs.size();
+    }
+
+    // Trims bucket to max_threshold runs. Keeps the first (smallest) one, and picks
+    // the others by how many partitions they share with it, so that the compaction
+    // deduplicates as much data as it can.
+    static void trim_to_threshold(std::vector<sstable_run>& bucket, unsigned max_threshold) {
+        if (bucket.size() <= max_threshold || !max_threshold) {
+            bucket.resize(std::min(bucket.size(), size_t(max_threshold)));
+            return;
+        }
+        auto overlap_with_first = boost::copy_range<std::vector<std::pair<double, sstable_run>>>(
+                boost::make_iterator_range(std::next(bucket.begin()), bucket.end())
+                | boost::adaptors::transformed([&bucket] (const sstable_run& run) {
+            return std::make_pair(estimate_partition_overlap(flatten({ bucket.front(), run })), run);
+        }));
+        std::stable_sort(overlap_with_first.begin(), overlap_with_first.end(), [] (auto& a, auto& b) {
+            return a.first > b.first;
+        });
+        bucket.resize(1);
+        for (auto& p : overlap_with_first | boost::adaptors::sliced(0, max_threshold - 1)) {
+            bucket.push_back(std::move(p.second));
+        }
     }
 
-    bool is_bucket_interesting(const std::vector<sstables::shared_sstable>& bucket, int min_threshold) const {
+    bool is_bucket_interesting(const std::vector<sstable_run>& bucket, int min_threshold) const {
         return bucket.size() >= size_t(min_threshold);
     }
 
-    bool is_any_bucket_interesting(const std::vector<std::vector<sstables::shared_sstable>>& buckets, int min_threshold) const {
+    bool is_any_bucket_interesting(const std::vector<std::vector<sstable_run>>& buckets, int min_threshold) const {
         return boost::algorithm::any_of(buckets, [&] (const auto& bucket) {
             return this->is_bucket_interesting(bucket, min_threshold);
         });
@@ -172,35 +218,57 @@ class size_tiered_compaction_strategy : public compaction_strategy_impl {
     }
 };
 
-inline std::vector<std::pair<sstables::shared_sstable, uint64_t>>
-size_tiered_compaction_strategy::create_sstable_and_length_pairs(const std::vector<sstables::shared_sstable>& sstables) const {
+inline std::vector<size_tiered_compaction_strategy::sstable_run>
+size_tiered_compaction_strategy::group_into_runs(const std::vector<sstables::shared_sstable>& sstables) {
+    std::vector<sstable_run> runs;
+    std::map<std::vector<uint64_t>, size_t> run_of_ancestors;
+
+    for (auto& sstable : sstables) {
+        auto ancestors = boost::copy_range<std::vector<uint64_t>>(sstable->ancestors());
+        if (ancestors.empty()) {
+            runs.push_back({ sstable });
+            continue;
+        }
+        boost::sort(ancestors);
+        auto it = run_of_ancestors.emplace(std::move(ancestors), runs.size()).first;
+        if (it->second == runs.size()) {
+            runs.emplace_back();
+        }
+        runs[it->second].push_back(sstable);
+    }
+
+    return runs;
+}
+
+inline std::vector<std::pair<size_tiered_compaction_strategy::sstable_run, uint64_t>>
+size_tiered_compaction_strategy::create_run_and_length_pairs(std::vector<sstable_run> runs) const {
 
-    std::vector<std::pair<sstables::shared_sstable, uint64_t>> sstable_length_pairs;
-    sstable_length_pairs.reserve(sstables.size());
+    std::vector<std::pair<sstable_run, uint64_t>> run_length_pairs;
+    run_length_pairs.reserve(runs.size());
 
-    for(auto& sstable : sstables) {
-        auto sstable_size = sstable->data_size();
-        assert(sstable_size != 0);
+    for(auto& run : runs) {
+        auto size = run_size(run);
+        assert(size != 0);
 
-        sstable_length_pairs.emplace_back(sstable, sstable_size);
+        run_length_pairs.emplace_back(std::move(run), size);
     }
 
-    return sstable_length_pairs;
+    return run_length_pairs;
 }
 
-inline std::vector<std::vector<sstables::shared_sstable>>
+inline std::vector<std::vector<size_tiered_compaction_strategy::sstable_run>>
 size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_sstable>& sstables) const {
-    // sstables sorted by size of its data file.
-    auto sorted_sstables = create_sstable_and_length_pairs(sstables);
+    // runs sorted by size of their data files.
+    auto sorted_runs = create_run_and_length_pairs(group_into_runs(sstables));
 
-    std::sort(sorted_sstables.begin(), sorted_sstables.end(), [] (auto& i, auto& j) {
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
         return i.second < j.second;
     });
 
-    std::map<size_t, std::vector<sstables::shared_sstable>> buckets;
+    std::map<size_t, std::vector<sstable_run>> buckets;
 
     bool found;
-    for (auto& pair : sorted_sstables) {
+    for (auto& pair : sorted_runs) {
         found = false;
         size_t size = pair.second;
 
@@ -216,7 +284,7 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
                 size_t total_size = bucket.size() * old_average_size;
                 size_t new_average_size = (total_size + size) / (bucket.size() + 1);
 
-                bucket.push_back(pair.first);
+                bucket.push_back(std::move(pair.first));
                 buckets.erase(it);
                 buckets.insert({ new_average_size, std::move(bucket) });
 
@@ -227,13 +295,13 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
 
         // no similar bucket found; put it in a new one
         if (!found) {
-            std::vector<sstables::shared_sstable> new_bucket;
-            new_bucket.push_back(pair.first);
+            std::vector<sstable_run> new_bucket;
+            new_bucket.push_back(std::move(pair.first));
             buckets.insert({ size, std::move(new_bucket) });
         }
     }
 
-    std::vector<std::vector<sstables::shared_sstable>> bucket_list;
+    std::vector<std::vector<sstable_run>> bucket_list;
     bucket_list.reserve(buckets.size());
 
     for (auto& entry : buckets) {
@@ -244,10 +312,10 @@ size_tiered_compaction_strategy::get_buckets(const std::vector<sstables::shared_
 }
 
 inline std::vector<sstables::shared_sstable>
-size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstables::shared_sstable>> buckets,
+size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets,
         unsigned min_threshold, unsigned max_threshold)
 {
-    std::vector<std::pair<std::vector<sstables::shared_sstable>, uint64_t>> pruned_buckets_and_hotness;
+    std::vector<std::pair<std::vector<sstable_run>, uint64_t>> pruned_buckets_and_hotness;
     pruned_buckets_and_hotness.reserve(buckets.size());
 
     // FIXME: add support to get hotness for each bucket.
@@ -255,8 +323,8 @@ size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector
     for (auto& bucket : buckets) {
         // FIXME: the coldest sstables will be trimmed to meet the threshold, so we must add support to this feature
         // by converting SizeTieredCompactionStrategy::trimToThresholdWithHotness.
-        // By the time being, we will only compact buckets that meet the threshold.
-        bucket.resize(std::min(bucket.size(), size_t(max_threshold)));
+        // By the time being, we trim by partition overlap instead.
+        trim_to_threshold(bucket, max_threshold);
         if (is_bucket_interesting(bucket, min_threshold)) {
             auto avg = avg_size(bucket);
             pruned_buckets_and_hotness.push_back({ std::move(bucket), avg });
@@ -273,7 +341,7 @@ size_tiered_compaction_strategy::most_interesting_bucket(std::vector<std::vector
 
         return i.second < j.second;
     });
-    auto hottest = std::move(min.first);
+    auto hottest = flatten(min.first);
 
     return hottest;
 }
@@ -298,7 +366,8 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(column_family& cfs,
     // ratio is greater than threshold.
     // prefer oldest sstables from biggest size tiers because they will be easier to satisfy conditions for
     // tombstone purge, i.e. less likely to shadow even older data.
-    for (auto&& sstables : buckets | boost::adaptors::reversed) {
+    for (auto&& bucket : buckets | boost::adaptors::reversed) {
+        auto sstables = flatten(bucket);
         // filter out sstables which droppable tombstone ratio isn't greater than the defined threshold.
         auto e = boost::range::remove_if(sstables, [this, &gc_before] (const sstables::shared_sstable& sst) -> bool {
             return !worth_dropping_tombstones(sst, gc_before);
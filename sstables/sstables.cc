@@ -1437,18 +1437,25 @@ void sstable::write_filter(const io_priority_class& pc) {
 
 // This interface is only used during tests, snapshot loading and early initialization.
 // No need to set tunable priorities for it.
-future<> sstable::load(const io_priority_class& pc) {
-    return read_toc().then([this, &pc] {
+future<> sstable::load(const io_priority_class& pc, bool defer_filter) {
+    return read_toc().then([this, &pc, defer_filter] {
         return seastar::when_all_succeed(
                 read_statistics(pc),
                 read_compression(pc),
                 read_scylla_metadata(pc),
-                read_filter(pc),
+                defer_filter ? defer_read_filter() : read_filter(pc),
                 read_summary(pc)).then([this] {
             validate_min_max_metadata();
             validate_max_local_deletion_time();
             set_clustering_components_ranges();
             return open_data();
+        }).then([this, &pc] {
+            // Only the owner of the sstable may replace the placeholder, so that the
+            // filter isn't replaced while other shards are using it.
+            if (_shards.size() != 1) {
+                return load_deferred_filter(pc);
+            }
+            return make_ready_future<>();
         });
     });
 }
@@ -1465,10 +1472,74 @@ future<> sstable::load(sstables::foreign_sstable_open_info info) {
     });
 }
 
+future<> sstable::defer_read_filter() {
+    _components->filter = std::make_unique<utils::filter::always_present_filter>();
+    _components->filter_deferred = has_component(component_type::Filter);
+    return make_ready_future<>();
+}
+
+future<> sstable::load_deferred_filter(const io_priority_class& pc) {
+    if (!_components->filter_deferred) {
+        return make_ready_future<>();
+    }
+    return read_filter(pc).then([this] {
+        _components->filter_deferred = false;
+    });
+}
+
+void sstable::downsample_summary(int sampling_level) {
+    assert(can_resample_summary());
+    auto& s = _components->summary;
+    auto current_sampling_level = int(s.header.sampling_level);
+    assert(sampling_level > 0 && sampling_level < current_sampling_level);
+    auto start_points = downsampling::get_start_points(current_sampling_level, sampling_level);
+
+    summary downsampled;
+    downsampled.header = s.header;
+    downsampled.header.sampling_level = sampling_level;
+    downsampled.header.memory_size = 0;
+    // The first entry is removed only when going down to level 0, so the index
+    // is still searched from its beginning.
+    for (size_t i = 0; i < s.entries.size(); ++i) {
+        auto removed = std::any_of(start_points.begin(), start_points.end(), [&] (int start) {
+            return i >= size_t(start) && (i - start) % current_sampling_level == 0;
+        });
+        if (!removed) {
+            downsampled.entries.push_back(std::move(s.entries[i]));
+        }
+    }
+    downsampled.header.size = downsampled.entries.size();
+    downsampled.header.memory_size = downsampled.header.size * sizeof(uint32_t);
+    for (auto& e : downsampled.entries) {
+        downsampled.positions.push_back(downsampled.header.memory_size);
+        downsampled.header.memory_size += e.key.size() + sizeof(e.position);
+    }
+    downsampled.first_key = std::move(s.first_key);
+    downsampled.last_key = std::move(s.last_key);
+    sstlog.debug("Downsampled summary of {} from level {} to {}, {} entries left of {}",
+            get_filename(), current_sampling_level, sampling_level, downsampled.entries.size(), s.entries.size());
+    s = std::move(downsampled);
+}
+
+future<bool> sstable::restore_summary(const io_priority_class& pc) {
+    if (!has_component(component_type::Summary) || summary_sampling_level() == downsampling::BASE_SAMPLING_LEVEL) {
+        return make_ready_future<bool>(false);
+    }
+    return do_with(summary(), [this, &pc] (summary& s) {
+        return read_simple<component_type::Summary>(s, pc).then([this, &s] {
+            if (!can_resample_summary()) {
+                return false;
+            }
+            _components->summary = std::move(s);
+            return true;
+        });
+    });
+}
+
 future<sstable_open_info> sstable::load_shared_components(const schema_ptr& s, sstring dir, int generation, version_types v, format_types f,
-        const io_priority_class& pc) {
+        const io_priority_class& pc, bool defer_filter) {
     auto sst = sstables::make_sstable(s, dir, generation, v, f);
-    return sst->load(pc).then([sst] () mutable {
+    return sst->load(pc, defer_filter).then([sst] () mutable {
         auto info = sstable_open_info{make_lw_shared<shareable_components>(std::move(*sst->_components)),
             std::move(sst->_shards), std::move(sst->_data_file), std::move(sst->_index_file)};
         return make_ready_future<sstable_open_info>(std::move(info));
@@ -2762,6 +2833,25 @@ double sstable::get_compression_ratio() const {
     }
 }
 
+stdx::optional<hll::HyperLogLog> sstable::get_cardinality_estimator() const {
+    auto entry = _components->statistics.contents.find(metadata_type::Compaction);
+    if (entry == _components->statistics.contents.end() || !entry->second) {
+        return { };
+    }
+    auto& elements = static_cast<const compaction_metadata*>(entry->second.get())->cardinality.elements;
+    if (elements.empty()) {
+        return { };
+    }
+    temporary_buffer<uint8_t> buf(elements.size());
+    std::copy(elements.begin(), elements.end(), buf.get_write());
+    try {
+        return hll::HyperLogLog::from_bytes(std::move(buf));
+    } catch (const std::invalid_argument& e) {
+        sstlog.debug("Ignoring cardinality metadata of {}: {}", get_filename(), e.what());
+        return { };
+    }
+}
+
 std::unordered_set<uint64_t> sstable::ancestors() const {
     const compaction_metadata& cm = get_compaction_metadata();
     return boost::copy_range<std::unordered_set<uint64_t>>(cm.ancestors.elements);
@@ -2781,6 +2871,31 @@ void sstable::set_sstable_level(uint32_t new_level) {
     s.sstable_level = new_level;
 }
 
+future<shared_sstable> sstable::link_as_compaction_output(sstring dir, int64_t generation, uint32_t level,
+        std::vector<unsigned long> ancestors) const {
+    return create_links(dir, generation).then([this, dir, generation] {
+        auto sst = make_sstable(_schema, dir, generation, _version, _format);
+        return sst->load().then([sst] {
+            return sst;
+        });
+    }).then([level, ancestors = std::move(ancestors)] (shared_sstable sst) {
+        return seastar::async([sst, level, ancestors = std::move(ancestors)] {
+            sst->set_sstable_level(level);
+            auto entry = sst->_components->statistics.contents.find(metadata_type::Compaction);
+            if (entry != sst->_components->statistics.contents.end() && entry->second) {
+                auto& cm = *static_cast<compaction_metadata*>(entry->second.get());
+                cm.ancestors.elements.clear();
+                for (auto ancestor : ancestors) {
+                    cm.ancestors.elements.push_back(ancestor);
+                }
+            }
+            // Statistics is replaced by rename, so the linked one of the original is kept intact.
+            sst->rewrite_statistics(default_priority_class());
+            return sst;
+        });
+    });
+}
+
 future<> sstable::mutate_sstable_level(uint32_t new_level) {
     if (!has_component(component_type::Statistics)) {
         return make_ready_future<>();
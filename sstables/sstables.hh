@@ -256,7 +256,37 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // load all components from disk
     // this variant will be useful for testing purposes and also when loading
     // a new sstable from scratch for sharing its components.
-    future<> load(const io_priority_class& pc = default_priority_class());
+    // If defer_filter is set, the filter of a sstable owned by a single shard isn't
+    // read, it's replaced by one which always reports keys as present until
+    // load_deferred_filter() is called.
+    future<> load(const io_priority_class& pc = default_priority_class(), bool defer_filter = false);
+    // Reads the filter whose loading was deferred by load(), if any. Must be called
+    // on the shard which owns the sstable.
+    future<> load_deferred_filter(const io_priority_class& pc);
+    bool has_deferred_filter() const {
+        return _components->filter_deferred;
+    }
+
+    // Returns the number of index readers created since the last call, which is
+    // how often the summary was used.
+    uint64_t take_index_reads() {
+        return std::exchange(_index_reads, 0);
+    }
+    int summary_sampling_level() const {
+        return _components->summary.header.sampling_level;
+    }
+    // The summary is shared with other shards, or in use by index readers.
+    bool can_resample_summary() const {
+        return !is_shared() && !_active_index_readers;
+    }
+    // Drops entries of the summary in memory, so that it's left at the given
+    // sampling level, lower than the current one. The remaining entries are
+    // spread evenly, see downsampling::get_start_points().
+    // Requires can_resample_summary().
+    void downsample_summary(int sampling_level);
+    // Reads the summary at full sampling from disk and replaces the current one with it,
+    // unless it can't be resampled by then. Resolves to whether it was replaced.
+    future<bool> restore_summary(const io_priority_class& pc);
     future<> open_data();
     future<> update_info_for_opened_data();
 
@@ -435,6 +465,12 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return create_links(dir, _generation);
     }
 
+    // Makes a copy of this sstable with the given generation by linking its components,
+    // and replaces the level and ancestors of the copy, so that it can be the output of
+    // a compaction without rewriting any data. The returned sstable is loaded.
+    future<shared_sstable> link_as_compaction_output(sstring dir, int64_t generation, uint32_t level,
+            std::vector<unsigned long> ancestors) const;
+
     /**
      * Note. This is using the Origin definition of
      * max_data_age, which is load time. This could maybe
@@ -457,6 +493,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         sstables::summary summary;
         sstables::statistics statistics;
         stdx::optional<sstables::scylla_metadata> scylla_metadata;
+        // Set while filter is a placeholder for a filter which wasn't read yet,
+        // see load(const io_priority_class&, bool).
+        bool filter_deferred = false;
     };
 private:
     size_t sstable_buffer_size = default_buffer_size;
@@ -483,6 +522,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     db_clock::time_point _data_file_write_time;
     std::vector<nonwrapping_range<bytes_view>> _clustering_components_ranges;
     std::vector<unsigned> _shards;
+    // Index readers use positions in the summary, so it can't be resampled while any is alive.
+    unsigned _active_index_readers = 0;
+    uint64_t _index_reads = 0;
     stdx::optional<dht::decorated_key> _first;
     stdx::optional<dht::decorated_key> _last;
 
@@ -556,6 +598,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     void write_scylla_metadata(const io_priority_class& pc, shard_id shard, sstable_enabled_features features);
 
     future<> read_filter(const io_priority_class& pc);
+    // Installs the placeholder filter in place of the one on disk.
+    future<> defer_read_filter();
 
     void write_filter(const io_priority_class& pc);
 
@@ -725,6 +769,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         const compaction_metadata& s = *static_cast<compaction_metadata *>(p.get());
         return s;
     }
+    // Returns the estimator of the cardinality of partition keys held by this sstable,
+    // if its compaction metadata carries one in a format we can read. It is parsed
+    // on every call, so that it takes memory only while a compaction is planned.
+    stdx::optional<hll::HyperLogLog> get_cardinality_estimator() const;
     const std::vector<unsigned>& get_shards_for_this_sstable() const {
         return _shards;
     }
@@ -764,7 +812,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
 
     // returns all info needed for a sstable to be shared with other shards.
     static future<sstable_open_info> load_shared_components(const schema_ptr& s, sstring dir, int generation, version_types v, format_types f,
-        const io_priority_class& pc = default_priority_class());
+        const io_priority_class& pc = default_priority_class(), bool defer_filter = false);
 
     // Allow the test cases from sstable_test.cc to test private methods. We use
     // a placeholder to avoid cluttering this class too much. The sstable_test class
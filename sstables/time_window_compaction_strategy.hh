@@ -151,7 +151,25 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         if (!expired.empty()) {
             compaction_candidates.insert(compaction_candidates.end(), expired.begin(), expired.end());
         }
-        return compaction_descriptor(std::move(compaction_candidates));
+        auto descriptor = compaction_descriptor(std::move(compaction_candidates));
+        // A window is done with once it's down to a single run.
+        descriptor.link_into_unsplit_output = true;
+        return descriptor;
+    }
+
+    // Streamed sstables of the same time window are merged together, so that each
+    // window ends up with a single sstable, as it would have after regular compaction.
+    virtual std::vector<compaction_descriptor> get_reshaping_jobs(column_family& cf, std::vector<shared_sstable> input) override {
+        std::vector<compaction_descriptor> jobs;
+        auto buckets = get_buckets(std::move(input), _options.sstable_window_size).first;
+        for (auto& bucket : buckets | boost::adaptors::map_values) {
+            if (bucket.size() < 2) {
+                continue;
+            }
+            auto bucket_jobs = make_reshaping_jobs(std::move(bucket), cf.schema()->max_compaction_threshold());
+            std::move(bucket_jobs.begin(), bucket_jobs.end(), std::back_inserter(jobs));
+        }
+        return jobs;
     }
 private:
     std::vector<shared_sstable>
@@ -242,7 +260,7 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
                 if (!stcs_interesting_bucket.empty()) {
                     return stcs_interesting_bucket;
                 }
-            } else if (bucket.size() >= 2 && key < now) {
+            } else if (count_runs(bucket) >= 2 && key < now) {
                 clogger.debug("bucket size {} >= 2 and not in current bucket, compacting what's here", bucket.size());
                 return trim_to_threshold(std::move(bucket), max_threshold);
             } else {
@@ -252,6 +270,12 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
         return {};
     }
 
+    // A past window is done with once it's down to a single run, whose sstables hold
+    // disjoint partitions, as when compaction links some of its input into the output.
+    static size_t count_runs(const std::vector<shared_sstable>& bucket) {
+        return size_tiered_compaction_strategy::group_into_runs(bucket).size();
+    }
+
     static std::vector<shared_sstable>
     trim_to_threshold(std::vector<shared_sstable> bucket, int max_threshold) {
         auto n = std::min(bucket.size(), size_t(max_threshold));
@@ -274,7 +298,7 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
             auto count = task.second.size();
             if (key >= now && count >= size_t(min_threshold)) {
                 n++;
-            } else if (key < now && count >= 2) {
+            } else if (key < now && count_runs(task.second) >= 2) {
                 n++;
             }
         }
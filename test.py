@@ -100,6 +100,8 @@ boost_tests = [
     'enum_set_test',
     'extensions_test',
     'cql_auth_syntax_test',
+    'frequency_sketch_test',
+    'service_level_test',
 ]
 
 other_tests = [
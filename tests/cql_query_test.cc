@@ -2076,6 +2076,50 @@ SEASTAR_TEST_CASE(test_in_restriction) {
     });
 }
 
+SEASTAR_TEST_CASE(test_in_restriction_with_limit) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table tirl (p1 int, c1 int, r1 int, PRIMARY KEY (p1, c1));").get();
+        for (int p = 0; p < 8; ++p) {
+            for (int c = 0; c < 3; ++c) {
+                e.execute_cql(sprint("insert into tirl (p1, c1, r1) values (%d, %d, %d);", p, c, p * 10 + c)).get();
+            }
+        }
+        // The partitions are read from the replica together, in ring order,
+        // but the limit must still apply in the order of the IN list.
+        auto select = [&e] (int limit) {
+            return e.execute_cql(sprint("select r1 from tirl where p1 in (7, 3, 5, 0, 6) and c1 < 2 limit %d;", limit)).get0();
+        };
+        assert_that(select(1)).is_rows().with_rows({
+            {int32_type->decompose(70)},
+        });
+        assert_that(select(3)).is_rows().with_rows({
+            {int32_type->decompose(70)},
+            {int32_type->decompose(71)},
+            {int32_type->decompose(30)},
+        });
+        assert_that(select(6)).is_rows().with_rows({
+            {int32_type->decompose(70)},
+            {int32_type->decompose(71)},
+            {int32_type->decompose(30)},
+            {int32_type->decompose(31)},
+            {int32_type->decompose(50)},
+            {int32_type->decompose(51)},
+        });
+        assert_that(select(20)).is_rows().with_rows({
+            {int32_type->decompose(70)},
+            {int32_type->decompose(71)},
+            {int32_type->decompose(30)},
+            {int32_type->decompose(31)},
+            {int32_type->decompose(50)},
+            {int32_type->decompose(51)},
+            {int32_type->decompose(0)},
+            {int32_type->decompose(1)},
+            {int32_type->decompose(60)},
+            {int32_type->decompose(61)},
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_compact_storage) {
     return do_with_cql_env([] (cql_test_env& e) {
         return e.execute_cql("create table tcs (p1 int, c1 int, r1 int, PRIMARY KEY (p1, c1)) with compact storage;").discard_result().then([&e] {
@@ -2607,3 +2651,239 @@ SEASTAR_TEST_CASE(test_insert_large_collection_values) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_select_bypass_cache) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck));").get();
+        e.execute_cql("INSERT INTO t (pk, ck, v) VALUES (1, 1, 1);").get();
+        e.execute_cql("INSERT INTO t (pk, ck, v) VALUES (1, 2, 2);").get();
+
+        auto& db = e.local_db();
+        auto& cf = db.find_column_family("ks", "t");
+        db.flush_all_memtables().get();
+        cf.get_row_cache().evict();
+        BOOST_REQUIRE_EQUAL(cf.get_row_cache().partitions(), 0);
+
+        auto bypassed_before = cf.cf_stats()->reads_bypassing_cache;
+        auto check = [] (shared_ptr<cql_transport::messages::result_message> msg) {
+            assert_that(msg).is_rows().with_rows({
+                { int32_type->decompose(1), int32_type->decompose(1), int32_type->decompose(1) },
+                { int32_type->decompose(1), int32_type->decompose(2), int32_type->decompose(2) },
+            });
+        };
+
+        check(e.execute_cql("SELECT * FROM t WHERE pk = 1 BYPASS CACHE;").get0());
+        check(e.execute_cql("SELECT * FROM t BYPASS CACHE;").get0());
+        assert_that(e.execute_cql("SELECT * FROM t WHERE ck = 2 ALLOW FILTERING BYPASS CACHE;").get0()).is_rows().with_rows({
+            { int32_type->decompose(1), int32_type->decompose(2), int32_type->decompose(2) },
+        });
+        BOOST_REQUIRE_EQUAL(cf.get_row_cache().partitions(), 0);
+        BOOST_REQUIRE_GT(cf.cf_stats()->reads_bypassing_cache, bypassed_before);
+
+        check(e.execute_cql("SELECT * FROM t WHERE pk = 1;").get0());
+        BOOST_REQUIRE_EQUAL(cf.get_row_cache().partitions(), 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_select_single_row_newest_first) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, v int, w int, PRIMARY KEY (pk, ck));").get();
+        auto& db = e.local_db();
+        auto& cf = db.find_column_family("ks", "t");
+        auto write_and_flush = [&] (sstring cql) {
+            e.execute_cql(cql).get();
+            db.flush_all_memtables().get();
+        };
+        auto require_rows = [&] (sstring cql, std::vector<std::vector<bytes_opt>> rows) {
+            assert_that(e.execute_cql(cql).get0()).is_rows().with_rows(std::move(rows));
+        };
+
+        write_and_flush("INSERT INTO t (pk, ck, v, w) VALUES (1, 1, 1, 1);");
+        write_and_flush("UPDATE t SET v = 2, w = 2 WHERE pk = 1 AND ck = 1;");
+        write_and_flush("UPDATE t SET v = 3 WHERE pk = 1 AND ck = 1;");
+
+        // Only the newest sstable needs to be read
+        require_rows("SELECT v FROM t WHERE pk = 1 AND ck = 1 BYPASS CACHE;", {{ int32_type->decompose(3) }});
+        BOOST_REQUIRE_EQUAL(cf.get_stats().estimated_sstable_per_read.max(), 1);
+
+        require_rows("SELECT v, w FROM t WHERE pk = 1 AND ck = 1 BYPASS CACHE;",
+                {{ int32_type->decompose(3), int32_type->decompose(2) }});
+        BOOST_REQUIRE_EQUAL(cf.get_stats().estimated_sstable_per_read.max(), 2);
+
+        write_and_flush("DELETE w FROM t WHERE pk = 1 AND ck = 1;");
+        require_rows("SELECT v, w FROM t WHERE pk = 1 AND ck = 1 BYPASS CACHE;",
+                {{ int32_type->decompose(3), { } }});
+
+        write_and_flush("DELETE FROM t WHERE pk = 1 AND ck = 1;");
+        write_and_flush("UPDATE t SET v = 5 WHERE pk = 1 AND ck = 1;");
+        require_rows("SELECT v FROM t WHERE pk = 1 AND ck = 1 BYPASS CACHE;", {{ int32_type->decompose(5) }});
+        require_rows("SELECT v, w FROM t WHERE pk = 1 AND ck = 1 BYPASS CACHE;", {{ int32_type->decompose(5), { } }});
+
+        // Results match the ones read through the cache
+        require_rows("SELECT v, w FROM t WHERE pk = 1 AND ck = 1;", {{ int32_type->decompose(5), { } }});
+    });
+}
+
+SEASTAR_TEST_CASE(test_unprepared_statement_cache) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int PRIMARY KEY, v int);").get();
+        e.execute_cql("INSERT INTO t (pk, v) VALUES (1, 1);").get();
+
+        for (int i = 0; i < 2; ++i) {
+            assert_that(e.execute_cql("SELECT * FROM t WHERE pk = 1;").get0()).is_rows().with_rows({
+                { int32_type->decompose(1), int32_type->decompose(1) },
+            });
+        }
+
+        // Cached statements are invalidated by schema changes
+        e.execute_cql("ALTER TABLE t ADD w int;").get();
+        assert_that(e.execute_cql("SELECT * FROM t WHERE pk = 1;").get0()).is_rows().with_rows({
+            { int32_type->decompose(1), int32_type->decompose(1), { } },
+        });
+
+        e.execute_cql("DROP TABLE t;").get();
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT * FROM t WHERE pk = 1;").get(), exceptions::invalid_request_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(test_count_rows_with_paging) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, s int static, v int, PRIMARY KEY (pk, ck));").get();
+        for (int ck = 0; ck < 25; ++ck) {
+            e.execute_cql(sprint("INSERT INTO t (pk, ck, v) VALUES (1, %d, %d);", ck, ck)).get();
+        }
+        e.execute_cql("DELETE FROM t WHERE pk = 1 AND ck = 3;").get();
+        e.execute_cql("INSERT INTO t (pk, s) VALUES (2, 2);").get();
+
+        auto count = [&e] (sstring query) {
+            auto qo = std::make_unique<cql3::query_options>(db::consistency_level::ONE, std::experimental::nullopt,
+                    std::vector<cql3::raw_value_view>(), false,
+                    cql3::query_options::specific_options{10, nullptr, {}, api::missing_timestamp},
+                    cql_serialization_format::latest());
+            return e.execute_cql(query, std::move(qo)).get0();
+        };
+
+        // Partitions are counted on the replicas, a page of 10 rows at a time
+        assert_that(count("SELECT count(*) FROM t WHERE pk = 1;")).is_rows().with_rows({{ long_type->decompose(int64_t(24)) }});
+        assert_that(count("SELECT count(*) FROM t WHERE pk = 1 AND ck > 5;")).is_rows().with_rows({{ long_type->decompose(int64_t(19)) }});
+        assert_that(count("SELECT count(*) FROM t WHERE pk = 1 LIMIT 7;")).is_rows().with_rows({{ long_type->decompose(int64_t(7)) }});
+        assert_that(count("SELECT count(1) FROM t WHERE pk = 2;")).is_rows().with_rows({{ long_type->decompose(int64_t(1)) }});
+        assert_that(count("SELECT count(*) FROM t WHERE pk = 2 AND ck > 0;")).is_rows().with_rows({{ long_type->decompose(int64_t(0)) }});
+        assert_that(count("SELECT count(*) FROM t WHERE pk = 3;")).is_rows().with_rows({{ long_type->decompose(int64_t(0)) }});
+
+        // Other aggregates and multi-partition counts see the rows themselves
+        assert_that(count("SELECT count(*) FROM t WHERE pk IN (1, 2);")).is_rows().with_rows({{ long_type->decompose(int64_t(25)) }});
+        assert_that(count("SELECT count(v) FROM t WHERE pk = 1;")).is_rows().with_rows({{ long_type->decompose(int64_t(24)) }});
+    });
+}
+
+SEASTAR_TEST_CASE(test_filtering_on_regular_columns) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, s int static, i int, b bigint, d double, ts timestamp, txt text, "
+                "PRIMARY KEY (pk, ck));").get();
+        for (int ck = 0; ck < 10; ++ck) {
+            e.execute_cql(sprint("INSERT INTO t (pk, ck, i, b, d, ts, txt) VALUES (1, %d, %d, %d, %d.5, %d, '%c');",
+                    ck, ck % 3, ck * 1000, ck - 5, ck * 100, 'a' + ck)).get();
+        }
+        e.execute_cql("INSERT INTO t (pk, ck) VALUES (1, 10);").get();
+        e.execute_cql("INSERT INTO t (pk, s) VALUES (2, 2);").get();
+
+        auto ck = [] (int v) {
+            return std::vector<bytes_opt>{ int32_type->decompose(v) };
+        };
+
+        auto msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND i = 1 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(1), ck(4), ck(7) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND b >= 3000 AND b < 6000 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(3), ck(4), ck(5) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND d < -2.0 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(0), ck(1), ck(2), ck(3) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND ts > 700 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(8), ck(9) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND txt <= 'b' ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(0), ck(1) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND i = 2 AND b > 2000 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(5), ck(8) });
+
+        // The limit counts matching rows only
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 1 AND i = 0 LIMIT 2 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(0), ck(3) });
+        msg = e.execute_cql("SELECT count(*) FROM t WHERE pk = 1 AND i = 0 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({{ long_type->decompose(int64_t(4)) }});
+
+        // Partitions without a matching row are not returned, even with a live static row
+        msg = e.execute_cql("SELECT * FROM t WHERE pk = 2 AND i = 0 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().is_empty();
+
+        // Doubles compare like the double type does: -0 is equal to 0, and NaN is
+        // greater than everything, itself included
+        e.execute_cql("INSERT INTO t (pk, ck, d) VALUES (3, 0, -0.0);").get();
+        e.execute_cql("INSERT INTO t (pk, ck, d) VALUES (3, 1, 0.0);").get();
+        e.execute_cql("INSERT INTO t (pk, ck, d) VALUES (3, 2, NaN);").get();
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 3 AND d = 0.0 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(0), ck(1) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 3 AND d > 0.0 ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().with_rows({ ck(2) });
+        msg = e.execute_cql("SELECT ck FROM t WHERE pk = 3 AND d = NaN ALLOW FILTERING;").get0();
+        assert_that(msg).is_rows().is_empty();
+    });
+}
+
+SEASTAR_TEST_CASE(test_generated_results_match_materialized_ones) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, s int static, v int, PRIMARY KEY (pk, ck));").get();
+        for (int pk = 0; pk < 4; ++pk) {
+            for (int ck = 0; ck < 5; ++ck) {
+                e.execute_cql(sprint("INSERT INTO t (pk, ck, s, v) VALUES (%d, %d, %d, %d);", pk, ck, pk, pk * 10 + ck)).get();
+            }
+        }
+        e.execute_cql("INSERT INTO t (pk, ck) VALUES (1, 7);").get();
+        e.execute_cql("INSERT INTO t (pk, s) VALUES (5, 5);").get();
+
+        struct collector {
+            std::vector<std::vector<bytes_opt>>& rows;
+            void start_row() {
+                rows.emplace_back();
+            }
+            void accept_value(bytes_view_opt value) {
+                rows.back().emplace_back(value ? bytes_opt(to_bytes(*value)) : bytes_opt());
+            }
+            void end_row() { }
+        };
+
+        // Collects the rows as they are serialized to the client.
+        auto fetch = [&e] (sstring query, int32_t page_size) {
+            std::vector<std::vector<bytes_opt>> rows;
+            ::shared_ptr<service::pager::paging_state> paging_state;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::ONE, std::experimental::nullopt,
+                        std::vector<cql3::raw_value_view>(), false,
+                        cql3::query_options::specific_options{page_size, paging_state, {}, api::missing_timestamp},
+                        cql_serialization_format::latest());
+                auto msg = e.execute_cql(query, std::move(qo)).get0();
+                auto rows_msg = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+                BOOST_REQUIRE(rows_msg);
+                rows_msg->result().visit(collector{rows});
+                auto state = rows_msg->result().get_metadata().paging_state();
+                paging_state = state ? ::make_shared<service::pager::paging_state>(*state) : nullptr;
+            } while (paging_state);
+            return rows;
+        };
+
+        // The function makes the selection non-trivial, so its rows are materialized.
+        auto generated = "SELECT pk, ck, s, v FROM t";
+        auto materialized = "SELECT pk, ck, s, blobAsInt(intAsBlob(v)) FROM t";
+        auto expected = fetch(materialized, -1);
+        BOOST_REQUIRE_EQUAL(expected.size(), 22u);
+        BOOST_REQUIRE(fetch(generated, -1) == expected);
+        for (auto page_size : {1, 3, 7, 100}) {
+            BOOST_REQUIRE(fetch(generated, page_size) == expected);
+            BOOST_REQUIRE(fetch(materialized, page_size) == expected);
+            BOOST_REQUIRE(fetch(sprint("%s WHERE pk = 1", generated), page_size) == fetch(sprint("%s WHERE pk = 1", materialized), page_size));
+        }
+
+        // Aggregates see the same rows as the ones generated
+        auto aggregates = fetch("SELECT count(*), max(v) FROM t", 3);
+        BOOST_REQUIRE(aggregates == (std::vector<std::vector<bytes_opt>>{{ long_type->decompose(int64_t(22)), int32_type->decompose(34) }}));
+    });
+}
@@ -27,8 +27,11 @@
 #include "tests/result_set_assertions.hh"
 
 #include "database.hh"
+#include "memtable.hh"
 #include "partition_slice_builder.hh"
 #include "frozen_mutation.hh"
+#include "schema_builder.hh"
+#include "db/config.hh"
 
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env([](cql_test_env& e) {
@@ -74,3 +77,184 @@ SEASTAR_TEST_CASE(test_querying_with_limits) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_coalescing_identical_reads) {
+    return do_with_cql_env([](cql_test_env& e) {
+        return seastar::async([&] {
+            e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+            auto& db = e.local_db();
+            auto s = db.find_schema("ks", "cf");
+            auto pkey = partition_key::from_single_value(*s, to_bytes("key1"));
+            auto write = [&] (int v, api::timestamp_type ts) {
+                mutation m(s, pkey);
+                m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", data_value(v), ts);
+                db.apply(s, freeze(m)).get();
+            };
+            write(1, 1);
+
+            dht::partition_range_vector pranges{dht::partition_range::make_singular(dht::global_partitioner().decorate_key(*s, pkey))};
+            auto max_size = std::numeric_limits<size_t>::max();
+            auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(), query::max_rows);
+
+            // Concurrent identical reads share a result
+            auto f1 = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size);
+            auto f2 = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size);
+            auto r1 = f1.get0();
+            auto r2 = f2.get0();
+            BOOST_REQUIRE(r1.get() == r2.get());
+            assert_that(query::result_set::from_raw_result(s, cmd.slice, *r1))
+                .has_only(a_row().with_column("v", data_value(1)));
+
+            // Reads with different result options don't
+            auto digest = db.query(s, cmd, query::result_options::only_digest(query::digest_algorithm::xxHash), pranges, nullptr, max_size).get0();
+            BOOST_REQUIRE(digest.get() != r1.get());
+
+            // Reads after a write see it
+            write(2, 2);
+            auto r3 = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size).get0();
+            BOOST_REQUIRE(r3.get() != r1.get());
+            assert_that(query::result_set::from_raw_result(s, cmd.slice, *r3))
+                .has_only(a_row().with_column("v", data_value(2)));
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_coalesced_reads_see_streamed_data) {
+    db::config cfg;
+    // Long enough for the result of a read to be shared with all later ones.
+    cfg.read_coalescing_window_in_ms(3600 * 1000);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        auto pkey = partition_key::from_single_value(*s, to_bytes("key1"));
+        auto make_write = [&] (int v, api::timestamp_type ts) {
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", data_value(v), ts);
+            return freeze(m);
+        };
+        db.apply(s, make_write(1, 1)).get();
+
+        dht::partition_range_vector pranges{dht::partition_range::make_singular(dht::global_partitioner().decorate_key(*s, pkey))};
+        auto max_size = std::numeric_limits<size_t>::max();
+        auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(), query::max_rows);
+        auto r1 = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size).get0();
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *r1))
+            .has_only(a_row().with_column("v", data_value(1)));
+
+        auto plan_id = utils::make_random_uuid();
+        db.apply_streaming_mutation(s, plan_id, make_write(2, 2), false).get();
+        db.find_column_family(s).flush_streaming_mutations(plan_id, pranges).get();
+
+        auto r2 = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size).get0();
+        BOOST_REQUIRE(r2.get() != r1.get());
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *r2))
+            .has_only(a_row().with_column("v", data_value(2)));
+    }, cfg);
+}
+
+SEASTAR_TEST_CASE(test_digest_of_reads_bypassing_cache) {
+    return do_with_cql_env([](cql_test_env& e) {
+        return seastar::async([&] {
+            e.execute_cql("create table ks.cf (pk int, ck int, v int, primary key (pk, ck));").get();
+            auto& db = e.local_db();
+            auto s = db.find_schema("ks", "cf");
+            auto write_and_flush = [&] (sstring cql) {
+                e.execute_cql(cql).get();
+                db.flush_all_memtables().get();
+            };
+            write_and_flush("insert into ks.cf (pk, ck, v) values (1, 1, 1);");
+            write_and_flush("delete from ks.cf where pk = 1 and ck = 1;");
+            write_and_flush("update ks.cf set v = 3 where pk = 1 and ck = 1;");
+
+            auto pkey = partition_key::from_single_value(*s, int32_type->decompose(1));
+            auto ckey = clustering_key::from_single_value(*s, int32_type->decompose(1));
+            dht::partition_range_vector pranges{dht::partition_range::make_singular(dht::global_partitioner().decorate_key(*s, pkey))};
+            auto max_size = std::numeric_limits<size_t>::max();
+            auto slice = partition_slice_builder(*s)
+                    .with_range(query::clustering_range::make_singular(ckey))
+                    .with_regular_column("v")
+                    .build();
+            auto cmd = query::read_command(s->id(), s->version(), slice, query::max_rows);
+            auto bypassing_cmd = cmd;
+            bypassing_cmd.slice.options.set<query::partition_slice::option::bypass_cache>();
+
+            // The newest sstable shadows the older ones, but the digest covers the row
+            // tombstone held by one of them.
+            auto opts = query::result_options::only_digest(query::digest_algorithm::xxHash);
+            auto digest = db.query(s, cmd, opts, pranges, nullptr, max_size).get0()->digest();
+            auto bypassing_digest = db.query(s, bypassing_cmd, opts, pranges, nullptr, max_size).get0()->digest();
+            BOOST_REQUIRE(digest && bypassing_digest);
+            BOOST_REQUIRE(*digest == *bypassing_digest);
+
+            auto result = db.query(s, bypassing_cmd, query::result_options::only_result(), pranges, nullptr, max_size).get0();
+            assert_that(query::result_set::from_raw_result(s, bypassing_cmd.slice, *result))
+                .has_only(a_row().with_column("v", data_value(3)));
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_concurrent_flushes_pick_distinct_memtables) {
+    return do_with_cql_env([](cql_test_env& e) {
+        return seastar::async([&] {
+            auto s = schema_builder("ks", "cf")
+                    .with_column("pk", int32_type, column_kind::partition_key)
+                    .with_column("v", bytes_type)
+                    .build();
+
+            // Soft limit of 1MB. Allows more concurrent flushes than there are memtables to flush.
+            dirty_memory_manager mgr(e.local_db(), 4 << 20, 0.5, 4);
+
+            std::vector<std::unique_ptr<memtable_list>> lists;
+            std::vector<promise<>> flushes(3);
+            std::vector<size_t> sealed;
+            unsigned empty_seals = 0;
+            for (size_t i = 0; i < 3; ++i) {
+                // Flushes last until released by the test.
+                auto seal = [&, i] (flush_permit&& permit) {
+                    auto old = lists[i]->back();
+                    sealed.push_back(i);
+                    empty_seals += old->empty();
+                    lists[i]->add_memtable();
+                    return flushes[i].get_future().then([&, i, old, permit = std::move(permit)] {
+                        lists[i]->erase(old);
+                    });
+                };
+                lists.push_back(std::make_unique<memtable_list>(seal, [s] { return s; }, &mgr));
+            }
+
+            int key = 0;
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t n = 0; n < 300 + 100 * i; ++n) {
+                    mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(key++)));
+                    m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", data_value(bytes(1024, int8_t(0))), api::new_timestamp());
+                    lists[i]->active_memtable().apply(m);
+                }
+            }
+
+            for (int i = 0; i < 1000 && sealed.size() < 3; ++i) {
+                later().get();
+            }
+            // The largest memtable first, never the one which is already being flushed.
+            BOOST_REQUIRE(sealed == (std::vector<size_t>{2, 1, 0}));
+            BOOST_REQUIRE_EQUAL(mgr.concurrent_flushes(), 3u);
+
+            // With only empty active memtables left, the spare permit waits for a flush to finish.
+            for (int i = 0; i < 100; ++i) {
+                later().get();
+            }
+            BOOST_REQUIRE_EQUAL(sealed.size(), 3u);
+            BOOST_REQUIRE_EQUAL(empty_seals, 0u);
+
+            for (auto& f : flushes) {
+                f.set_value();
+            }
+            for (int i = 0; i < 1000 && mgr.concurrent_flushes(); ++i) {
+                later().get();
+            }
+            BOOST_REQUIRE_EQUAL(sealed.size(), 3u);
+            BOOST_REQUIRE_EQUAL(empty_seals, 0u);
+            mgr.shutdown().get();
+        });
+    });
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/frequency_sketch.hh"
+
+BOOST_AUTO_TEST_CASE(test_unseen_keys_have_zero_frequency) {
+    utils::frequency_sketch sketch(1024);
+    for (uint64_t k = 0; k < 100; ++k) {
+        BOOST_REQUIRE_EQUAL(sketch.estimate(k), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_estimate_does_not_underestimate) {
+    utils::frequency_sketch sketch(1024);
+    for (uint64_t k = 1; k <= 10; ++k) {
+        for (uint64_t i = 0; i < k; ++i) {
+            sketch.record(k);
+        }
+    }
+    for (uint64_t k = 1; k <= 10; ++k) {
+        BOOST_REQUIRE_GE(sketch.estimate(k), k);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_estimate_saturates) {
+    utils::frequency_sketch sketch(1024);
+    for (int i = 0; i < 100; ++i) {
+        sketch.record(7);
+    }
+    BOOST_REQUIRE_EQUAL(sketch.estimate(7), utils::frequency_sketch::max_frequency);
+}
+
+BOOST_AUTO_TEST_CASE(test_sketch_ages) {
+    utils::frequency_sketch sketch(1024);
+    for (int i = 0; i < 8; ++i) {
+        sketch.record(7);
+    }
+    auto before = sketch.estimate(7);
+    uint64_t k = 1000;
+    while (sketch.resets() == 0) {
+        sketch.record(k++);
+    }
+    BOOST_REQUIRE_LT(sketch.estimate(7), before);
+}
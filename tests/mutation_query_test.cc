@@ -525,3 +525,53 @@ SEASTAR_TEST_CASE(test_partition_limit) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_filtered_result_remembers_last_examined_row) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = make_schema();
+        auto now = gc_clock::now();
+
+        mutation m1(s, partition_key::from_single_value(*s, "key1"));
+        for (auto&& ck : {"A", "B", "C"}) {
+            m1.set_clustered_cell(clustering_key::from_single_value(*s, bytes(ck)), "v1", data_value(bytes("x")), 1);
+        }
+
+        auto full_slice = make_full_slice(*s);
+        auto rr = mutation_query(s, make_source({m1}), query::full_partition_range, full_slice, query::max_rows,
+                query::max_partitions, now).get0();
+
+        auto make_filtered_slice = [&] (bytes value, query::partition_slice::option_set options) {
+            return query::partition_slice(full_slice.default_row_ranges(), full_slice.static_columns, full_slice.regular_columns,
+                    options, nullptr, cql_serialization_format::internal(), query::max_rows,
+                    { query::column_filter{s->get_column_definition("v1")->id, query::filter_operator::eq, std::move(value)} });
+        };
+
+        {
+            auto slice = make_filtered_slice(bytes("y"), full_slice.options);
+            auto r = to_filtered_data_query_result(rr, s, slice, inf32, inf32, 1);
+            BOOST_REQUIRE_EQUAL(r.row_count().value(), 0);
+            BOOST_REQUIRE(r.last_examined());
+            BOOST_REQUIRE(r.last_examined()->partition.equal(*s, partition_key::from_single_value(*s, "key1")));
+            BOOST_REQUIRE(r.last_examined()->row.equal(*s, clustering_key::from_single_value(*s, bytes("A"))));
+        }
+
+        {
+            auto options = full_slice.options;
+            options.set<query::partition_slice::option::reversed>();
+            auto slice = make_filtered_slice(bytes("y"), options);
+            auto r = to_filtered_data_query_result(rr, s, slice, inf32, inf32, 1);
+            BOOST_REQUIRE_EQUAL(r.row_count().value(), 0);
+            BOOST_REQUIRE(r.last_examined());
+            BOOST_REQUIRE(r.last_examined()->row.equal(*s, clustering_key::from_single_value(*s, bytes("C"))));
+        }
+
+        {
+            // Pages with rows resume after their last row.
+            auto slice = make_filtered_slice(bytes("x"), full_slice.options);
+            auto r = to_filtered_data_query_result(rr, s, slice, inf32, inf32, 2);
+            BOOST_REQUIRE_EQUAL(r.row_count().value(), 2);
+            BOOST_REQUIRE(!r.last_examined());
+        }
+    });
+}
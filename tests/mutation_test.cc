@@ -1033,6 +1033,49 @@ SEASTAR_TEST_CASE(test_query_digest) {
     });
 }
 
+SEASTAR_TEST_CASE(test_query_digest_with_row_hashes) {
+    return seastar::async([] {
+        auto digest_of = [] (const mutation& m) {
+            auto ps = partition_slice_builder(*m.schema()).build();
+            return *m.query(ps, query::result_options::only_digest(query::digest_algorithm::xxHash_row_hashes)).digest();
+        };
+        auto with_row_hashes = [] (const mutation& m) {
+            auto result = m;
+            const schema& s = *result.schema();
+            result.partition().static_row().prepare_hash(s, column_kind::static_column);
+            for (auto&& e : result.partition().clustered_rows()) {
+                e.row().cells().prepare_hash(s, column_kind::regular_column);
+            }
+            return result;
+        };
+
+        for_each_mutation_pair([&] (const mutation& m1, const mutation& m2, are_equal eq) {
+            if (m1.schema()->version() != m2.schema()->version()) {
+                return;
+            }
+
+            if (digest_of(m1) != digest_of(with_row_hashes(m1))) {
+                BOOST_FAIL(sprint("Digest should not depend on precomputed row hashes for %s", m1));
+            }
+
+            if (eq) {
+                if (digest_of(with_row_hashes(compacted(m1))) != digest_of(m2)) {
+                    BOOST_FAIL(sprint("Digest should be the same for %s and %s", m1, m2));
+                }
+            } else {
+                BOOST_TEST_MESSAGE("Row hashes should be invalidated by writes");
+                auto m3 = with_row_hashes(m1);
+                m3.apply(m2);
+                auto m4 = m1;
+                m4.apply(m2);
+                if (digest_of(m3) != digest_of(m4)) {
+                    BOOST_FAIL(sprint("Digest should be the same for %s and %s", m3, m4));
+                }
+            }
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_mutation_upgrade_of_equal_mutations) {
     return seastar::async([] {
         for_each_mutation_pair([](auto&& m1, auto&& m2, are_equal eq) {
@@ -59,6 +59,9 @@ int main(int argc, char** argv) {
     app.add_options()
         ("trace", "Enables trace-level logging for the test actions")
         ("no-reads", "Disable reads during the test")
+        ("scan-partitions", bpo::value<unsigned>()->default_value(0), "Number of cold partitions which are populated before the test"
+            " and scanned in a loop concurrently with point reads; 0 disables scans")
+        ("no-admission-filter", "Disable the cache admission filter")
         ("seconds", bpo::value<unsigned>()->default_value(60), "Duration [s] after which the test terminates with a success")
         ;
 
@@ -70,10 +73,12 @@ int main(int argc, char** argv) {
         db::config cfg;
         cfg.enable_commitlog(false);
         cfg.enable_cache(true);
+        cfg.enable_cache_admission_filter(!app.configuration().count("no-admission-filter"));
 
         return do_with_cql_env_thread([&app] (cql_test_env& env) {
             auto reads_enabled = !app.configuration().count("no-reads");
             auto seconds = app.configuration()["seconds"].as<unsigned>();
+            auto scan_partitions = app.configuration()["scan-partitions"].as<unsigned>();
 
             engine().at_exit([] {
                 cancelled = true;
@@ -93,8 +98,27 @@ int main(int argc, char** argv) {
             column_family& cf = db.find_column_family(s->id());
             cf.set_compaction_strategy(sstables::compaction_strategy_type::null);
 
+            sstring value = sstring(sstring::initialized_later(), 1024);
+
+            if (scan_partitions) {
+                test_log.info("Populating {} partitions for scans", scan_partitions);
+                auto&& col = *s->get_column_definition(to_bytes("v"));
+                for (auto i : boost::irange<unsigned>(0, scan_partitions)) {
+                    auto key = partition_key::from_single_value(*s, data_value(sprint("scan%d", i)).serialize());
+                    mutation m(s, dht::global_partitioner().decorate_key(*s, key));
+                    for (auto ck : boost::irange<int32_t>(0, 10)) {
+                        m.set_clustered_cell(clustering_key::from_single_value(*s, data_value(ck).serialize()), col,
+                            atomic_cell::make_live(api::new_timestamp(), data_value(value).serialize()));
+                    }
+                    db.apply(s, freeze(m)).get();
+                }
+                db.flush_all_memtables().get();
+                cf.get_row_cache().evict();
+            }
+
             uint64_t mutations = 0;
             uint64_t reads = 0;
+            uint64_t scans = 0;
             utils::estimated_histogram reads_hist;
             utils::estimated_histogram writes_hist;
 
@@ -104,14 +128,18 @@ int main(int argc, char** argv) {
             monotonic_counter<uint64_t> pmerges_ctr([&] { return global_cache_tracker().get_stats().partition_merges; });
             monotonic_counter<uint64_t> eviction_ctr([&] { return global_cache_tracker().get_stats().row_evictions; });
             monotonic_counter<uint64_t> miss_ctr([&] { return global_cache_tracker().get_stats().reads_with_misses; });
+            monotonic_counter<uint64_t> scans_ctr([&] { return scans; });
+            monotonic_counter<uint64_t> rejections_ctr([&] { return global_cache_tracker().get_stats().partition_admission_rejections; });
             stats_printer.set_callback([&] {
                 auto MB = 1024 * 1024;
-                std::cout << sprint("rd/s: %d, wr/s: %d, ev/s: %d, pmerge/s: %d, miss/s: %d, cache: %d/%d [MB], LSA: %d/%d [MB], std free: %d [MB]",
+                std::cout << sprint("rd/s: %d, wr/s: %d, scan/s: %d, ev/s: %d, pmerge/s: %d, miss/s: %d, rej/s: %d, cache: %d/%d [MB], LSA: %d/%d [MB], std free: %d [MB]",
                     reads_ctr.change(),
                     mutations_ctr.change(),
+                    scans_ctr.change(),
                     eviction_ctr.change(),
                     pmerges_ctr.change(),
                     miss_ctr.change(),
+                    rejections_ctr.change(),
                     global_cache_tracker().region().occupancy().used_space() / MB,
                     global_cache_tracker().region().occupancy().total_space() / MB,
                     logalloc::shard_tracker().region_occupancy().used_space() / MB,
@@ -143,7 +171,6 @@ int main(int argc, char** argv) {
             };
 
             auto pkey = make_pkey("key1");
-            sstring value = sstring(sstring::initialized_later(), 1024);
 
             using clock = std::chrono::steady_clock;
 
@@ -175,8 +202,21 @@ int main(int argc, char** argv) {
                 }
             });
 
+            // Scans the whole table, so that the cold partitions compete for cache
+            // with the hot partition read by the point reads.
+            auto scanner = seastar::async([&] {
+                if (!scan_partitions) {
+                    return;
+                }
+                while (!cancelled) {
+                    env.execute_cql("select pk, ck from ks.cf;").get();
+                    ++scans;
+                }
+            });
+
             mutator.get();
             reader.get();
+            scanner.get();
             stats_printer.cancel();
             completion_timer.cancel();
         }, cfg);
@@ -24,6 +24,7 @@
 
 #include "cql3/error_collector.hh"
 #include "cql3/CqlParser.hpp"
+#include "cql3/query_processor.hh"
 
 using namespace cql3;
 
@@ -43,4 +44,11 @@ int main(int argc, char* argv[]) {
         parser.set_error_listener(parser_error_collector);
         parser.query();
     });
+
+    // What a cached unprepared statement costs to find instead.
+    std::cout << "Timing cache key computation...\n";
+
+    time_it([&] {
+        query_processor::compute_id(query, "keyspace1");
+    });
 }
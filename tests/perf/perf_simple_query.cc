@@ -24,6 +24,7 @@
 #include "tests/perf/perf.hh"
 #include "core/app-template.hh"
 #include "schema_builder.hh"
+#include "db/config.hh"
 
 static const sstring table_name = "cf";
 
@@ -64,6 +65,7 @@ struct test_config {
     unsigned duration_in_seconds;
     bool counters;
     unsigned operations_per_shard = 0;
+    unsigned memtable_flush_writers;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -81,6 +83,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", mode=" << cfg.mode
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", memtable_flush_writers=" << cfg.memtable_flush_writers
            << "}";
 }
 
@@ -200,9 +203,14 @@ int main(int argc, char** argv) {
         ("query-single-key", "test reading with a single key instead of random keys")
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
-        ("counters", "test counters");
+        ("counters", "test counters")
+        ("memtable-flush-writers", bpo::value<unsigned>()->default_value(db::config().memtable_flush_writers()),
+                "number of memtables flushed concurrently per shard; use with --write and a large --partitions "
+                "to measure write throughput under sustained dirty memory pressure");
 
     return app.run(argc, argv, [&app] {
+        db::config db_cfg;
+        db_cfg.memtable_flush_writers(app.configuration()["memtable-flush-writers"].as<unsigned>());
         return do_with_cql_env([&app] (auto&& env) {
             auto cfg = make_lw_shared<test_config>();
             cfg->partitions = app.configuration()["partitions"].as<unsigned>();
@@ -220,7 +228,8 @@ int main(int argc, char** argv) {
             if (app.configuration().count("operations-per-shard")) {
                 cfg->operations_per_shard = app.configuration()["operations-per-shard"].as<unsigned>();
             }
+            cfg->memtable_flush_writers = app.configuration()["memtable-flush-writers"].as<unsigned>();
             return do_test(env, *cfg).finally([cfg] {});
-        });
+        }, db_cfg);
     });
 }
@@ -778,6 +778,83 @@ SEASTAR_TEST_CASE(test_eviction_after_schema_change) {
     });
 }
 
+SEASTAR_TEST_CASE(test_admission_filter_rejects_partitions_colder_than_victim) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        auto hot = make_new_mutation(s);
+        auto cold = make_new_mutation(s);
+        mt->apply(hot);
+        mt->apply(cold);
+
+        cache_tracker tracker;
+        tracker.enable_admission_filter(1024);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            auto rd = cache.make_reader(s, dht::partition_range::make_singular(m.decorated_key()));
+            assert_that(std::move(rd)).produces(m).produces_end_of_stream();
+        };
+
+        // Nothing was evicted yet, so everything is admitted.
+        for (int i = 0; i < 5; ++i) {
+            read(hot);
+        }
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+
+        while (tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) ;
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+
+        // The cold partition would displace a more frequently accessed one.
+        read(cold);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_admission_rejections, 1);
+
+        read(hot);
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 1);
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().partition_admission_rejections, 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_admission_filter_does_not_lock_out_new_partitions) {
+    return seastar::async([] {
+        auto s = make_schema();
+        auto mt = make_lw_shared<memtable>(s);
+
+        auto hot = make_new_mutation(s);
+        mt->apply(hot);
+        std::vector<mutation> fresh;
+        for (unsigned i = 0; i < utils::frequency_sketch::max_frequency + 1; ++i) {
+            fresh.push_back(make_new_mutation(s));
+            mt->apply(fresh.back());
+        }
+
+        cache_tracker tracker;
+        tracker.enable_admission_filter(1024);
+        row_cache cache(s, snapshot_source_from_snapshot(mt->as_data_source()), tracker);
+
+        auto read = [&] (const mutation& m) {
+            auto rd = cache.make_reader(s, dht::partition_range::make_singular(m.decorated_key()));
+            assert_that(std::move(rd)).produces(m).produces_end_of_stream();
+        };
+
+        for (unsigned i = 0; i < utils::frequency_sketch::max_frequency; ++i) {
+            read(hot);
+        }
+        while (tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) ;
+        BOOST_REQUIRE_EQUAL(tracker.partitions(), 0);
+
+        // Without evictions, the evicted hot partition must not keep every
+        // newly read partition out of cache.
+        for (auto&& m : fresh) {
+            read(m);
+        }
+        BOOST_REQUIRE_GE(tracker.partitions(), 1);
+        BOOST_REQUIRE_LE(tracker.get_stats().partition_admission_rejections, utils::frequency_sketch::max_frequency);
+    });
+}
+
 void test_sliced_read_row_presence(flat_mutation_reader reader, schema_ptr s, std::deque<int> expected)
 {
     clustering_key::equality ck_eq(*s);
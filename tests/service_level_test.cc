@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE service_level
+
+#include <boost/test/unit_test.hpp>
+
+#include "service/service_level.hh"
+
+BOOST_AUTO_TEST_CASE(test_parse_service_levels) {
+    BOOST_REQUIRE(service::parse_service_levels("").empty());
+
+    auto levels = service::parse_service_levels(" oltp:1000, analytics : 200 ,");
+    BOOST_REQUIRE_EQUAL(levels.size(), 2);
+    BOOST_REQUIRE_EQUAL(levels[0].name, "oltp");
+    BOOST_REQUIRE_EQUAL(levels[0].shares, 1000u);
+    BOOST_REQUIRE_EQUAL(levels[1].name, "analytics");
+    BOOST_REQUIRE_EQUAL(levels[1].shares, 200u);
+
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp:"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp:many"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp:0"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp:1001"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("oltp:100,oltp:200"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_service_levels("a:1,b:1,c:1,d:1,e:1,f:1,g:1,h:1,i:1"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_role_service_levels) {
+    auto levels = service::parse_service_levels("oltp:1000,analytics:200");
+
+    auto role_levels = service::parse_role_service_levels("alice:oltp, bob:analytics, carol:oltp", levels);
+    BOOST_REQUIRE_EQUAL(role_levels.size(), 3);
+    BOOST_REQUIRE_EQUAL(role_levels.at("alice"), "oltp");
+    BOOST_REQUIRE_EQUAL(role_levels.at("bob"), "analytics");
+    BOOST_REQUIRE_EQUAL(role_levels.at("carol"), "oltp");
+
+    BOOST_REQUIRE_THROW(service::parse_role_service_levels("alice:batch", levels), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_role_service_levels("alice:oltp,alice:analytics", levels), std::invalid_argument);
+    BOOST_REQUIRE_THROW(service::parse_role_service_levels("alice", levels), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_role_service_level_resolution) {
+    auto levels = service::parse_service_levels("oltp:1000,analytics:200");
+    auto role_levels = service::parse_role_service_levels("alice:oltp,bob:analytics,carol:oltp", levels);
+
+    service::role_service_levels resolver(role_levels, {"oltp", "analytics"});
+    BOOST_REQUIRE(!resolver.empty());
+    BOOST_REQUIRE(resolver.find(sstring("alice")) == std::optional<size_t>(0));
+    BOOST_REQUIRE(resolver.find(sstring("bob")) == std::optional<size_t>(1));
+    BOOST_REQUIRE(resolver.find(sstring("carol")) == std::optional<size_t>(0));
+
+    // Other roles and anonymous connections fall back to the default scheduling group
+    BOOST_REQUIRE(!resolver.find(sstring("dave")));
+    BOOST_REQUIRE(!resolver.find(std::nullopt));
+
+    // So do roles attached to a level without a scheduling group
+    service::role_service_levels partial(role_levels, {"analytics"});
+    BOOST_REQUIRE(!partial.find(sstring("alice")));
+    BOOST_REQUIRE(partial.find(sstring("bob")) == std::optional<size_t>(0));
+
+    BOOST_REQUIRE(service::role_service_levels().empty());
+    BOOST_REQUIRE(service::role_service_levels(role_levels, {}).empty());
+}
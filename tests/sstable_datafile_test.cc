@@ -36,6 +36,8 @@
 #include "core/seastar.hh"
 #include "core/do_with.hh"
 #include "sstables/compaction_manager.hh"
+#include "sstables/index_summary_manager.hh"
+#include "sstables/downsampling.hh"
 #include "tmpdir.hh"
 #include "dht/i_partitioner.hh"
 #include "dht/murmur3_partitioner.hh"
@@ -55,6 +57,7 @@
 #include <stdio.h>
 #include <ftw.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
 #include <boost/algorithm/cxx11/is_sorted.hpp>
@@ -2113,6 +2116,56 @@ SEASTAR_TEST_CASE(leveled_07) {
     return make_ready_future<>();
 }
 
+SEASTAR_TEST_CASE(leveled_l0_promotion_test) {
+    auto s = make_lw_shared(schema({}, some_keyspace, some_column_family,
+        {{"p1", utf8_type}}, {}, {}, {}, utf8_type));
+
+    column_family::config cfg;
+    cell_locker_stats cl_stats;
+    compaction_manager cm;
+    auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), cm, cl_stats);
+    cf->mark_ready_for_writes();
+
+    auto keys = token_generation_for_current_shard(24);
+    auto max_sstable_size = 1024*1024;
+    auto make_lcs = [] (std::map<sstring, sstring> options) {
+        options.emplace("sstable_size_in_mb", "1");
+        return sstables::make_compaction_strategy(sstables::compaction_strategy_type::leveled, options);
+    };
+
+    // L0 holding a full sstable's worth of data is promoted to L1, in parallel over sub-ranges.
+    for (auto i = 0; i < 5; i++) {
+        add_sstable_for_leveled_test(cf, i, max_sstable_size, /*level*/0, keys[0].first, keys[23].first);
+    }
+    auto desc = make_lcs({}).get_sstables_for_compaction(*cf, get_candidates_for_leveled_strategy(*cf));
+    BOOST_REQUIRE_EQUAL(desc.level, 1);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 5u);
+    BOOST_REQUIRE_EQUAL(desc.parallelism, 4u);
+
+    desc = make_lcs({{"l0_compaction_parallelism", "2"}}).get_sstables_for_compaction(*cf, get_candidates_for_leveled_strategy(*cf));
+    BOOST_REQUIRE_EQUAL(desc.level, 1);
+    BOOST_REQUIRE_EQUAL(desc.parallelism, 2u);
+
+    // With L1 over its target size, L0 holding more sstables than the threshold is
+    // size-tiered first, unless that is disabled.
+    for (auto i = 0; i < 11; i++) {
+        add_sstable_for_leveled_test(cf, 5 + i, max_sstable_size, /*level*/1, keys[i*2].first, keys[i*2+1].first);
+    }
+    desc = make_lcs({{"stcs_in_l0_threshold", "4"}}).get_sstables_for_compaction(*cf, get_candidates_for_leveled_strategy(*cf));
+    BOOST_REQUIRE_EQUAL(desc.level, 0);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 5u);
+    BOOST_REQUIRE_EQUAL(desc.parallelism, 1u);
+
+    desc = make_lcs({}).get_sstables_for_compaction(*cf, get_candidates_for_leveled_strategy(*cf));
+    BOOST_REQUIRE_EQUAL(desc.level, 2);
+
+    desc = make_lcs({{"stcs_in_l0_threshold", "0"}}).get_sstables_for_compaction(*cf, get_candidates_for_leveled_strategy(*cf));
+    BOOST_REQUIRE_EQUAL(desc.level, 2);
+    BOOST_REQUIRE_EQUAL(desc.parallelism, 1u);
+
+    return make_ready_future<>();
+}
+
 SEASTAR_TEST_CASE(leveled_invariant_fix) {
     auto s = make_lw_shared(schema({}, some_keyspace, some_column_family,
         {{"p1", utf8_type}}, {}, {}, {}, utf8_type));
@@ -4605,6 +4658,650 @@ SEASTAR_TEST_CASE(sstable_partition_estimation_sanity_test) {
     });
 }
 
+SEASTAR_TEST_CASE(sstable_distinct_partitions_estimation_test) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto builder = schema_builder("tests", "test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", utf8_type);
+        auto s = builder.build(schema_builder::compact_storage::no);
+        const column_definition& col = *s->get_column_definition("value");
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return make_sstable(s, tmp->path, (*gen)++, la, big);
+        };
+        auto make_sstable_with_keys = [&] (int first, int last) {
+            std::vector<mutation> mutations;
+            for (auto i = first; i < last; i++) {
+                auto key = partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))});
+                mutation m(s, key);
+                m.set_clustered_cell(clustering_key::make_empty(), col, make_atomic_cell(bytes(100, 'a')));
+                mutations.push_back(std::move(m));
+            }
+            return make_sstable_containing(sst_gen, std::move(mutations));
+        };
+
+        auto sst1 = make_sstable_with_keys(0, 5000);
+        auto sst2 = make_sstable_with_keys(2500, 7500);
+        auto sst3 = make_sstable_with_keys(0, 5000);
+        auto sst4 = make_sstable_with_keys(10000, 15000);
+
+        BOOST_REQUIRE(sst1->get_cardinality_estimator());
+
+        auto require_close_to = [] (uint64_t estimate, uint64_t expected) {
+            BOOST_TEST_MESSAGE(sprint("estimate: %d, expected: %d", estimate, expected));
+            BOOST_REQUIRE(std::abs(int64_t(estimate) - int64_t(expected)) <= int64_t(expected / 20));
+        };
+        require_close_to(estimate_distinct_partitions({sst1}), 5000);
+        require_close_to(estimate_distinct_partitions({sst1, sst3}), 5000);
+        require_close_to(estimate_distinct_partitions({sst1, sst2, sst3}), 7500);
+        require_close_to(estimate_distinct_partitions({sst1, sst4}), 10000);
+
+        BOOST_REQUIRE(estimate_partition_overlap({sst1, sst4}) < 0.05);
+        BOOST_REQUIRE(estimate_partition_overlap({sst1, sst3}) > 0.45);
+        BOOST_REQUIRE(estimate_partition_overlap({sst1, sst3}) > estimate_partition_overlap({sst1, sst2}));
+    });
+}
+
+SEASTAR_TEST_CASE(incremental_compaction_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "incremental_compaction")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return make_sstable(s, tmp->path, (*gen)++, la, big);
+        };
+
+        auto keys = boost::copy_range<std::vector<dht::decorated_key>>(boost::irange(0, 100) | boost::adaptors::transformed([&] (int i) {
+            return dht::global_partitioner().decorate_key(*s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+        }));
+        boost::sort(keys, dht::decorated_key::less_comparator(s));
+
+        api::timestamp_type next_timestamp = 1;
+        auto make_insert = [&] (const dht::decorated_key& key) {
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), next_timestamp++);
+            return m;
+        };
+        auto make_delete = [&] (const dht::decorated_key& key) {
+            mutation m(s, key);
+            m.partition().apply(tombstone(next_timestamp++, gc_clock::now() - std::chrono::seconds(10)));
+            return m;
+        };
+
+        auto compact = [&] (std::vector<shared_sstable> ssts, std::vector<compaction_completion_desc>& replacements) {
+            auto cm = make_lw_shared<compaction_manager>();
+            auto cf = make_lw_shared<column_family>(s, column_family::config(), column_family::no_commitlog(), *cm, cl_stats);
+            cf->mark_ready_for_writes();
+            for (auto&& sst : ssts) {
+                column_family_test(cf).add_sstable(sst);
+            }
+            auto descriptor = sstables::compaction_descriptor(std::move(ssts));
+            descriptor.fragment_size = 1;
+            descriptor.replacer = [&replacements] (compaction_completion_desc desc) {
+                replacements.push_back(std::move(desc));
+            };
+            return sstables::compact_sstables(std::move(descriptor), *cf, sst_gen).get0().new_sstables;
+        };
+
+        // Inputs holding disjoint ranges are replaced one by one, as the output moves past them.
+        {
+            std::vector<shared_sstable> inputs;
+            for (auto i = 0; i < 4; i++) {
+                auto muts = boost::copy_range<std::vector<mutation>>(boost::irange(i * 25, (i + 1) * 25)
+                        | boost::adaptors::transformed([&] (int k) { return make_insert(keys[k]); }));
+                inputs.push_back(make_sstable_containing(sst_gen, std::move(muts)));
+            }
+
+            std::vector<compaction_completion_desc> replacements;
+            auto outputs = compact(inputs, replacements);
+
+            BOOST_REQUIRE_EQUAL(outputs.size(), 100);
+            BOOST_REQUIRE_EQUAL(replacements.size(), 4);
+            std::vector<shared_sstable> replaced_outputs;
+            for (auto i = 0; i < 4; i++) {
+                BOOST_REQUIRE(replacements[i].input_sstables == std::vector<shared_sstable>({ inputs[i] }));
+                BOOST_REQUIRE_EQUAL(replacements[i].output_sstables.size(), 25);
+                replaced_outputs.insert(replaced_outputs.end(), replacements[i].output_sstables.begin(), replacements[i].output_sstables.end());
+            }
+            BOOST_REQUIRE(replaced_outputs == outputs);
+        }
+
+        // A tombstone isn't purged while it shadows data in an input which outlives its own.
+        {
+            auto spanning = make_sstable_containing(sst_gen, { make_insert(keys[0]), make_insert(keys[99]) });
+            auto deleted = make_sstable_containing(sst_gen, { make_insert(keys[0]) });
+            auto tomb = make_sstable_containing(sst_gen, { make_delete(keys[0]) });
+            std::vector<compaction_completion_desc> replacements;
+            auto outputs = compact({ deleted, tomb, spanning }, replacements);
+
+            BOOST_REQUIRE_EQUAL(outputs.size(), 2);
+            auto reader = sstable_reader(outputs[0], s);
+            auto m = read_mutation_from_flat_mutation_reader(reader).get0();
+            BOOST_REQUIRE(m);
+            BOOST_REQUIRE(m->decorated_key().equal(*s, keys[0]));
+            BOOST_REQUIRE(m->partition().partition_tombstone());
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(compaction_links_disjoint_sstables_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto s = schema_builder("tests", "compaction_links_disjoint_sstables")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = make_sstable(s, tmp->path, (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto keys = boost::copy_range<std::vector<dht::decorated_key>>(boost::irange(0, 41) | boost::adaptors::transformed([&] (int i) {
+            return dht::global_partitioner().decorate_key(*s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+        }));
+        boost::sort(keys, dht::decorated_key::less_comparator(s));
+
+        auto make_inserts = [&] (int first, int last) {
+            return boost::copy_range<std::vector<mutation>>(boost::irange(first, last) | boost::adaptors::transformed([&] (int k) {
+                mutation m(s, keys[k]);
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(k)), 1);
+                return m;
+            }));
+        };
+
+        auto disjoint_muts = make_inserts(0, 20);
+        auto disjoint = make_sstable_containing(sst_gen, disjoint_muts);
+        auto overlapping1 = make_sstable_containing(sst_gen, make_inserts(20, 30));
+        auto overlapping2 = make_sstable_containing(sst_gen, make_inserts(25, 35));
+        auto deleted = make_inserts(35, 40);
+        deleted[0].partition().apply(tombstone(2, gc_clock::now()));
+        auto with_tombstone = make_sstable_containing(sst_gen, deleted);
+        // Too small to be worth keeping apart from the rest.
+        auto tiny = make_sstable_containing(sst_gen, make_inserts(40, 41));
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto cf = make_lw_shared<column_family>(s, column_family::config(), column_family::no_commitlog(), *cm, cl_stats);
+        cf->mark_ready_for_writes();
+        column_family_test::update_sstables_known_generation(*cf, 100);
+
+        auto inputs = std::vector<shared_sstable>({ with_tombstone, tiny, overlapping2, disjoint, overlapping1 });
+        // Output which isn't split is only linked into if the strategy allows for it.
+        auto unsplit_outputs = sstables::compact_sstables(sstables::compaction_descriptor(inputs, 1), *cf, sst_gen).get0().new_sstables;
+        BOOST_REQUIRE_EQUAL(unsplit_outputs.size(), 1);
+
+        // Output split into sstables about the size of the disjoint one, and output which isn't split.
+        for (auto max_sstable_bytes : { 2 * disjoint->data_size(), std::numeric_limits<uint64_t>::max() }) {
+            auto descriptor = sstables::compaction_descriptor(inputs, 1, max_sstable_bytes);
+            descriptor.link_into_unsplit_output = true;
+            auto info = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen).get0();
+            auto& outputs = info.new_sstables;
+
+            // Only the sstable sharing no partitions and holding no tombstones is linked,
+            // the rest is merged into a separate sstable.
+            BOOST_REQUIRE_EQUAL(outputs.size(), 2);
+            auto linked = outputs[0];
+            BOOST_REQUIRE_NE(linked->generation(), disjoint->generation());
+            BOOST_REQUIRE_EQUAL(linked->get_sstable_level(), 1);
+            BOOST_REQUIRE(linked->ancestors() == std::unordered_set<uint64_t>({ uint64_t(disjoint->generation()), uint64_t(overlapping1->generation()),
+                    uint64_t(overlapping2->generation()), uint64_t(with_tombstone->generation()), uint64_t(tiny->generation()) }));
+            BOOST_REQUIRE_EQUAL(disjoint->get_sstable_level(), 0);
+
+            struct stat linked_stat, disjoint_stat;
+            BOOST_REQUIRE_EQUAL(::stat(linked->filename(sstable::component_type::Data).c_str(), &linked_stat), 0);
+            BOOST_REQUIRE_EQUAL(::stat(disjoint->filename(sstable::component_type::Data).c_str(), &disjoint_stat), 0);
+            BOOST_REQUIRE_EQUAL(linked_stat.st_ino, disjoint_stat.st_ino);
+
+            auto assertions = assert_that(sstable_reader(linked, s));
+            for (auto& m : disjoint_muts) {
+                assertions.produces(m);
+            }
+            assertions.produces_end_of_stream();
+
+            auto merged = outputs[1];
+            BOOST_REQUIRE(merged->get_first_decorated_key().equal(*s, keys[20]));
+            BOOST_REQUIRE(merged->get_last_decorated_key().equal(*s, keys[40]));
+
+            // Partitions of the linked sstable count as written, though they're not read.
+            BOOST_REQUIRE_EQUAL(info.total_keys_read, 21);
+            BOOST_REQUIRE_EQUAL(info.total_keys_written, linked->get_estimated_key_count() + 21);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(parallel_compaction_of_subranges_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto s = schema_builder("tests", "parallel_compaction_of_subranges")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = make_sstable(s, tmp->path, (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        // Values are large enough for the summaries to sample several keys of each sstable.
+        auto make_mutations = [&] (api::timestamp_type ts) {
+            auto muts = boost::copy_range<std::vector<mutation>>(boost::irange(0, 100) | boost::adaptors::transformed([&] (int i) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(2048, int8_t(ts))), ts);
+                return m;
+            }));
+            boost::sort(muts, mutation_decorated_key_less_comparator());
+            return muts;
+        };
+        auto old_muts = make_mutations(1);
+        auto new_muts = make_mutations(2);
+        auto sstables = std::vector<shared_sstable>{ make_sstable_containing(sst_gen, old_muts), make_sstable_containing(sst_gen, new_muts) };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto cf = make_lw_shared<column_family>(s, column_family::config(), column_family::no_commitlog(), *cm, cl_stats);
+        cf->mark_ready_for_writes();
+        auto descriptor = sstables::compaction_descriptor(sstables);
+        descriptor.parallelism = 4;
+        auto outputs = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen).get0().new_sstables;
+
+        // Every sub-range is compacted into its own sstable, and together they hold the merged input.
+        BOOST_REQUIRE_EQUAL(outputs.size(), 4);
+        boost::sort(outputs, [] (const shared_sstable& a, const shared_sstable& b) {
+            return a->compare_by_first_key(*b) < 0;
+        });
+        auto expected = new_muts.begin();
+        for (auto& sst : outputs) {
+            BOOST_REQUIRE(sst->ancestors() == std::unordered_set<uint64_t>({ uint64_t(sstables[0]->generation()), uint64_t(sstables[1]->generation()) }));
+            auto assertions = assert_that(sstable_reader(sst, s));
+            while (expected != new_muts.end() && !sst->get_last_decorated_key().less_compare(*s, expected->decorated_key())) {
+                assertions.produces(*expected++);
+            }
+            assertions.produces_end_of_stream();
+        }
+        BOOST_REQUIRE(expected == new_muts.end());
+
+        // Incremental compactions of sub-ranges replace each input once, when all the
+        // sub-ranges it overlaps are done with it, and report all of their output.
+        {
+            std::vector<shared_sstable> inputs;
+            for (auto i = 0; i < 4; i++) {
+                auto muts = std::vector<mutation>(new_muts.begin() + i * 25, new_muts.begin() + (i + 1) * 25);
+                inputs.push_back(make_sstable_containing(sst_gen, std::move(muts)));
+            }
+            std::vector<compaction_completion_desc> replacements;
+            auto descriptor = sstables::compaction_descriptor(inputs);
+            descriptor.parallelism = 2;
+            descriptor.fragment_size = 1;
+            descriptor.replacer = [&replacements] (compaction_completion_desc desc) {
+                replacements.push_back(std::move(desc));
+            };
+            auto outputs = sstables::compact_sstables(std::move(descriptor), *cf, sst_gen).get0().new_sstables;
+
+            std::vector<shared_sstable> replaced_inputs;
+            std::vector<shared_sstable> replaced_outputs;
+            for (auto& desc : replacements) {
+                replaced_inputs.insert(replaced_inputs.end(), desc.input_sstables.begin(), desc.input_sstables.end());
+                replaced_outputs.insert(replaced_outputs.end(), desc.output_sstables.begin(), desc.output_sstables.end());
+            }
+            BOOST_REQUIRE_GT(replacements.size(), 2);
+            BOOST_REQUIRE(boost::copy_range<std::unordered_set<shared_sstable>>(replaced_inputs)
+                    == boost::copy_range<std::unordered_set<shared_sstable>>(inputs));
+            BOOST_REQUIRE_EQUAL(replaced_inputs.size(), inputs.size());
+            BOOST_REQUIRE(boost::copy_range<std::unordered_set<shared_sstable>>(replaced_outputs)
+                    == boost::copy_range<std::unordered_set<shared_sstable>>(outputs));
+            BOOST_REQUIRE_EQUAL(replaced_outputs.size(), outputs.size());
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(deferred_filter_loading_test) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = schema_builder("tests", "deferred_filter_loading")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        mutation m(s, partition_key::from_exploded(*s, {to_bytes("key")}));
+        m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 1);
+        auto written = make_sstable_containing([&] { return make_sstable(s, tmp->path, 1, la, big); }, { m });
+        BOOST_REQUIRE(!written->has_deferred_filter());
+        BOOST_REQUIRE_GT(written->filter_memory_size(), 0);
+
+        // Until it's loaded, the filter reports every key as present.
+        auto sst = make_sstable(s, tmp->path, 1, la, big);
+        sst->load(default_priority_class(), true).get();
+        BOOST_REQUIRE(sst->has_deferred_filter());
+        BOOST_REQUIRE_EQUAL(sst->filter_memory_size(), 0);
+        BOOST_REQUIRE(sst->filter_has_key(*s, partition_key::from_exploded(*s, {to_bytes("absent")})));
+        assert_that(sstable_reader(sst, s)).produces(m).produces_end_of_stream();
+
+        sst->load_deferred_filter(default_priority_class()).get();
+        BOOST_REQUIRE(!sst->has_deferred_filter());
+        BOOST_REQUIRE_EQUAL(sst->filter_memory_size(), written->filter_memory_size());
+        BOOST_REQUIRE(sst->filter_has_key(*s, m.key()));
+    });
+}
+
+SEASTAR_TEST_CASE(offstrategy_compaction_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+        auto s = schema_builder("tests", "offstrategy_compaction")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = make_sstable(s, tmp->path, (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->start();
+
+        column_family::config cfg;
+        cfg.datadir = tmp->path;
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        // Long enough for off-strategy compaction to only run when asked to.
+        cfg.offstrategy_compaction_delay = std::chrono::hours(1);
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, cl_stats);
+        cf->start();
+        cf->mark_ready_for_writes();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::size_tiered);
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 8; i++) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(i)), 1);
+            muts.push_back(m);
+            column_family_test(cf).add_maintenance_sstable(make_sstable_containing(sst_gen, {m}));
+        }
+        column_family_test::update_sstables_known_generation(*cf, muts.size());
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+
+        // Maintenance sstables are read, but aren't candidates for regular compaction.
+        BOOST_REQUIRE_EQUAL(cf->sstables_count(), muts.size());
+        BOOST_REQUIRE_EQUAL(cf->maintenance_sstables().size(), muts.size());
+        BOOST_REQUIRE(cf->candidates_for_compaction().empty());
+        for (auto& m : muts) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(cf->make_reader(s, pr)).produces(m).produces_end_of_stream();
+        }
+
+        // Size-tiered compaction reshapes them into a single sstable, which then joins
+        // the regular ones.
+        cf->run_offstrategy_compaction().get();
+        BOOST_REQUIRE(cf->maintenance_sstables().empty());
+        BOOST_REQUIRE_EQUAL(cf->sstables_count(), 1);
+        BOOST_REQUIRE_EQUAL(cf->candidates_for_compaction().size(), 1);
+        auto assertions = assert_that(sstable_reader(*cf->get_sstables()->begin(), s));
+        for (auto& m : muts) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
+
+SEASTAR_TEST_CASE(leveled_offstrategy_compaction_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+        auto s = schema_builder("tests", "leveled_offstrategy_compaction")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = make_sstable(s, tmp->path, (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->start();
+
+        column_family::config cfg;
+        cfg.datadir = tmp->path;
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        cfg.offstrategy_compaction_delay = std::chrono::hours(1);
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, cl_stats);
+        cf->start();
+        cf->mark_ready_for_writes();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::leveled);
+
+        auto make_insert = [&] (int k, int32_t v) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(k))}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(v), v);
+            return m;
+        };
+        // Every sstable spans the whole ring, as streamed ones do.
+        std::vector<mutation> muts;
+        for (int i = 0; i < 4; i++) {
+            std::vector<mutation> sst_muts;
+            for (int k = 0; k < 8; k++) {
+                sst_muts.push_back(make_insert(k, i));
+            }
+            column_family_test(cf).add_maintenance_sstable(make_sstable_containing(sst_gen, sst_muts));
+            muts = std::move(sst_muts);
+        }
+        column_family_test::update_sstables_known_generation(*cf, 4);
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+
+        // Nothing is in level 1, so the reshaped run goes there rather than to level 0.
+        cf->run_offstrategy_compaction().get();
+        BOOST_REQUIRE(cf->maintenance_sstables().empty());
+        BOOST_REQUIRE_EQUAL(cf->sstables_count(), 1);
+        auto sst = *cf->get_sstables()->begin();
+        BOOST_REQUIRE_EQUAL(sst->get_sstable_level(), 1);
+        auto assertions = assert_that(sstable_reader(sst, s));
+        for (auto& m : muts) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
+
+SEASTAR_TEST_CASE(major_compaction_includes_maintenance_sstables_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+        auto s = schema_builder("tests", "major_compaction_includes_maintenance_sstables")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            auto sst = make_sstable(s, tmp->path, (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->start();
+
+        column_family::config cfg;
+        cfg.datadir = tmp->path;
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        cfg.offstrategy_compaction_delay = std::chrono::hours(1);
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, cl_stats);
+        cf->start();
+        cf->mark_ready_for_writes();
+        cf->set_compaction_strategy(sstables::compaction_strategy_type::size_tiered);
+
+        std::vector<mutation> muts;
+        for (int i = 0; i < 4; i++) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(i)), 1);
+            muts.push_back(m);
+            if (i % 2) {
+                column_family_test(cf).add_maintenance_sstable(make_sstable_containing(sst_gen, {m}));
+            } else {
+                column_family_test(cf).add_sstable(make_sstable_containing(sst_gen, {m}));
+            }
+        }
+        column_family_test::update_sstables_known_generation(*cf, muts.size());
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+        BOOST_REQUIRE_EQUAL(cf->maintenance_sstables().size(), 2);
+
+        cf->compact_all_sstables().get();
+        BOOST_REQUIRE(cf->maintenance_sstables().empty());
+        BOOST_REQUIRE_EQUAL(cf->sstables_count(), 1);
+        auto assertions = assert_that(sstable_reader(*cf->get_sstables()->begin(), s));
+        for (auto& m : muts) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
+
+SEASTAR_TEST_CASE(summary_resampling_test) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        const int base_level = downsampling::BASE_SAMPLING_LEVEL;
+        auto s = schema_builder("tests", "summary_resampling")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", bytes_type).build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto muts = boost::copy_range<std::vector<mutation>>(boost::irange(0, 1000) | boost::adaptors::transformed([&] (int i) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(bytes(1024, int8_t(i))), 1);
+            return m;
+        }));
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+        auto sst = make_sstable_containing([&] {
+            auto sst = make_sstable(s, tmp->path, 1, la, big);
+            sst->set_unshared();
+            return sst;
+        }, muts);
+        auto full_entries = sst->get_summary().entries.size();
+        BOOST_REQUIRE_GT(full_entries, 16u);
+        BOOST_REQUIRE_EQUAL(sst->summary_sampling_level(), base_level);
+
+        auto verify_reads = [&] {
+            for (auto& m : muts) {
+                auto pr = dht::partition_range::make_singular(m.decorated_key());
+                assert_that(sstable_reader(sst, s, pr)).produces(m).produces_end_of_stream();
+            }
+            auto assertions = assert_that(sstable_reader(sst, s));
+            for (auto& m : muts) {
+                assertions.produces(m);
+            }
+            assertions.produces_end_of_stream();
+        };
+
+        BOOST_REQUIRE(sst->can_resample_summary());
+        sst->downsample_summary(base_level / 4);
+        BOOST_REQUIRE_EQUAL(sst->summary_sampling_level(), base_level / 4);
+        BOOST_REQUIRE_LT(sst->get_summary().entries.size(), full_entries);
+        BOOST_REQUIRE_EQUAL(sst->get_summary().entries.front().position, 0);
+        verify_reads();
+
+        BOOST_REQUIRE(sst->restore_summary(default_priority_class()).get0());
+        BOOST_REQUIRE_EQUAL(sst->summary_sampling_level(), base_level);
+        BOOST_REQUIRE_EQUAL(sst->get_summary().entries.size(), full_entries);
+        verify_reads();
+
+        // A budget which can't fit any summary leaves it at the minimum sampling level
+        // allowed by the schema, and one which fits it restores full sampling.
+        auto min_sampling_level = base_level * s->min_index_interval() / s->max_index_interval();
+        sstables::index_summary_manager small(1, std::chrono::seconds(0), [sst] { return std::vector<shared_sstable>{sst}; });
+        small.redistribute().get();
+        BOOST_REQUIRE_EQUAL(sst->summary_sampling_level(), min_sampling_level);
+        verify_reads();
+        small.stop().get();
+
+        sstables::index_summary_manager large(1 << 30, std::chrono::seconds(0), [sst] { return std::vector<shared_sstable>{sst}; });
+        large.redistribute().get();
+        BOOST_REQUIRE_EQUAL(sst->summary_sampling_level(), base_level);
+        large.stop().get();
+    });
+}
+
+SEASTAR_TEST_CASE(compaction_statistics_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto builder = schema_builder("tests", "compaction_statistics")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+
+        auto tmp = make_lw_shared<tmpdir>();
+        auto sst_gen = [s, tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return make_sstable(s, tmp->path, (*gen)++, la, big);
+        };
+
+        auto make_insert = [&] (sstring key, api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), ts);
+            return m;
+        };
+        auto make_delete = [&] (sstring key, api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.partition().apply(tombstone(ts, gc_clock::now()));
+            return m;
+        };
+
+        // alpha is merged from both sstables, and purged along with its tombstone.
+        auto sst1 = make_sstable_containing(sst_gen, {make_insert("alpha", 1), make_insert("beta", 1)});
+        auto sst2 = make_sstable_containing(sst_gen, {make_delete("alpha", 2), make_insert("gamma", 1)});
+        forward_jump_clocks(std::chrono::seconds(1));
+
+        auto cm = make_lw_shared<compaction_manager>();
+        auto cf = make_lw_shared<column_family>(s, column_family::config(), column_family::no_commitlog(), *cm, cl_stats);
+        cf->mark_ready_for_writes();
+        column_family_test(cf).add_sstable(sst1);
+        column_family_test(cf).add_sstable(sst2);
+
+        auto info = sstables::compact_sstables(sstables::compaction_descriptor({ sst1, sst2 }), *cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(info.total_keys_read, 3u);
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, 2u);
+        BOOST_REQUIRE_EQUAL(info.purged_tombstones, 1u);
+        BOOST_REQUIRE_EQUAL(info.merged_partitions.size(), 2u);
+        BOOST_REQUIRE_EQUAL(info.merged_partitions[1], 2);
+        BOOST_REQUIRE_EQUAL(info.merged_partitions[2], 1);
+        BOOST_REQUIRE_LE(info.started_at, info.ended_at);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_timestamp_metadata_correcness_with_negative) {
     BOOST_REQUIRE(smp::count == 1);
     return seastar::async([] {
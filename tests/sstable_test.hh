@@ -44,6 +44,10 @@ class column_family_test {
         _cf->_sstables->insert(std::move(sstable));
     }
 
+    void add_maintenance_sstable(sstables::shared_sstable sstable) {
+        _cf->add_maintenance_sstable(std::move(sstable), {engine().cpu_id()});
+    }
+
     static void update_sstables_known_generation(column_family& cf, unsigned generation) {
         cf.update_sstables_known_generation(generation);
     }
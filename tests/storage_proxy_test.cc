@@ -30,6 +30,8 @@
 #include "service/storage_proxy.hh"
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
+#include "frozen_mutation.hh"
+#include "exceptions/exceptions.hh"
 
 // Returns random keys sorted in ring order.
 // The schema must have a single bytes_type partition key column.
@@ -111,3 +113,101 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+namespace service {
+
+class storage_proxy_test {
+public:
+    using response_id_type = storage_proxy::response_id_type;
+    using mutation_groups = storage_proxy::mutation_groups;
+
+    // Creates the response handler of a write of m to dest, waiting for its acknowledgement.
+    static std::pair<storage_proxy::grouped_mutation, future<>> make_grouped_mutation(storage_proxy& p, const mutation& m, gms::inet_address dest) {
+        auto targets = std::unordered_map<gms::inet_address, std::experimental::optional<mutation>>({{dest, m}});
+        auto id = p.create_write_response_handler(targets, db::consistency_level::ONE, db::write_type::BATCH, nullptr);
+        auto f = p.response_wait(id, storage_proxy::clock_type::now() + std::chrono::hours(1));
+        auto fm = make_lw_shared<const frozen_mutation>(freeze(m));
+        return { storage_proxy::grouped_mutation{id, p.get_write_response_handler(id), std::move(fm)}, std::move(f) };
+    }
+
+    static void send_mutation_groups(storage_proxy& p, storage_proxy::mutation_groups groups, storage_proxy::mutation_group_sender send) {
+        p.send_mutation_groups(std::move(groups), std::move(send));
+    }
+
+    static void got_response(storage_proxy& p, response_id_type id, gms::inet_address from) {
+        p.got_response(id, from);
+    }
+};
+
+}
+
+SEASTAR_TEST_CASE(test_send_mutation_groups) {
+    return do_with_cql_env([] (cql_test_env& e) {
+        return seastar::async([&e] {
+            e.execute_cql("create table ks.cf (k int, v int, primary key (k));").get();
+            auto s = e.local_db().find_schema("ks", "cf");
+            auto& p = service::get_local_storage_proxy();
+
+            auto make_mutation = [&] (int32_t k) {
+                mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(k)));
+                m.set_clustered_cell(clustering_key_prefix::make_empty(), bytes("v"), data_value(k), 1);
+                return m;
+            };
+
+            auto failing = gms::inet_address("127.0.0.2");
+            auto reachable = gms::inet_address("127.0.0.3");
+            service::storage_proxy_test::mutation_groups groups;
+            std::vector<future<>> failing_writes;
+            std::vector<future<>> reachable_writes;
+            for (int32_t k = 0; k < 4; k++) {
+                auto dest = k % 2 ? reachable : failing;
+                auto gm = service::storage_proxy_test::make_grouped_mutation(p, make_mutation(k), dest);
+                groups[dest].push_back(std::move(gm.first));
+                (k % 2 ? reachable_writes : failing_writes).push_back(std::move(gm.second));
+            }
+            // Doesn't keep the response handlers alive, so that the failed ones can go away.
+            std::unordered_map<gms::inet_address, std::vector<std::pair<service::storage_proxy_test::response_id_type, const frozen_mutation*>>> expected;
+            for (auto&& g : groups) {
+                for (auto&& gm : g.second) {
+                    expected[g.first].emplace_back(gm.id, gm.mutation.get());
+                }
+            }
+
+            std::unordered_map<gms::inet_address, std::pair<std::vector<lw_shared_ptr<const frozen_mutation>>, std::vector<service::storage_proxy_test::response_id_type>>> sent;
+            service::storage_proxy_test::send_mutation_groups(p, std::move(groups), [&] (gms::inet_address dest,
+                    const std::vector<lw_shared_ptr<const frozen_mutation>>& fms, std::vector<service::storage_proxy_test::response_id_type> ids, tracing::trace_state_ptr) {
+                BOOST_REQUIRE(!sent.count(dest));
+                sent.emplace(dest, std::make_pair(fms, std::move(ids)));
+                if (dest == failing) {
+                    return make_exception_future<>(std::runtime_error("unreachable"));
+                }
+                return make_ready_future<>();
+            });
+
+            // Every replica gets a single message with all of its mutations, which aren't copied.
+            BOOST_REQUIRE_EQUAL(sent.size(), 2);
+            for (auto&& g : expected) {
+                auto& msg = sent.at(g.first);
+                BOOST_REQUIRE_EQUAL(msg.first.size(), g.second.size());
+                BOOST_REQUIRE_EQUAL(msg.second.size(), g.second.size());
+                for (size_t i = 0; i < g.second.size(); i++) {
+                    BOOST_REQUIRE_EQUAL(msg.first[i].get(), g.second[i].second);
+                    BOOST_REQUIRE_EQUAL(msg.second[i], g.second[i].first);
+                }
+            }
+
+            // A message which couldn't be sent fails every write in it.
+            for (auto& f : failing_writes) {
+                BOOST_REQUIRE_THROW(f.get(), exceptions::mutation_write_failure_exception);
+            }
+
+            // Writes in a message which was sent are acknowledged one by one.
+            auto& reachable_group = expected.at(reachable);
+            service::storage_proxy_test::got_response(p, reachable_group[0].first, reachable);
+            reachable_writes[0].get();
+            BOOST_REQUIRE(!reachable_writes[1].available());
+            service::storage_proxy_test::got_response(p, reachable_group[1].first, reachable);
+            reachable_writes[1].get();
+        });
+    });
+}
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "cql3/result_set.hh"
+#include "cql3/result_generator.hh"
 #include "cql3/statements/prepared_statement.hh"
 
 #include "transport/messages/result_message_base.hh"
@@ -173,12 +174,18 @@ class result_message::schema_change : public result_message {
 
 class result_message::rows : public result_message {
 private:
-    std::unique_ptr<cql3::result_set> _rs;
+    cql3::result _result;
 public:
-    rows(std::unique_ptr<cql3::result_set> rs) : _rs(std::move(rs)) {}
+    rows(std::unique_ptr<cql3::result_set> rs) : _result(std::move(rs)) {}
+    rows(cql3::result rs) : _result(std::move(rs)) {}
 
+    // Materializes the rows if the result is generated.
     const cql3::result_set& rs() const {
-        return *_rs;
+        return _result.result_set();
+    }
+
+    const cql3::result& result() const {
+        return _result;
     }
 
     virtual void accept(result_message::visitor& v) override {
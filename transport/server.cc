@@ -27,6 +27,8 @@
 #include <boost/assign.hpp>
 #include <boost/locale/encoding_utf.hpp>
 #include <boost/range/adaptor/sliced.hpp>
+#include <boost/range/algorithm/find_if.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 
 #include "cql3/statements/batch_statement.hh"
 #include "service/migration_manager.hh"
@@ -46,6 +48,8 @@
 #include "enum_set.hh"
 #include "service/query_state.hh"
 #include "service/client_state.hh"
+#include "service/service_level.hh"
+#include "utils/latency.hh"
 #include "exceptions/exceptions.hh"
 
 #include "auth/authenticator.hh"
@@ -172,6 +176,92 @@ event::event_type parse_event_type(const sstring& value)
     }
 }
 
+void cql_server::init_service_levels() {
+    namespace sm = seastar::metrics;
+
+    auto& db = _proxy.local().get_db().local();
+    auto& groups = db.get_service_level_scheduling_groups();
+    _service_levels.reserve(groups.size());
+    for (auto&& g : groups) {
+        _service_levels.push_back(service_level{g.first, g.second});
+    }
+    auto& cfg = db.get_config();
+    auto role_levels = service::parse_role_service_levels(cfg.role_service_levels(), service::parse_service_levels(cfg.service_levels()));
+    _role_service_levels = service::role_service_levels(role_levels, boost::copy_range<std::vector<sstring>>(_service_levels
+            | boost::adaptors::transformed([] (const service_level& sl) { return sl.name; })));
+
+    sm::label service_level_label("service_level");
+    for (auto&& sl : _service_levels) {
+        _metrics.add_group("transport", {
+            sm::make_derive("service_level_requests", sl.requests,
+                            sm::description("Counts a number of requests served under the service level."))(service_level_label(sl.name)),
+
+            sm::make_histogram("service_level_latency", sm::description("Latency histogram of requests served under the service level."),
+                            [&sl] { return sl.latency.get_histogram(16, 20); })(service_level_label(sl.name)),
+        });
+    }
+}
+
+cql_server::service_level* cql_server::find_service_level(const service::client_state& client_state) {
+    auto user = client_state.user();
+    if (_role_service_levels.empty() || !user) {
+        return nullptr;
+    }
+    auto level = _role_service_levels.find(user->name);
+    return level ? &_service_levels[*level] : nullptr;
+}
+
+void cql_server::init_load_shedding() {
+    namespace sm = seastar::metrics;
+
+    auto& cfg = _proxy.local().get_db().local().get_config();
+    _load_shedding = cfg.cql_load_shedding();
+    auto ms = [] (uint32_t v) { return std::chrono::duration<double>(std::chrono::milliseconds(v)); };
+    // QUERY and EXECUTE may carry either reads or writes, so assume the longer timeout
+    auto statement_timeout = std::max(ms(cfg.read_request_timeout_in_ms()), ms(cfg.write_request_timeout_in_ms()));
+    _opcode_loads = {
+        opcode_load{uint8_t(cql_binary_opcode::QUERY), "query", statement_timeout},
+        opcode_load{uint8_t(cql_binary_opcode::EXECUTE), "execute", statement_timeout},
+        opcode_load{uint8_t(cql_binary_opcode::BATCH), "batch", ms(cfg.write_request_timeout_in_ms())},
+    };
+
+    sm::label opcode_label("opcode");
+    for (auto&& load : _opcode_loads) {
+        _metrics.add_group("transport", {
+            sm::make_gauge("requests_in_flight", load.in_flight,
+                            sm::description("Holds the number of requests of the opcode admitted and not yet responded to."))(opcode_label(load.name)),
+
+            sm::make_derive("requests_shed", load.shed,
+                            sm::description("Counts requests rejected with an Overloaded error because they were not expected to complete before timing out."))(opcode_label(load.name)),
+        });
+    }
+}
+
+cql_server::opcode_load* cql_server::find_opcode_load(uint8_t op) {
+    auto it = boost::find_if(_opcode_loads, [op] (const opcode_load& load) { return load.opcode == op; });
+    return it != _opcode_loads.end() ? &*it : nullptr;
+}
+
+bool cql_server::should_shed(const opcode_load& load) const {
+    if (!_load_shedding) {
+        return false;
+    }
+    // The throughput estimate reflects the capacity of the shard only once requests
+    // queue up; below that it is just the arrival rate, and would make us shed
+    // bursts which the shard can absorb.
+    if (load.latency * 2 < load.timeout || load.concurrency < 1) {
+        return false;
+    }
+    auto projected_latency = load.latency * ((load.in_flight + 1) / load.concurrency);
+    return projected_latency > load.timeout;
+}
+
+void cql_server::request_completed(opcode_load& load, std::chrono::steady_clock::duration latency) {
+    static constexpr double alpha = 0.01;
+    load.latency += alpha * (std::chrono::duration<double>(latency) - load.latency);
+    load.concurrency += alpha * (load.in_flight - load.concurrency);
+}
+
 cql_load_balance parse_load_balance(sstring value)
 {
     if (value == "none") {
@@ -222,6 +312,7 @@ class cql_server::response {
     void write_string_map(std::map<sstring, sstring> string_map);
     void write_string_multimap(std::multimap<sstring, sstring> string_map);
     void write_value(bytes_opt value);
+    void write_value(bytes_view_opt value);
     void write(const cql3::metadata& m, bool skip = false);
     void write(const cql3::prepared_metadata& m, uint8_t version);
     future<> output(output_stream<char>& out, uint8_t version, cql_compression compression);
@@ -297,6 +388,9 @@ cql_server::cql_server(distributed<service::storage_proxy>& proxy, distributed<c
                                             "The first derivative of this value shows how often we block due to memory exhaustion in the \"CQL transport\" component.", _max_request_size))),
 
     });
+
+    init_service_levels();
+    init_load_shedding();
 }
 
 future<> cql_server::stop() {
@@ -654,6 +748,7 @@ void cql_server::connection::update_client_state(processing_result& response) {
             // If we are on the same shard there is no need to copy unless _client_state._user == nullptr
             _client_state.set_login(response.user.release());
         }
+        _service_level = _server.find_service_level(_client_state);
     }
 
     if (_client_state.get_auth_state() != response.auth_state) {
@@ -689,33 +784,72 @@ future<> cql_server::connection::process_request() {
                     f.length, mem_estimate, _server._max_request_size));
         }
 
+        // Latency used for load shedding includes waiting for memory
+        auto start = std::chrono::steady_clock::now();
         auto fut = get_units(_server._memory_available, mem_estimate);
         if (_server._memory_available.waiters()) {
             ++_server._requests_blocked_memory;
         }
 
-        return fut.then([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (semaphore_units<> mem_permit) {
-          return this->read_and_decompress_frame(length, flags).then([this, flags, op, stream, tracing_requested, mem_permit = std::move(mem_permit)] (temporary_buffer<char> buf) mutable {
+        return fut.then([this, length = f.length, flags = f.flags, op, stream, tracing_requested, start] (semaphore_units<> mem_permit) {
+          return this->read_and_decompress_frame(length, flags).then([this, flags, op, stream, tracing_requested, start, mem_permit = std::move(mem_permit)] (temporary_buffer<char> buf) mutable {
+
+            auto load = _server.find_opcode_load(op);
+            if (load && _server.should_shed(*load)) {
+                ++load->shed;
+                return this->write_response(make_foreign(make_error(stream, exceptions::exception_code::OVERLOADED,
+                        "Request rejected, the server is overloaded", tracing::trace_state_ptr())), _compression);
+            }
+            if (load) {
+                ++load->in_flight;
+            }
 
             ++_server._requests_served;
             ++_server._requests_serving;
 
-            with_gate(_pending_requests_gate, [this, flags, op, stream, buf = std::move(buf), tracing_requested, mem_permit = std::move(mem_permit)] () mutable {
+            with_gate(_pending_requests_gate, [this, flags, op, stream, buf = std::move(buf), tracing_requested, load, start, mem_permit = std::move(mem_permit)] () mutable {
                 auto bv = bytes_view{reinterpret_cast<const int8_t*>(buf.begin()), buf.size()};
                 auto cpu = pick_request_cpu();
+                auto sl = _service_level;
+                utils::latency_counter lc;
+                if (sl) {
+                    lc.start();
+                }
+                // Requests under a service level skip the execution stage, which would run them
+                // in the default scheduling group instead of the one of their level. Only the
+                // coordinator side of the request runs in it, replicas don't know about levels.
+                auto process = [this, sg = sl ? std::experimental::make_optional(sl->sg) : std::experimental::nullopt]
+                        (bytes_view bv, uint8_t op, uint16_t stream, service::client_state client_state, tracing_request_type tracing_requested) {
+                    if (sg) {
+                        return with_scheduling_group(*sg, [this, bv, op, stream, client_state = std::move(client_state), tracing_requested] () mutable {
+                            return process_request_one(bv, op, stream, std::move(client_state), tracing_requested);
+                        });
+                    }
+                    return process_request_stage(this, bv, op, stream, std::move(client_state), tracing_requested);
+                };
                 return [&] {
                     if (cpu == engine().cpu_id()) {
-                        return process_request_stage(this, bv, op, stream, service::client_state(service::client_state::request_copy_tag{}, _client_state, _client_state.get_timestamp()), tracing_requested);
+                        return process(bv, op, stream, service::client_state(service::client_state::request_copy_tag{}, _client_state, _client_state.get_timestamp()), tracing_requested);
                     } else {
-                        return smp::submit_to(cpu, [this, bv = std::move(bv), op, stream, client_state = _client_state, tracing_requested, ts = _client_state.get_timestamp()] () mutable {
-                            return process_request_stage(this, bv, op, stream, service::client_state(service::client_state::request_copy_tag{}, client_state, ts), tracing_requested);
+                        return smp::submit_to(cpu, [process, bv = std::move(bv), op, stream, client_state = _client_state, tracing_requested, ts = _client_state.get_timestamp()] () mutable {
+                            return process(bv, op, stream, service::client_state(service::client_state::request_copy_tag{}, client_state, ts), tracing_requested);
                         });
                     }
-                }().then([this, flags] (auto&& response) {
+                }().then([this, flags, sl, lc, load, start] (auto&& response) mutable {
+                    if (sl) {
+                        sl->latency.add(lc.stop().latency(), ++sl->requests);
+                    }
+                    if (load) {
+                        _server.request_completed(*load, std::chrono::steady_clock::now() - start);
+                    }
                     update_client_state(response);
                     return this->write_response(std::move(response.cql_response), _compression);
                 }).then([buf = std::move(buf), mem_permit = std::move(mem_permit)] {
                     // Keep buf alive.
+                }).finally([load] {
+                    if (load) {
+                        --load->in_flight;
+                    }
                 });
             }).handle_exception([] (std::exception_ptr ex) {
                 clogger.error("request processing failed: {}", ex);
@@ -1223,14 +1357,20 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 
     virtual void visit(const messages::result_message::rows& m) override {
         _response->write_int(0x0002);
-        auto& rs = m.rs();
-        _response->write(rs.get_metadata(), _skip_metadata);
-        _response->write_int(rs.size());
-        for (auto&& row : rs.rows()) {
-            for (auto&& cell : row | boost::adaptors::sliced(0, rs.get_metadata().column_count())) {
-                _response->write_value(cell);
+        auto& r = m.result();
+        _response->write(r.get_metadata(), _skip_metadata);
+        _response->write_int(r.size());
+
+        struct visitor {
+            cql_server::response& _response;
+
+            void start_row() { }
+            void accept_value(bytes_view_opt value) {
+                _response.write_value(value);
             }
-        }
+            void end_row() { }
+        };
+        r.visit(visitor{*_response});
     }
 };
 
@@ -1804,6 +1944,17 @@ void cql_server::response::write_value(bytes_opt value)
     _body.insert(_body.end(), value->begin(), value->end());
 }
 
+void cql_server::response::write_value(bytes_view_opt value)
+{
+    if (!value) {
+        write_int(-1);
+        return;
+    }
+
+    write_int(value->size());
+    _body.insert(_body.end(), value->begin(), value->end());
+}
+
 class type_codec {
 private:
     enum class type_id : int16_t {
@@ -1945,6 +2096,15 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
         return;
     }
 
+    // The column specifications don't depend on the protocol version or on the
+    // paging state, so they are encoded once and then copied.
+    auto& serialized_names = m.serialized_names();
+    if (!serialized_names.empty()) {
+        _body.insert(_body.end(), serialized_names.begin(), serialized_names.end());
+        return;
+    }
+    auto start = _body.size();
+
     auto names_i = m.get_names().begin();
 
     if (global_tables_spec) {
@@ -1962,6 +2122,8 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
         write_string(name->name->text());
         type_codec::encode(*this, name->type);
     };
+
+    serialized_names = sstring(_body.data() + start, _body.size() - start);
 }
 
 void cql_server::response::write(const cql3::prepared_metadata& m, uint8_t version)
@@ -26,6 +26,7 @@
 #include "service/endpoint_lifecycle_subscriber.hh"
 #include "service/migration_listener.hh"
 #include "service/storage_proxy.hh"
+#include "service/service_level.hh"
 #include "cql3/query_processor.hh"
 #include "cql3/values.hh"
 #include "auth/authenticator.hh"
@@ -35,6 +36,7 @@
 #include <boost/intrusive/list.hpp>
 #include <seastar/net/tls.hh>
 #include <seastar/core/metrics_registration.hh>
+#include "utils/estimated_histogram.hh"
 
 namespace scollectd {
 
@@ -121,6 +123,39 @@ class cql_server {
     uint64_t _requests_blocked_memory = 0;
     cql_load_balance _lb;
     auth::service& _auth_service;
+
+    struct service_level {
+        sstring name;
+        seastar::scheduling_group sg;
+        uint64_t requests = 0;
+        utils::estimated_histogram latency;
+    };
+    std::vector<service_level> _service_levels;
+    service::role_service_levels _role_service_levels;
+
+    // Load of requests of one opcode on this shard, used for shedding requests
+    // which are not expected to complete before they time out.
+    struct opcode_load {
+        uint8_t opcode;
+        sstring name;
+        std::chrono::duration<double> timeout;
+        uint64_t in_flight = 0;
+        uint64_t shed = 0;
+        // Moving averages of the latency of completed requests and of the number
+        // of requests in flight at their completion. By Little's law, their
+        // ratio estimates the throughput of the shard for this opcode.
+        std::chrono::duration<double> latency{0};
+        double concurrency = 0;
+    };
+    bool _load_shedding;
+    std::vector<opcode_load> _opcode_loads;
+private:
+    void init_service_levels();
+    service_level* find_service_level(const service::client_state& client_state);
+    void init_load_shedding();
+    opcode_load* find_opcode_load(uint8_t op);
+    bool should_shed(const opcode_load& load) const;
+    void request_completed(opcode_load& load, std::chrono::steady_clock::duration latency);
 public:
     cql_server(distributed<service::storage_proxy>& proxy, distributed<cql3::query_processor>& qp, cql_load_balance lb, auth::service&);
     future<> listen(ipv4_addr addr, std::shared_ptr<seastar::tls::credentials_builder> = {}, bool keepalive = false);
@@ -161,6 +196,8 @@ class cql_server {
         service::client_state _client_state;
         std::unordered_map<uint16_t, cql_query_state> _query_states;
         unsigned _request_cpu = 0;
+        // Service level of the logged in role, if any.
+        service_level* _service_level = nullptr;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2018 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace utils {
+
+// Approximates access frequencies of a large set of keys in a fixed amount of memory.
+//
+// This is the frequency sketch of TinyLFU: a count-min sketch of 4-bit saturating
+// counters, fronted by a "doorkeeper" bit set which absorbs keys seen only once,
+// so that one-hit wonders don't pollute the counters.
+//
+// After sample_size() recorded accesses the sketch ages: all counters are halved
+// and the doorkeeper is cleared, so that estimates follow changes in the workload.
+//
+// Keys are identified by a 64-bit hash, which should be well distributed.
+class frequency_sketch {
+    static constexpr unsigned depth = 4;
+    static constexpr unsigned counter_bits = 4;
+    static constexpr unsigned counters_per_word = 64 / counter_bits;
+    static constexpr uint64_t counter_mask = (uint64_t(1) << counter_bits) - 1;
+    static constexpr uint64_t halving_mask = 0x7777777777777777ull;
+public:
+    enum : unsigned {
+        max_frequency = counter_mask + 1
+    };
+private:
+    std::vector<uint64_t> _table;
+    std::vector<uint64_t> _doorkeeper;
+    uint64_t _counter_index_mask;
+    uint64_t _doorkeeper_index_mask;
+    uint64_t _sample_size;
+    uint64_t _additions = 0;
+    uint64_t _resets = 0;
+private:
+    static uint64_t round_up_to_power_of_two(uint64_t n) {
+        uint64_t r = 1;
+        while (r < n) {
+            r <<= 1;
+        }
+        return r;
+    }
+    static uint64_t seed(unsigned i) {
+        static constexpr uint64_t seeds[depth] = {
+            0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull
+        };
+        return seeds[i];
+    }
+    static uint64_t mix(uint64_t hash, uint64_t seed) {
+        uint64_t h = (hash + seed) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 32;
+        h *= 0x94d049bb133111ebull;
+        return h ^ (h >> 29);
+    }
+    uint64_t counter_index(uint64_t hash, unsigned i) const {
+        return mix(hash, seed(i)) & _counter_index_mask;
+    }
+    unsigned counter(uint64_t idx) const {
+        return (_table[idx / counters_per_word] >> ((idx % counters_per_word) * counter_bits)) & counter_mask;
+    }
+    void increment_counter(uint64_t idx) {
+        _table[idx / counters_per_word] += uint64_t(1) << ((idx % counters_per_word) * counter_bits);
+    }
+    uint64_t doorkeeper_index(uint64_t hash) const {
+        return hash & _doorkeeper_index_mask;
+    }
+    bool in_doorkeeper(uint64_t hash) const {
+        auto idx = doorkeeper_index(hash);
+        return _doorkeeper[idx / 64] & (uint64_t(1) << (idx % 64));
+    }
+    void add_to_doorkeeper(uint64_t hash) {
+        auto idx = doorkeeper_index(hash);
+        _doorkeeper[idx / 64] |= uint64_t(1) << (idx % 64);
+    }
+    unsigned min_count(uint64_t hash) const {
+        unsigned m = counter_mask;
+        for (unsigned i = 0; i < depth; ++i) {
+            m = std::min(m, counter(counter_index(hash, i)));
+        }
+        return m;
+    }
+    void reset() {
+        for (auto& w : _table) {
+            w = (w >> 1) & halving_mask;
+        }
+        std::fill(_doorkeeper.begin(), _doorkeeper.end(), 0);
+        _additions /= 2;
+        ++_resets;
+    }
+public:
+    // Sizes the sketch for tracking expected_keys distinct keys with reasonable accuracy.
+    // Uses about 2.125 bytes per expected key.
+    explicit frequency_sketch(size_t expected_keys) {
+        auto keys = round_up_to_power_of_two(std::max<uint64_t>(expected_keys, counters_per_word));
+        _table.resize(keys * depth / counters_per_word);
+        _counter_index_mask = keys * depth - 1;
+        _doorkeeper.resize(std::max<uint64_t>(keys / 64, 1));
+        _doorkeeper_index_mask = _doorkeeper.size() * 64 - 1;
+        _sample_size = keys * 10;
+    }
+
+    // Records a single access to the key.
+    void record(uint64_t hash) {
+        if (!in_doorkeeper(hash)) {
+            add_to_doorkeeper(hash);
+        } else {
+            // Conservative update: only the counters which hold the minimum are incremented,
+            // which reduces the overestimation caused by collisions.
+            auto m = min_count(hash);
+            if (m < counter_mask) {
+                for (unsigned i = 0; i < depth; ++i) {
+                    auto idx = counter_index(hash, i);
+                    if (counter(idx) == m) {
+                        increment_counter(idx);
+                    }
+                }
+            }
+        }
+        if (++_additions >= _sample_size) {
+            reset();
+        }
+    }
+
+    // Returns the estimated number of accesses to the key since it was last aged out,
+    // saturated at max_frequency. Never underestimates between resets.
+    unsigned estimate(uint64_t hash) const {
+        return min_count(hash) + unsigned(in_doorkeeper(hash));
+    }
+
+    uint64_t sample_size() const { return _sample_size; }
+
+    // Number of times the sketch has aged so far.
+    uint64_t resets() const { return _resets; }
+
+    size_t memory_usage() const {
+        return (_table.size() + _doorkeeper.size()) * sizeof(uint64_t);
+    }
+};
+
+}
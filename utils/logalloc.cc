@@ -2195,6 +2195,27 @@ region* region_group::get_largest_region() {
     return _maximal_rg->_regions.top()->_region;
 }
 
+region* region_group::get_largest_region(const std::function<bool(region&)>& pred) {
+    region* largest = nullptr;
+    uint64_t largest_space = 0;
+    std::vector<region_group*> groups{this};
+    while (!groups.empty()) {
+        auto rg = groups.back();
+        groups.pop_back();
+        for (region_impl* r : rg->_regions) {
+            auto space = r->evictable_occupancy().total_space();
+            if ((!largest || space > largest_space) && pred(*r->_region)) {
+                largest = r->_region;
+                largest_space = space;
+            }
+        }
+        for (region_group* child : rg->_subgroups) {
+            groups.push_back(child);
+        }
+    }
+    return largest;
+}
+
 void
 region_group::add(region_group* child) {
     child->_subgroup_heap_handle = _subgroups.push(child);
@@ -337,6 +337,10 @@ class region_group {
     // children.
     region* get_largest_region();
 
+    // Like get_largest_region(), but only considers the regions for which pred returns true.
+    // Unlike get_largest_region(), visits all the regions below this region group.
+    region* get_largest_region(const std::function<bool(region&)>& pred);
+
     // Shutdown is mandatory for every user who has set a threshold
     // Can be called at most once.
     future<> shutdown() {